@@ -62,6 +62,7 @@ public:
 		PropertyConverter<PropertyType>();  // register corresponding property converter
 		auto getter = [name](type_& self) -> PropertyType& {
 			moveit::task_constructor::PropertyMap& props = self.properties();
+			props.property(name);  // detach from shared copies before handing out a mutable reference
 			return const_cast<PropertyType&>(props.get<PropertyType>(name));
 		};
 		auto setter = [name](type_& self, const PropertyType& value) {
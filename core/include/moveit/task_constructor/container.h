@@ -87,6 +87,9 @@ public:
 
 protected:
 	ContainerBase(ContainerBasePrivate* impl);
+
+	/// add clones of all children to other, for use in cloneStage()
+	void cloneChildrenTo(ContainerBase& other) const;
 };
 std::ostream& operator<<(std::ostream& os, const ContainerBase& stage);
 
@@ -98,6 +101,7 @@ public:
 	PRIVATE_CLASS(SerialContainer)
 	SerialContainer(const std::string& name = "serial container");
 
+	Stage::pointer cloneStage() const override;
 	bool canCompute() const override;
 	void compute() override;
 
@@ -150,6 +154,7 @@ class Alternatives : public ParallelContainerBase
 public:
 	Alternatives(const std::string& name = "alternatives") : ParallelContainerBase(name) {}
 
+	Stage::pointer cloneStage() const override;
 	bool canCompute() const override;
 	void compute() override;
 
@@ -171,6 +176,7 @@ public:
 	PRIVATE_CLASS(Fallbacks);
 	Fallbacks(const std::string& name = "fallbacks");
 
+	Stage::pointer cloneStage() const override;
 	void reset() override;
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
 
@@ -192,6 +198,7 @@ public:
 	PRIVATE_CLASS(Merger)
 	Merger(const std::string& name = "merger");
 
+	Stage::pointer cloneStage() const override;
 	void reset() override;
 	void init(const core::RobotModelConstPtr& robot_model) override;
 	bool canCompute() const override;
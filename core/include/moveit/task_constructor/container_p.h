@@ -55,6 +55,9 @@ MOVEIT_CLASS_FORWARD(JointModelGroup);
 MOVEIT_CLASS_FORWARD(RobotState);
 }  // namespace core
 }  // namespace moveit
+namespace trajectory_processing {
+MOVEIT_CLASS_FORWARD(TimeParameterization);
+}
 
 namespace moveit {
 namespace task_constructor {
@@ -332,7 +335,7 @@ class MergerPrivate : public ParallelContainerBasePrivate
 {
 	friend class Merger;
 
-	moveit::core::JointModelGroupPtr jmg_merged_;
+	moveit::core::JointModelGroupConstPtr jmg_merged_;
 	using ChildSolutionList = std::vector<const SubTrajectory*>;
 	using ChildSolutionMap = std::map<const Stage*, ChildSolutionList>;
 	// map from external source state (iterator) to all corresponding children's solutions
@@ -348,8 +351,9 @@ public:
 	void onNewGeneratorSolution(const SolutionBase& s);
 	void mergeAnyCombination(const ChildSolutionMap& all_solutions, const SolutionBase& current,
 	                         const planning_scene::PlanningSceneConstPtr& start_scene, const Spawner& spawner);
-	void merge(const ChildSolutionList& sub_solutions, const planning_scene::PlanningSceneConstPtr& start_scene,
-	           const Spawner& spawner);
+	// merge a single combination of child solutions (thread-safe once jmg_merged_ is set)
+	SubTrajectory merge(const ChildSolutionList& sub_solutions, const planning_scene::PlanningSceneConstPtr& start_scene,
+	                    const trajectory_processing::TimeParameterization& timing, uint32_t validation_threads) const;
 
 	void sendForward(SubTrajectory&& t, const InterfaceState* from);
 	void sendBackward(SubTrajectory&& t, const InterfaceState* to);
@@ -0,0 +1,148 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Cache of IK solutions, persistent across planning runs
+ */
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <Eigen/Geometry>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace planning_scene {
+MOVEIT_CLASS_FORWARD(PlanningScene);
+}
+namespace moveit {
+namespace core {
+MOVEIT_CLASS_FORWARD(JointModelGroup);
+MOVEIT_CLASS_FORWARD(LinkModel);
+}  // namespace core
+}  // namespace moveit
+
+namespace moveit {
+namespace task_constructor {
+
+MOVEIT_CLASS_FORWARD(IKCache);
+
+/** Cache of IK solutions, shared across planning runs
+ *
+ * Solutions are indexed by the quantized target pose of the IK link, the group, and a fingerprint
+ * of the collision-relevant scene (collision objects, attached bodies, allowed collisions,
+ * and joints outside the group).
+ * Cached solutions only serve as seeds for IK: they are always revalidated for the actual target pose,
+ * collisions, and constraints.
+ *
+ * The cache is not cleared by Task::reset() and can be shared between several stages (and threads).
+ * The least recently used entries are dropped if the cache exceeds its capacity.
+ */
+class IKCache
+{
+public:
+	using Solution = std::vector<double>;
+	using Solutions = std::vector<Solution>;
+
+	struct Key
+	{
+		std::string group;
+		std::string link;
+		std::array<int64_t, 7> pose;  // quantized position + quaternion
+		std::size_t scene;  // scene fingerprint
+
+		bool operator==(const Key& other) const {
+			return pose == other.pose && scene == other.scene && link == other.link && group == other.group;
+		}
+	};
+
+	/** Create a cache
+	 *
+	 * @param position_resolution quantization of the target position (in meters)
+	 * @param orientation_resolution quantization of the target's quaternion components
+	 * @param capacity max number of cached targets
+	 */
+	IKCache(double position_resolution = 0.001, double orientation_resolution = 0.005, std::size_t capacity = 1000);
+
+	/// compute the key of a target pose of link (w.r.t. the planning frame)
+	Key key(const planning_scene::PlanningScene& scene, const moveit::core::JointModelGroup* jmg,
+	        const moveit::core::LinkModel* link, const Eigen::Isometry3d& pose) const {
+		return key(sceneFingerprint(scene, jmg), jmg, link, pose);
+	}
+	/// compute the key of a target pose, reusing the scene's fingerprint computed before (for jmg)
+	Key key(std::size_t scene_fingerprint, const moveit::core::JointModelGroup* jmg,
+	        const moveit::core::LinkModel* link, const Eigen::Isometry3d& pose) const;
+
+	/// retrieve cached solutions (empty if there are none)
+	Solutions lookup(const Key& key);
+	/// store solutions for key, replacing previous ones
+	void insert(const Key& key, Solutions solutions);
+
+	void clear();
+	std::size_t size() const;
+	std::size_t capacity() const { return capacity_; }
+
+	/** hash of the collision-relevant parts of scene, ignoring joints of jmg (if not null)
+	 *
+	 * Covers poses and geometry of objects (including octomap contents), allowed collisions,
+	 * link padding and scaling, as well as the joints outside jmg.
+	 * This is expensive for large scenes: compute it once per scene, not per target.
+	 */
+	static std::size_t sceneFingerprint(const planning_scene::PlanningScene& scene,
+	                                    const moveit::core::JointModelGroup* jmg);
+	/// hash of pose and geometry of the collision object or attached body id, 0 if scene doesn't know id
+	static std::size_t objectFingerprint(const planning_scene::PlanningScene& scene, const std::string& id);
+
+private:
+	struct KeyHash
+	{
+		std::size_t operator()(const Key& key) const;
+	};
+	using Entries = std::list<std::pair<Key, Solutions>>;  // most recently used first
+
+	double position_resolution_;
+	double orientation_resolution_;
+	std::size_t capacity_;
+
+	mutable std::mutex mutex_;
+	Entries entries_;
+	std::unordered_map<Key, Entries::iterator, KeyHash> index_;
+};
+}  // namespace task_constructor
+}  // namespace moveit
@@ -0,0 +1,120 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Nearest-neighbour index for joint configurations of a group
+ */
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace moveit {
+namespace core {
+MOVEIT_CLASS_FORWARD(JointModelGroup);
+}
+}  // namespace moveit
+
+namespace moveit {
+namespace task_constructor {
+
+/** Incremental KD-tree of joint configurations of a JointModelGroup
+ *
+ * Distances are measured with jmg->distance(), i.e. the weighted sum of joint distances.
+ * The tree only splits along variables of bounded revolute and prismatic joints,
+ * whose distance along a single axis provides a lower bound of the group distance.
+ * Continuous and multi-dof joints are only considered when computing exact distances.
+ *
+ * Typical use is the de-duplication of sampled states, e.g. IK solutions.
+ */
+class JointSpaceIndex
+{
+public:
+	explicit JointSpaceIndex(const moveit::core::JointModelGroup* jmg);
+
+	const moveit::core::JointModelGroup* group() const { return jmg_; }
+	std::size_t size() const { return nodes_.size(); }
+	bool empty() const { return nodes_.empty(); }
+	void clear();
+
+	/// add joint positions (jmg->getVariableCount() values), returning their index
+	std::size_t insert(const double* positions);
+	std::size_t insert(const std::vector<double>& positions) { return insert(positions.data()); }
+	/// access positions of i-th inserted configuration
+	const double* operator[](std::size_t i) const { return data_.data() + i * dimension_; }
+
+	/// is there any configuration closer than radius to positions?
+	bool withinDistance(const double* positions, double radius) const;
+	bool withinDistance(const std::vector<double>& positions, double radius) const {
+		return withinDistance(positions.data(), radius);
+	}
+
+	/// index of the configuration nearest to positions (or size() if empty), optionally returning its distance
+	std::size_t nearest(const double* positions, double* distance = nullptr) const;
+	std::size_t nearest(const std::vector<double>& positions, double* distance = nullptr) const {
+		return nearest(positions.data(), distance);
+	}
+
+	/// up to k (distance, index) pairs of the configurations nearest to positions, sorted by distance
+	std::vector<std::pair<double, std::size_t>> nearestK(const double* positions, std::size_t k) const;
+	std::vector<std::pair<double, std::size_t>> nearestK(const std::vector<double>& positions, std::size_t k) const {
+		return nearestK(positions.data(), k);
+	}
+
+private:
+	static constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+	struct Node
+	{
+		std::size_t axis;  // index into axes_
+		std::size_t children[2] = { NONE, NONE };  // below, above
+	};
+	/// variable suitable for splitting, with its distance factor
+	struct Axis
+	{
+		std::size_t variable;
+		double weight;
+	};
+
+	const moveit::core::JointModelGroup* jmg_;
+	std::size_t dimension_;
+	std::vector<Axis> axes_;
+	std::vector<Node> nodes_;  // nodes_[i] holds configuration i
+	std::vector<double> data_;  // configurations, stored contiguously
+};
+}  // namespace task_constructor
+}  // namespace moveit
@@ -49,16 +49,25 @@ namespace task_constructor {
  *  Throws if there are any duplicate, active joints in the groups */
 moveit::core::JointModelGroup* merge(const std::vector<const moveit::core::JointModelGroup*>& groups);
 
+/** Shared, immutable JointModelGroup comprising all joints of the given groups
+ *
+ *  Merged groups are registered per RobotModel and set of groups (independent of their order),
+ *  i.e. each combination is constructed only once per process and stays alive with its RobotModel.
+ *  Throws if there are any duplicate, active joints in the groups */
+moveit::core::JointModelGroupConstPtr mergedGroup(const moveit::core::RobotModelConstPtr& robot_model,
+                                                  const std::vector<const moveit::core::JointModelGroup*>& groups);
+
 /** merge all sub trajectories into a single RobotTrajectory for parallel execution
  *
  * As the RobotTrajectory maintains a pointer to the underlying JointModelGroup
- * (to know about the involved joint names), a merged JointModelGroup needs to be passed
- * or created on the fly. This JMG needs to stay alive during the lifetime of the trajectory.
+ * (to know about the involved joint names), a merged JointModelGroup needs to be passed.
+ * If none is passed, the shared group from mergedGroup() is used (and returned).
+ * A passed JMG needs to stay alive during the lifetime of the trajectory.
  * For now, only the trajectory path is considered. Timings, velocities, etc. are ignored.
  */
 robot_trajectory::RobotTrajectoryPtr
 merge(const std::vector<robot_trajectory::RobotTrajectoryConstPtr>& sub_trajectories,
-      const moveit::core::RobotState& base_state, moveit::core::JointModelGroup*& merged_group,
+      const moveit::core::RobotState& base_state, const moveit::core::JointModelGroup*& merged_group,
       const trajectory_processing::TimeParameterization& time_parameterization);
 }  // namespace task_constructor
 }  // namespace moveit
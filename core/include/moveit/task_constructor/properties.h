@@ -41,6 +41,9 @@
 #include <boost/any.hpp>
 #include <typeindex>
 #include <map>
+#include <memory>
+#include <optional>
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <functional>
@@ -90,6 +93,8 @@ public:
 	class type_error;
 
 	using SourceFlags = uint;
+	/// version number, changing with every modification of the property's value
+	using Version = uint64_t;
 	/// function callback used to initialize property value from another PropertyMap
 	using InitializerFunction = std::function<boost::any(const PropertyMap&)>;
 
@@ -100,6 +105,8 @@ public:
 
 	/// reset to default value (which can be empty)
 	void reset();
+	/// reset to default value, if the current value was initialized from one of the given sources
+	void reset(SourceFlags sources);
 
 	/// the current value defined or will the fallback be used?
 	inline bool defined() const { return !value_.empty(); }
@@ -110,6 +117,12 @@ public:
 	/// get default value
 	const boost::any& defaultValue() const { return default_; }
 
+	/** version of current/default value: unique across all properties and changed by every modification
+	 *
+	 * For types registered with an equality comparison (see PropertySerializer), assigning an equal value
+	 * keeps the version. */
+	Version version() const { return version_; }
+
 	/// serialize value using registered functions
 	static std::string serialize(const boost::any& value);
 	static boost::any deserialize(const std::string& type_name, const std::string& wire);
@@ -130,6 +143,12 @@ public:
 	/// configure initialization from source using given other property name
 	Property& configureInitFrom(SourceFlags source, const std::string& name);
 
+	/// does the declared type of the property match T?
+	template <typename T>
+	bool isOfType() const {
+		return type_info_ == typeid(T);
+	}
+
 private:
 	std::string description_;
 	const type_info& type_info_;
@@ -140,6 +159,12 @@ private:
 	SourceFlags source_flags_ = 0;
 	SourceFlags initialized_from_;
 	InitializerFunction initializer_;
+
+	Version version_;
+	/// assign a new, globally unique version
+	void updateVersion();
+	/// are both values known to be equal?
+	static bool equal(const boost::any& a, const boost::any& b);
 };
 
 class Property::error : public std::runtime_error
@@ -188,18 +213,27 @@ template <typename T>
 struct hasDeserialize<T, decltype(std::declval<std::istream&>() >> std::declval<T&>())> : std::true_type
 {};
 
+// isComparable<T>::value is true for types known to support operator== (generic containers can't be detected)
+template <typename T>
+struct isComparable
+  : std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+                                     std::is_same<T, std::string>::value || ros::message_traits::IsMessage<T>::value>
+{};
+
 class PropertySerializerBase
 {
 public:
 	using SerializeFunction = std::string (*)(const boost::any&);
 	using DeserializeFunction = boost::any (*)(const std::string&);
+	/// compare two values of the registered type
+	using EqualFunction = bool (*)(const boost::any&, const boost::any&);
 
 	static std::string dummySerialize(const boost::any& /*unused*/) { return ""; }
 	static boost::any dummyDeserialize(const std::string& /*unused*/) { return boost::any(); }
 
 protected:
 	static bool insert(const std::type_index& type_index, const std::string& type_name, SerializeFunction serialize,
-	                   DeserializeFunction deserialize);
+	                   DeserializeFunction deserialize, EqualFunction equal = nullptr);
 };
 
 /// utility class to register serializer/deserializer functions for a property of type T
@@ -207,7 +241,7 @@ template <typename T>
 class PropertySerializer : protected PropertySerializerBase
 {
 public:
-	PropertySerializer() { insert(typeid(T), typeName<T>(), &serialize, &deserialize); }
+	PropertySerializer() { insert(typeid(T), typeName<T>(), &serialize, &deserialize, equal()); }
 
 	template <class Q = T>
 	static typename std::enable_if<ros::message_traits::IsMessage<Q>::value, std::string>::type typeName() {
@@ -246,32 +280,182 @@ private:
 	deserialize(const std::string& wire) {
 		return dummyDeserialize(wire);
 	}
+
+	/** Comparison, if available (values are known to be of type T) */
+	static EqualFunction equal() {
+		if constexpr (isComparable<T>::value)
+			return [](const boost::any& a, const boost::any& b) {
+				return *boost::unsafe_any_cast<T>(&a) == *boost::unsafe_any_cast<T>(&b);
+			};
+		else
+			return nullptr;
+	}
+};
+
+/** Typed handle to a Property of a PropertyMap, resolved once by name via PropertyMap::handle().
+ *
+ * Handles are meant to be resolved in init() and used in compute() to avoid repeated
+ * lookups by name and type checks in the hot path. A handle remains valid as long as the
+ * PropertyMap it was obtained from.
+ */
+template <typename T>
+class PropertyHandle
+{
+	friend class PropertyMap;
+
+	const std::string* name_ = nullptr;
+	const Property* property_ = nullptr;
+	/// type of property is boost::any, i.e. value's type needs to be checked on access
+	bool check_type_ = false;
+	/// shared with the PropertyMap, which refuses assignment while handles are outstanding
+	std::shared_ptr<const void> token_;
+
+	PropertyHandle(const std::string& name, const Property& property, bool check_type,
+	               std::shared_ptr<const void> token)
+	  : name_(&name), property_(&property), check_type_(check_type), token_(std::move(token)) {}
+
+public:
+	PropertyHandle() = default;
+
+	/// was the handle resolved?
+	explicit operator bool() const { return property_ != nullptr; }
+
+	const std::string& name() const { return *name_; }
+	const Property& property() const { return *property_; }
+
+	/// Get typed value of property. Throws undefined, or bad_any_cast for a boost::any property of another type.
+	const T& get() const {
+		const boost::any& value = property_->value();
+		if (value.empty())
+			throw Property::undefined(*name_);
+		return cast(value);
+	}
+	/// get typed value of property, using fallback if undefined
+	const T& get(const T& fallback) const {
+		const boost::any& value = property_->value();
+		return value.empty() ? fallback : cast(value);
+	}
+
+private:
+	const T& cast(const boost::any& value) const {
+		if constexpr (std::is_same_v<T, boost::any>)
+			return value;
+		else if (check_type_)
+			return boost::any_cast<const T&>(value);
+		else  // the property's declared type matches T, which is enforced on assignment
+			return *boost::unsafe_any_cast<T>(&value);
+	}
+};
+
+/** Memoizes an object derived from one or more property values, e.g. a constraint set.
+ *
+ * The object is only recomputed if any of its dependencies changed since the last computation:
+ * properties are compared by their version, other dependencies by identity.
+ */
+template <typename T>
+class PropertyCache
+{
+public:
+	class Dependency
+	{
+		friend class PropertyCache;
+		const void* source_;
+		Property::Version version_;
+		std::shared_ptr<const void> keep_alive_;
+
+	public:
+		/// depend on the value of a property
+		Dependency(const Property& property) : source_(&property), version_(property.version()) {}
+		/// depend on the identity of an object, which needs to outlive the cache
+		Dependency(const void* object) : source_(object), version_(0) {}
+		/// depend on the identity of a shared object, which is kept alive by the cache
+		template <typename S>
+		Dependency(const std::shared_ptr<S>& object) : source_(object.get()), version_(0), keep_alive_(object) {}
+
+		bool operator==(const Dependency& other) const {
+			return source_ == other.source_ && version_ == other.version_;
+		}
+	};
+
+	/// get the cached value, (re)computing it via compute() if any of the dependencies changed
+	template <typename F>
+	const T& get(std::initializer_list<Dependency> dependencies, const F& compute) {
+		if (!value_ ||
+		    !std::equal(dependencies.begin(), dependencies.end(), dependencies_.begin(), dependencies_.end())) {
+			reset();
+			value_.emplace(compute());
+			dependencies_.assign(dependencies.begin(), dependencies.end());
+		}
+		return *value_;
+	}
+
+	/// drop cached value and dependencies
+	void reset() {
+		value_.reset();
+		dependencies_.clear();
+	}
+
+private:
+	std::optional<T> value_;
+	std::vector<Dependency> dependencies_;
 };
 
 /** PropertyMap is map of (name, Property) pairs.
  *
  * Conveniency methods are provided to setup property initialization for several
  * properties at once - always inheriting from the identically named external property.
+ *
+ * Copying a PropertyMap is cheap: the underlying properties are shared between copies
+ * until one of them is modified (copy-on-write). Once a non-const reference to an individual
+ * property was handed out (via declare(), property(), or non-const iteration), the map
+ * becomes unshareable, i.e. subsequent copies will be deep copies.
+ * Assigning to a map replaces its properties. As this would invalidate resolved PropertyHandles,
+ * assignment throws Property::error while handles to the map's properties exist.
  */
 class PropertyMap
 {
-	std::map<std::string, Property> props_;
+	using container_type = std::map<std::string, Property>;
+	/// properties, shared between copies of this map until modification (nullptr if empty)
+	std::shared_ptr<container_type> props_;
+	/// false if references to properties escaped: copies need to clone props_ then
+	bool shareable_ = true;
+	/// token shared with all handles resolved from this map
+	std::shared_ptr<const void> handles_;
+
+	/// read access to properties
+	const container_type& props() const { return props_ ? *props_ : emptyProps(); }
+	static const container_type& emptyProps();
+	/// write access to properties, detaching from other copies if neccessary
+	container_type& mutableProps();
+	/// write access, handing out references to individual properties
+	container_type& leakProps() {
+		shareable_ = false;
+		return mutableProps();
+	}
 
 	/// implementation of declare methods
 	Property& declare(const std::string& name, const Property::type_info& type_info, const std::string& description,
 	                  const boost::any& default_value);
 
 public:
+	PropertyMap() = default;
+	PropertyMap(const PropertyMap& other);
+	PropertyMap(PropertyMap&& other) = default;
+	PropertyMap& operator=(const PropertyMap& other);
+	PropertyMap& operator=(PropertyMap&& other);
+
 	/// declare a property for future use
 	template <typename T>
 	Property& declare(const std::string& name, const std::string& description = "") {
 		PropertySerializer<T>();  // register serializer/deserializer
+		shareable_ = false;
 		return declare(name, typeid(T), description, boost::any());
 	}
 	/// declare a property with default value
 	template <typename T>
 	Property& declare(const std::string& name, const T& default_value, const std::string& description = "") {
 		PropertySerializer<T>();  // register serializer/deserializer
+		shareable_ = false;
 		return declare(name, typeid(T), description, default_value);
 	}
 
@@ -286,15 +470,31 @@ public:
 
 	/// get the property with given name, throws Property::undeclared for unknown name
 	Property& property(const std::string& name);
-	const Property& property(const std::string& name) const { return const_cast<PropertyMap*>(this)->property(name); }
+	const Property& property(const std::string& name) const;
+
+	using iterator = container_type::iterator;
+	using const_iterator = container_type::const_iterator;
 
-	using iterator = std::map<std::string, Property>::iterator;
-	using const_iterator = std::map<std::string, Property>::const_iterator;
+	iterator begin() { return leakProps().begin(); }
+	iterator end() { return leakProps().end(); }
+	const_iterator begin() const { return props().begin(); }
+	const_iterator end() const { return props().end(); }
 
-	iterator begin() { return props_.begin(); }
-	iterator end() { return props_.end(); }
-	const_iterator begin() const { return props_.begin(); }
-	const_iterator end() const { return props_.end(); }
+	/// get a typed handle to the property with given name, throws Property::undeclared or Property::type_error
+	template <typename T>
+	PropertyHandle<T> handle(const std::string& name) {
+		auto& props = leakProps();
+		auto it = props.find(name);
+		if (it == props.end())
+			throw Property::undeclared(name);
+		const Property& p = it->second;
+		const bool is_any = p.isOfType<boost::any>();
+		if (!is_any && !p.isOfType<T>())
+			throw Property::type_error(typeid(T).name(), p.type_info_.name());
+		if (!handles_)
+			handles_ = std::make_shared<char>();
+		return PropertyHandle<T>(it->first, p, is_any, handles_);
+	}
 
 	/// allow initialization from given source for listed properties - always using the same name
 	void configureInitFrom(Property::SourceFlags source, const std::set<std::string>& properties = {});
@@ -302,10 +502,12 @@ public:
 	/// set (and, if neccessary, declare) the value of a property
 	template <typename T>
 	void set(const std::string& name, const T& value) {
-		auto it = props_.find(name);
-		if (it == props_.end())  // name is not yet declared
-			declare<T>(name, value, "");
-		else
+		auto& props = mutableProps();
+		auto it = props.find(name);
+		if (it == props.end()) {  // name is not yet declared
+			PropertySerializer<T>();  // register serializer/deserializer
+			declare(name, typeid(T), "", value);
+		} else
 			it->second.setValue(value);
 	}
 
@@ -338,6 +540,8 @@ public:
 
 	/// reset all properties to their defaults
 	void reset();
+	/// reset all properties initialized from one of the given sources
+	void reset(Property::SourceFlags sources);
 
 	/// perform initialization of still undefined properties using configured initializers
 	void performInitFrom(Property::SourceFlags source, const PropertyMap& other);
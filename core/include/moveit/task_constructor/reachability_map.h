@@ -0,0 +1,127 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Precomputed, memory-mappable reachability map of a group's link
+ */
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <Eigen/Geometry>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace moveit {
+namespace core {
+MOVEIT_CLASS_FORWARD(RobotModel);
+MOVEIT_CLASS_FORWARD(RobotState);
+}  // namespace core
+}  // namespace moveit
+
+namespace moveit {
+namespace task_constructor {
+
+MOVEIT_CLASS_FORWARD(ReachabilityMap);
+
+/** Precomputed reachability of a link's poses w.r.t. the base link of a group
+ *
+ * The workspace is discretized into voxels. For each voxel, a bitmask stores which directions
+ * of the link's z-axis were reached, out of NUM_DIRECTIONS directions evenly distributed on the sphere.
+ * Maps are built offline from forward kinematics of random joint configurations of the group.
+ * Loading a map from file memory-maps it instead of reading it.
+ *
+ * Queries are tolerant: a pose is considered reachable if any neighbouring voxel reached any
+ * neighbouring direction. However, the map is only as complete as its random sampling:
+ * reachable poses in regions that weren't sampled (densely enough) are reported as unreachable.
+ * Hence, a negative answer is a heuristic hint, not a proof of unreachability.
+ */
+class ReachabilityMap
+{
+public:
+	static constexpr std::size_t NUM_DIRECTIONS = 64;
+
+	/// build a map for link of group, sampling the given number of random joint configurations
+	static ReachabilityMapPtr build(const moveit::core::RobotModelConstPtr& robot_model, const std::string& group,
+	                                const std::string& link, double resolution, std::size_t samples,
+	                                unsigned int seed = 0);
+	/// memory-map a map file created by save(), throws std::runtime_error on failure
+	static ReachabilityMapPtr load(const std::string& file);
+	void save(const std::string& file) const;
+
+	ReachabilityMap(const ReachabilityMap&) = delete;
+	ReachabilityMap& operator=(const ReachabilityMap&) = delete;
+	~ReachabilityMap();
+
+	const std::string& group() const { return group_; }
+	const std::string& link() const { return link_; }
+	/// poses are expressed w.r.t. this link (empty: model frame)
+	const std::string& baseLink() const { return base_link_; }
+	double resolution() const { return resolution_; }
+	const std::array<uint32_t, 3>& size() const { return size_; }
+	std::size_t samples() const { return samples_; }
+
+	/// is pose of link (w.r.t. base link) reachable?
+	bool reachable(const Eigen::Isometry3d& pose) const;
+	/// is pose of link (w.r.t. model frame) reachable, given the placement of the base link in state?
+	bool reachable(const moveit::core::RobotState& state, const Eigen::Isometry3d& pose) const;
+
+	/// fraction of voxels reached by any sample
+	double occupancy() const;
+
+private:
+	ReachabilityMap() = default;
+
+	std::size_t cellIndex(uint32_t x, uint32_t y, uint32_t z) const {
+		return (static_cast<std::size_t>(z) * size_[1] + y) * size_[0] + x;
+	}
+	std::size_t numCells() const { return static_cast<std::size_t>(size_[0]) * size_[1] * size_[2]; }
+
+	std::string group_;
+	std::string link_;
+	std::string base_link_;
+	double resolution_ = 0.0;
+	Eigen::Vector3d origin_;  // lower corner of grid
+	std::array<uint32_t, 3> size_ = { 0, 0, 0 };
+	std::size_t samples_ = 0;
+
+	const uint64_t* cells_ = nullptr;  // direction bitmasks, pointing into storage_ or mapping_
+	std::vector<uint64_t> storage_;
+	void* mapping_ = nullptr;
+	std::size_t mapping_size_ = 0;
+};
+}  // namespace task_constructor
+}  // namespace moveit
@@ -0,0 +1,92 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Local store of task solutions, indexed by task and start scene fingerprints
+ */
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <moveit_task_constructor_msgs/Solution.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace moveit {
+namespace task_constructor {
+
+MOVEIT_CLASS_FORWARD(SolutionStore);
+
+/** Persistent store of the best solutions of previously planned tasks
+ *
+ * Solutions are stored as moveit_task_constructor_msgs::Solution, one file per key in a directory.
+ * The key identifies the task configuration and its start scene (see Task::setSolutionStore()).
+ * Instead of introspection ids, the stage_id of each sub trajectory holds the index of its creator
+ * in a depth-first traversal of the task's stage tree.
+ */
+class SolutionStore
+{
+public:
+	/** Create a store
+	 *
+	 * @param directory location of the solution files, created if it doesn't exist
+	 * @param max_solutions max number of solutions stored per key
+	 */
+	explicit SolutionStore(std::string directory, std::size_t max_solutions = 10);
+
+	const std::string& directory() const { return directory_; }
+	std::size_t maxSolutions() const { return max_solutions_; }
+
+	/// replace the solutions of key, keeping the first maxSolutions() ones
+	void store(uint64_t key, const std::vector<moveit_task_constructor_msgs::Solution>& solutions);
+	/// retrieve the solutions of key (empty if there are none), counting hits and misses
+	std::vector<moveit_task_constructor_msgs::Solution> load(uint64_t key);
+	/// remove the solutions of key, e.g. if they failed revalidation
+	void erase(uint64_t key);
+
+	std::size_t hits() const { return hits_; }
+	std::size_t misses() const { return misses_; }
+
+private:
+	std::string file(uint64_t key) const;
+
+	std::string directory_;
+	std::size_t max_solutions_;
+	std::atomic<std::size_t> hits_{ 0 };
+	std::atomic<std::size_t> misses_{ 0 };
+};
+}  // namespace task_constructor
+}  // namespace moveit
@@ -0,0 +1,87 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Planner wrapper reusing trajectories from a TrajectoryCache
+ */
+
+#pragma once
+
+#include <moveit/task_constructor/solvers/planner_interface.h>
+#include <moveit/macros/class_forward.h>
+
+namespace moveit {
+namespace task_constructor {
+MOVEIT_CLASS_FORWARD(TrajectoryCache);
+
+namespace solvers {
+
+MOVEIT_CLASS_FORWARD(CachedPlanner);
+
+/** Wraps another planner, reusing trajectories planned before for the same query
+ *
+ * Queries are looked up in a TrajectoryCache first, including the wrapped planner's velocity and acceleration
+ * scaling and the type of its time parameterization in the key. Hits are revalidated against the actual
+ * start scene and path constraints, and only returned if valid; otherwise they are dropped from the cache.
+ * On a miss (or rejected hit), the wrapped planner is called and its solution is stored in the cache.
+ * Start and joint-space goal of a hit are set to the exact query, pose goals are only met up to the
+ * cache's resolution.
+ * This pays off for repetitive cycles planning the same motions again and again, e.g. in MoveTo and Connect.
+ */
+class CachedPlanner : public PlannerInterface
+{
+public:
+	CachedPlanner(const PlannerInterfacePtr& planner, const TrajectoryCachePtr& cache);
+
+	const PlannerInterfacePtr& planner() const { return planner_; }
+	const TrajectoryCachePtr& cache() const { return cache_; }
+
+	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
+	bool isThreadSafe() const override { return planner_->isThreadSafe(); }
+
+	Result plan(const planning_scene::PlanningSceneConstPtr& from, const planning_scene::PlanningSceneConstPtr& to,
+	            const moveit::core::JointModelGroup* jmg, double timeout, robot_trajectory::RobotTrajectoryPtr& result,
+	            const moveit_msgs::Constraints& path_constraints = moveit_msgs::Constraints()) override;
+
+	Result plan(const planning_scene::PlanningSceneConstPtr& from, const moveit::core::LinkModel& link,
+	            const Eigen::Isometry3d& offset, const Eigen::Isometry3d& target,
+	            const moveit::core::JointModelGroup* jmg, double timeout, robot_trajectory::RobotTrajectoryPtr& result,
+	            const moveit_msgs::Constraints& path_constraints = moveit_msgs::Constraints()) override;
+
+private:
+	PlannerInterfacePtr planner_;
+	TrajectoryCachePtr cache_;
+};
+}  // namespace solvers
+}  // namespace task_constructor
+}  // namespace moveit
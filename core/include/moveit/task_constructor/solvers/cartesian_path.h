@@ -41,8 +41,12 @@
 #include <moveit/task_constructor/solvers/planner_interface.h>
 #include <moveit/robot_state/cartesian_interpolator.h>
 
+#include <mutex>
+
 namespace moveit {
 namespace task_constructor {
+MOVEIT_CLASS_FORWARD(SphereCollisionFilter);
+
 namespace solvers {
 
 MOVEIT_CLASS_FORWARD(CartesianPath);
@@ -64,6 +68,8 @@ public:
 		static_assert(std::is_integral<T>::value, "setJumpThreshold() is deprecated. Replace with setPrecision.");
 	}
 	void setMinFraction(double min_fraction) { setProperty("min_fraction", min_fraction); }
+	/// skip full collision checks of waypoints that are collision-free according to a bounding-sphere approximation
+	void setCollisionPrefilter(bool flag) { setProperty("collision_prefilter", flag); }
 
 	[[deprecated("Replace with setMaxVelocityScalingFactor")]]  // clang-format off
 	void setMaxVelocityScaling(double factor) { setMaxVelocityScalingFactor(factor); }  // clang-format on
@@ -80,6 +86,11 @@ public:
 	            const Eigen::Isometry3d& offset, const Eigen::Isometry3d& target,
 	            const moveit::core::JointModelGroup* jmg, double timeout, robot_trajectory::RobotTrajectoryPtr& result,
 	            const moveit_msgs::Constraints& path_constraints = moveit_msgs::Constraints()) override;
+
+private:
+	/// collision prefilter of the last start scene
+	std::mutex collision_filter_mutex_;  // planners are shared by task clones, planned in parallel
+	PropertyCache<SphereCollisionFilterConstPtr> collision_filter_cache_;
 };
 }  // namespace solvers
 }  // namespace task_constructor
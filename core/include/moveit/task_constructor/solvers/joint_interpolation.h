@@ -41,8 +41,12 @@
 #include <moveit/task_constructor/solvers/planner_interface.h>
 #include <moveit/macros/class_forward.h>
 
+#include <mutex>
+
 namespace moveit {
 namespace task_constructor {
+MOVEIT_CLASS_FORWARD(SphereCollisionFilter);
+
 namespace solvers {
 
 MOVEIT_CLASS_FORWARD(JointInterpolationPlanner);
@@ -56,6 +60,9 @@ class JointInterpolationPlanner : public PlannerInterface
 public:
 	JointInterpolationPlanner();
 
+	/// skip full collision checks of waypoints that are collision-free according to a bounding-sphere approximation
+	void setCollisionPrefilter(bool flag) { setProperty("collision_prefilter", flag); }
+
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
 
 	Result plan(const planning_scene::PlanningSceneConstPtr& from, const planning_scene::PlanningSceneConstPtr& to,
@@ -66,6 +73,11 @@ public:
 	            const Eigen::Isometry3d& offset, const Eigen::Isometry3d& target,
 	            const moveit::core::JointModelGroup* jmg, double timeout, robot_trajectory::RobotTrajectoryPtr& result,
 	            const moveit_msgs::Constraints& path_constraints = moveit_msgs::Constraints()) override;
+
+private:
+	/// collision prefilter of the last start scene
+	std::mutex collision_filter_mutex_;  // planners are shared by task clones, planned in parallel
+	PropertyCache<SphereCollisionFilterConstPtr> collision_filter_cache_;
 };
 }  // namespace solvers
 }  // namespace task_constructor
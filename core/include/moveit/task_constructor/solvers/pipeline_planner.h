@@ -42,17 +42,128 @@
 #include <moveit_msgs/MotionPlanRequest.h>
 #include <moveit/macros/class_forward.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
 namespace planning_pipeline {
 MOVEIT_CLASS_FORWARD(PlanningPipeline);
 }
 
 namespace moveit {
 namespace task_constructor {
+MOVEIT_CLASS_FORWARD(CostTerm);
+
 namespace solvers {
 
 MOVEIT_CLASS_FORWARD(PipelinePlanner);
 
-/** Use MoveIt's PlanningPipeline to plan a trajectory between to scenes */
+/** Thread-safe pool of equivalent instances of T
+ *
+ * PlanningPipeline is not safe for concurrent use. Hence, each concurrent planning call checks out
+ * its own instance. Instances are created lazily, up to a maximum number, and reused afterwards.
+ */
+template <typename T>
+class InstancePool : public std::enable_shared_from_this<InstancePool<T>>
+{
+public:
+	using Ptr = std::shared_ptr<T>;
+	using Factory = std::function<Ptr()>;
+
+	/// pool creating up to max_size instances on demand
+	InstancePool(Factory factory, size_t max_size)
+	  : factory_(std::move(factory)), max_size_(std::max<size_t>(max_size, 1)) {}
+	/// pool serializing access to a single, given instance
+	explicit InstancePool(const Ptr& instance) : idle_{ instance }, created_(1), max_size_(1) {}
+
+	/** Check out an idle instance, creating a new one or waiting for one to become idle if necessary.
+	 *
+	 * The instance is returned to the pool when the last copy of the returned pointer is destroyed. */
+	Ptr checkout() {
+		Ptr instance;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			idle_available_.wait(lock, [this] { return !idle_.empty() || (factory_ && created_ < max_size_); });
+			if (!idle_.empty()) {
+				instance = std::move(idle_.back());
+				idle_.pop_back();
+			} else
+				++created_;  // reserve a slot and create the instance outside the lock
+		}
+		if (!instance) {
+			try {
+				instance = factory_();
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				--created_;
+				idle_available_.notify_one();
+				throw;
+			}
+		}
+		// aliasing pointer, returning the instance to the pool when released
+		auto self = this->shared_from_this();
+		return Ptr(instance.get(), [self, instance](T* /*unused*/) { self->checkin(instance); });
+	}
+
+	/// increase the maximum number of instances (never shrinks, a pool without factory keeps its single instance)
+	void reserve(size_t max_size) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!factory_)
+				return;
+			max_size_ = std::max(max_size_, max_size);
+		}
+		idle_available_.notify_all();
+	}
+	size_t maxSize() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return max_size_;
+	}
+	/// number of instances created so far
+	size_t size() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return created_;
+	}
+
+private:
+	void checkin(const Ptr& instance) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			idle_.push_back(instance);
+		}
+		idle_available_.notify_one();
+	}
+
+	Factory factory_;
+	mutable std::mutex mutex_;
+	std::condition_variable idle_available_;
+	std::vector<Ptr> idle_;
+	size_t created_ = 0;
+	size_t max_size_;
+};
+using PipelinePool = InstancePool<planning_pipeline::PlanningPipeline>;
+using PipelinePoolPtr = std::shared_ptr<PipelinePool>;
+
+/** Run num_attempts planning attempts concurrently and select the cheapest successful trajectory
+ *
+ * attempt(i, trajectory) runs the i-th attempt, returning its success. The trajectories are judged
+ * by cost_term, applied to a SubTrajectory without start and end states.
+ * Returns the index of the selected attempt (the first one of equally cheap attempts) if any succeeded.
+ */
+std::optional<size_t>
+planCheapest(size_t num_attempts, const std::function<bool(size_t, robot_trajectory::RobotTrajectoryPtr&)>& attempt,
+             const CostTerm& cost_term, robot_trajectory::RobotTrajectoryPtr& result);
+
+/** Use MoveIt's PlanningPipeline to plan a trajectory between to scenes
+ *
+ * With num_parallel_requests > 1, several independent requests are planned concurrently
+ * on pooled pipeline instances and the cheapest solution is returned. A custom pipeline,
+ * passed on construction, cannot be instantiated multiple times: it plans a single request.
+ */
 class PipelinePlanner : public PlannerInterface
 {
 public:
@@ -70,15 +181,28 @@ public:
 		return create(spec);
 	}
 
+	/// shared pipeline instance for the given specification (not safe for concurrent planning)
 	static planning_pipeline::PlanningPipelinePtr create(const Specification& spec);
 
+	/// shared pool of pipelines for the given specification, providing up to max_size instances
+	static PipelinePoolPtr pool(const Specification& spec, size_t max_size);
+
 	PipelinePlanner(const std::string& pipeline = "ompl");
 
 	PipelinePlanner(const planning_pipeline::PlanningPipelinePtr& planning_pipeline);
 
 	void setPlannerId(const std::string& planner) { setProperty("planner", planner); }
+	/// plan n independent requests in parallel, returning the cheapest solution
+	void setNumParallelRequests(uint32_t n) { setProperty("num_parallel_requests", n); }
+	/** cost term judging solutions of parallel requests, PathLength by default
+	 *
+	 * The cost term is applied to a SubTrajectory without start and end states,
+	 * i.e. it should only consider the trajectory. Usually, this is the stage's cost term. */
+	void setCostTerm(const CostTermConstPtr& cost_term) { cost_term_ = cost_term; }
 
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
+	/// concurrent requests are planned on separate pipeline instances of the pool
+	bool isThreadSafe() const override { return true; }
 
 	Result plan(const planning_scene::PlanningSceneConstPtr& from, const planning_scene::PlanningSceneConstPtr& to,
 	            const core::JointModelGroup* jmg, double timeout, robot_trajectory::RobotTrajectoryPtr& result,
@@ -93,8 +217,36 @@ protected:
 	Result plan(const planning_scene::PlanningSceneConstPtr& from, const moveit_msgs::MotionPlanRequest& req,
 	            robot_trajectory::RobotTrajectoryPtr& result);
 
+	/// fill common fields of motion plan request from (pre-resolved) properties
+	void initMotionPlanRequest(moveit_msgs::MotionPlanRequest& req, const moveit::core::JointModelGroup* jmg,
+	                           double timeout) const;
+
+	/// plan num_parallel_requests requests concurrently and pick the cheapest solution
+	Result planParallel(const planning_scene::PlanningSceneConstPtr& from, const moveit_msgs::MotionPlanRequest& req,
+	                    uint32_t num_requests, robot_trajectory::RobotTrajectoryPtr& result);
+
 	std::string pipeline_name_;
-	planning_pipeline::PlanningPipelinePtr planner_;
+	planning_pipeline::PlanningPipelinePtr planner_;  // custom pipeline passed on construction
+	PipelinePoolPtr pool_;
+	uint32_t max_parallel_requests_ = 1;  // pool_size, limiting num_parallel_requests
+	bool display_motion_plans_ = false;
+	bool publish_planning_requests_ = false;
+	CostTermConstPtr cost_term_;
+
+	/// property handles, resolved on construction
+	struct
+	{
+		PropertyHandle<std::string> planner;
+		PropertyHandle<double> timeout;
+		PropertyHandle<uint> num_planning_attempts;
+		PropertyHandle<uint32_t> num_parallel_requests;
+		PropertyHandle<double> max_velocity_scaling_factor;
+		PropertyHandle<double> max_acceleration_scaling_factor;
+		PropertyHandle<moveit_msgs::WorkspaceParameters> workspace_parameters;
+		PropertyHandle<double> goal_joint_tolerance;
+		PropertyHandle<double> goal_position_tolerance;
+		PropertyHandle<double> goal_orientation_tolerance;
+	} props_;
 };
 }  // namespace solvers
 }  // namespace task_constructor
@@ -95,6 +95,9 @@ public:
 
 	virtual void init(const moveit::core::RobotModelConstPtr& robot_model) = 0;
 
+	/// can plan() be called concurrently from several threads (e.g. by Connect's parallel planning)?
+	virtual bool isThreadSafe() const { return false; }
+
 	/// plan trajectory between to robot states
 	virtual Result plan(const planning_scene::PlanningSceneConstPtr& from,
 	                    const planning_scene::PlanningSceneConstPtr& to, const moveit::core::JointModelGroup* jmg,
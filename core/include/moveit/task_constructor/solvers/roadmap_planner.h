@@ -0,0 +1,123 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Plan on a lazily validated roadmap, reused across queries in the same scene
+ */
+
+#pragma once
+
+#include <moveit/task_constructor/solvers/planner_interface.h>
+#include <moveit/macros/class_forward.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace moveit {
+namespace task_constructor {
+namespace solvers {
+
+MOVEIT_CLASS_FORWARD(RoadmapPlanner);
+
+/** Plan in joint space on a probabilistic roadmap that grows across queries
+ *
+ * A roadmap is kept per planning group and scene fingerprint (see IKCache::sceneFingerprint()),
+ * such that many queries within a static scene, e.g. the Connect stages of a task, share their work.
+ * Only the max_roadmaps most recently used roadmaps are kept, as every change of the scene starts a new one.
+ * Nodes and edges are collision-checked lazily, i.e. only once they become part of a shortest path candidate.
+ * The resulting path is shortcut and densified to max_step, before it is time-parameterized.
+ *
+ * Roadmaps of static workcells can be saved to disk and loaded again, skipping the construction effort.
+ */
+class RoadmapPlanner : public PlannerInterface
+{
+public:
+	RoadmapPlanner();
+	~RoadmapPlanner() override;
+
+	/// max joint-space distance between waypoints of the resulting trajectory and edge validation resolution
+	void setMaxStep(double max_step) { setProperty("max_step", max_step); }
+	/// number of nearest neighbors each new roadmap node is connected to
+	void setNeighbors(unsigned int neighbors) { setProperty("neighbors", neighbors); }
+	/// number of random samples added to the roadmap whenever the current one does not provide a path
+	void setSamplesPerIteration(unsigned int samples) { setProperty("samples_per_iteration", samples); }
+	/// number of roadmaps kept, evicting the least recently used ones (0: unbounded)
+	void setMaxRoadmaps(unsigned int max_roadmaps) { setProperty("max_roadmaps", max_roadmaps); }
+
+	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
+
+	Result plan(const planning_scene::PlanningSceneConstPtr& from, const planning_scene::PlanningSceneConstPtr& to,
+	            const core::JointModelGroup* jmg, double timeout, robot_trajectory::RobotTrajectoryPtr& result,
+	            const moveit_msgs::Constraints& path_constraints = moveit_msgs::Constraints()) override;
+
+	Result plan(const planning_scene::PlanningSceneConstPtr& from, const moveit::core::LinkModel& link,
+	            const Eigen::Isometry3d& offset, const Eigen::Isometry3d& target,
+	            const moveit::core::JointModelGroup* jmg, double timeout, robot_trajectory::RobotTrajectoryPtr& result,
+	            const moveit_msgs::Constraints& path_constraints = moveit_msgs::Constraints()) override;
+
+	/// number of roadmaps, i.e. distinct (group, scene) pairs planned for
+	std::size_t numRoadmaps() const;
+	/// total number of nodes in all roadmaps
+	std::size_t numNodes() const;
+	void clear();
+
+	/// write all roadmaps, including the validation status of their nodes and edges, to file
+	void save(const std::string& file) const;
+	/// add the roadmaps stored in file, replacing existing ones of the same group and scene
+	void load(const std::string& file, const moveit::core::RobotModelConstPtr& robot_model);
+
+private:
+	class Roadmap;
+	using Key = std::pair<std::string, std::size_t>;  // group name, scene fingerprint
+	struct Entry
+	{
+		std::shared_ptr<Roadmap> roadmap;
+		uint64_t last_used = 0;  // value of uses_ when last returned by roadmapFor()
+	};
+
+	std::shared_ptr<Roadmap> roadmapFor(const moveit::core::JointModelGroup* jmg, std::size_t fingerprint);
+	/// drop the least recently used roadmaps exceeding max_roadmaps, requires mutex_ to be locked
+	void evict();
+
+	mutable std::mutex mutex_;  // protects robot_model_, uses_ and roadmaps_, each Roadmap has its own mutex
+	moveit::core::RobotModelConstPtr robot_model_;
+	uint64_t uses_ = 0;
+	std::map<Key, Entry> roadmaps_;
+};
+}  // namespace solvers
+}  // namespace task_constructor
+}  // namespace moveit
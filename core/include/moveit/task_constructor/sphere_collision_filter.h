@@ -0,0 +1,117 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Conservative collision prefilter based on bounding spheres
+ */
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <Eigen/Core>
+
+#include <string>
+#include <vector>
+
+namespace planning_scene {
+MOVEIT_CLASS_FORWARD(PlanningScene);
+}
+namespace moveit {
+namespace core {
+MOVEIT_CLASS_FORWARD(RobotState);
+MOVEIT_CLASS_FORWARD(JointModelGroup);
+MOVEIT_CLASS_FORWARD(LinkModel);
+}  // namespace core
+}  // namespace moveit
+
+namespace moveit {
+namespace task_constructor {
+
+MOVEIT_CLASS_FORWARD(SphereCollisionFilter);
+
+/** Collision prefilter approximating robot links, attached bodies, and collision objects by bounding spheres
+ *
+ * The filter is built for a fixed planning scene (world, attached bodies, ACM, padding) and classifies
+ * robot states (with updated link transforms) of the given group:
+ *  - FREE if no pair of spheres, which is not allowed to collide, overlaps
+ *  - COLLIDING if an overlapping pair is approximated exactly, i.e. consists of sphere shapes only
+ *  - UNKNOWN otherwise: the full collision check needs to decide
+ *
+ * Only pairs involving links updated by the group are considered, as for a
+ * CollisionRequest with group_name. Sphere distances are evaluated vectorized.
+ */
+class SphereCollisionFilter
+{
+public:
+	enum Result
+	{
+		FREE,
+		COLLIDING,
+		UNKNOWN
+	};
+
+	/// build filter for scene and group (nullptr: all links)
+	SphereCollisionFilter(const planning_scene::PlanningSceneConstPtr& scene,
+	                      const moveit::core::JointModelGroup* jmg = nullptr);
+
+	Result check(const moveit::core::RobotState& state) const;
+
+	/// collision check of scene, skipping the full check if the filter can decide
+	bool isStateColliding(const moveit::core::RobotState& state) const;
+
+	std::size_t numRobotSpheres() const { return links_.size(); }
+	std::size_t numWorldSpheres() const { return static_cast<std::size_t>(world_centers_.cols()); }
+
+private:
+	/// robot sphere: center given in link frame
+	struct LinkSphere
+	{
+		const moveit::core::LinkModel* link;
+		Eigen::Vector3d center;
+	};
+
+	planning_scene::PlanningSceneConstPtr scene_;
+	std::string group_name_;
+
+	std::vector<LinkSphere> links_;
+	Eigen::Matrix3Xd world_centers_;
+
+	// squared sum of radii per pair, -1 for pairs not to be checked
+	Eigen::ArrayXXd world_thresholds_;  // robot x world
+	Eigen::ArrayXXd self_thresholds_;  // robot x robot (upper triangle)
+	// pairs approximated exactly
+	Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic> world_exact_;
+	Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic> self_exact_;
+};
+}  // namespace task_constructor
+}  // namespace moveit
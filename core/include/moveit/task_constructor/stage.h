@@ -45,6 +45,7 @@
 #include <moveit/task_constructor/storage.h>
 #include <vector>
 #include <list>
+#include <map>
 
 #define PRIVATE_CLASS(Class)                   \
 	friend class Class##Private;                \
@@ -179,6 +180,14 @@ public:
 	 */
 	virtual void init(const moveit::core::RobotModelConstPtr& robot_model);
 
+	/** Create an unplanned copy of this stage, as required by Task::clone()
+	 *
+	 * The copy has the same name, properties, and cost term, sharing immutable assets like planners,
+	 * but none of the solutions or solution callbacks. The default implementation throws: stage types
+	 * need to override cloneStage() (usually using copyConfigTo()) to support cloning.
+	 */
+	virtual Stage::pointer cloneStage() const;
+
 	const ContainerBase* parent() const;
 
 	const std::string& name() const;
@@ -256,12 +265,16 @@ public:
 	[[noreturn]] void reportPropertyError(const Property::error& e);
 
 	double getTotalComputeTime() const;
+	/// Stage-specific statistics (e.g. cache hits / misses), published via introspection
+	virtual void statistics(std::map<std::string, double>& /*stats*/) const {}
 
 protected:
 	/// Stage can only be instantiated through derived classes
 	Stage(StagePrivate* impl);
 	/// Stage cannot be copied
 	Stage(const Stage&) = delete;
+	/// copy the generic configuration (name, properties, cost term, ...) to other, for use in cloneStage()
+	void copyConfigTo(Stage& other) const;
 
 protected:
 	StagePrivate* pimpl_;
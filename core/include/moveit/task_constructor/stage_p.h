@@ -48,6 +48,7 @@
 
 #include <ostream>
 #include <chrono>
+#include <unordered_map>
 
 // define pimpl() functions accessing correctly casted pimpl_ pointer
 #define PIMPL_FUNCTIONS(Class)                           \
@@ -179,6 +180,13 @@ public:
 	}
 	bool preempted() const { return preempt_requested_ != nullptr && *preempt_requested_; }
 
+	/// Point to the task's flag indicating that reset() should keep the initialized interfaces and properties
+	void setResetRunOnlyMember(const bool* reset_run_only) { reset_run_only_ = reset_run_only; }
+	bool resetRunOnly() const { return reset_run_only_ != nullptr && *reset_run_only_; }
+	/// Point to the task's flag indicating that reset() should keep results for replaying them (Task::replan())
+	void setReplanningMember(const bool* replanning) { replanning_ = replanning; }
+	bool replanning() const { return replanning_ != nullptr && *replanning_; }
+
 protected:
 	StagePrivate& operator=(StagePrivate&& other);
 
@@ -219,6 +227,8 @@ private:
 	Introspection* introspection_;  // task's introspection instance
 
 	const std::atomic<bool>* preempt_requested_;
+	const bool* reset_run_only_;
+	const bool* replanning_;
 };
 PIMPL_FUNCTIONS(Stage)
 std::ostream& operator<<(std::ostream& os, const StagePrivate& stage);
@@ -243,6 +253,51 @@ inline void StagePrivate::send<Interface::BACKWARD>(const InterfaceState& start,
 	sendBackward(std::move(end), start, solution);
 }
 
+/** Successful results of a computing stage, replayed by Task::replan() for inputs that didn't change
+ *
+ * Results are recorded during a run. When replanning, they are keyed on the exact robot state of their input
+ * state(s), the input's properties, and the collision objects referred to by name from these properties or the
+ * stage's configuration. Stages depending on other inputs (e.g. member variables) are not covered.
+ */
+class ReplayCache
+{
+public:
+	struct Input
+	{
+		const InterfaceState* state;  // identifies the state during the run, not to be dereferenced afterwards
+		planning_scene::PlanningSceneConstPtr scene;
+		PropertyMap properties;
+	};
+	struct Result
+	{
+		Input input;  // state the result was computed from (start state of connecting stages)
+		Input end;  // end state of connecting stages, empty for propagating stages
+		Input created;  // state created by propagating stages, its scene being a diff of input.scene
+		robot_trajectory::RobotTrajectoryConstPtr trajectory;
+		std::string comment;
+		std::deque<visualization_msgs::Marker> markers;
+	};
+
+	void record(Result&& result) { recorded_.push_back(std::move(result)); }
+	/// keep the results recorded during the last run for replaying them, or drop all results
+	void reset(bool keep, const PropertyMap& stage_properties);
+
+	bool empty() const { return previous_.empty(); }
+	/// previous results computed from inputs equivalent to input (and end)
+	std::vector<const Result*> find(const InterfaceState& input, const InterfaceState* end = nullptr) const;
+	/// created scene of result applied to the new input scene, nullptr if objects modified by result differ
+	static planning_scene::PlanningScenePtr rebase(const Result& result,
+	                                               const planning_scene::PlanningSceneConstPtr& scene);
+
+private:
+	/// key of an input state, 0 if its properties cannot be serialized
+	std::size_t key(const planning_scene::PlanningScene& scene, const PropertyMap& properties) const;
+
+	std::vector<std::string> config_;  // serialized configuration of the stage
+	std::list<Result> recorded_;
+	std::unordered_multimap<std::size_t, Result> previous_;
+};
+
 // ComputeBasePrivate is the base class for all computing stages, i.e. non-containers.
 // It adds the trajectories_ variable.
 class ComputeBasePrivate : public StagePrivate
@@ -252,6 +307,8 @@ class ComputeBasePrivate : public StagePrivate
 public:
 	ComputeBasePrivate(Stage* me, const std::string& name) : StagePrivate(me, name) {}
 
+	ReplayCache replay_;  // results of the last run for Task::replan()
+
 private:
 };
 PIMPL_FUNCTIONS(ComputeBase)
@@ -281,6 +338,10 @@ public:
 
 	bool hasEndState() const;
 	const InterfaceState& fetchEndState();
+
+	// send valid previous results computed from state, return true if there were some
+	template <Interface::Direction dir>
+	bool replay(const InterfaceState& state);
 };
 PIMPL_FUNCTIONS(PropagatingEitherWay)
 
@@ -306,6 +367,16 @@ public:
 	InterfaceFlags requiredInterface() const override;
 	bool canCompute() const override;
 	void compute() override;
+
+	/// spawn scene once instead of computing (Task::replan()), nullptr restores computing
+	void substitute(const planning_scene::PlanningSceneConstPtr& scene) {
+		substitute_ = scene;
+		substituted_ = static_cast<bool>(scene);
+	}
+
+private:
+	planning_scene::PlanningSceneConstPtr substitute_;  // reset once spawned
+	bool substituted_ = false;
 };
 PIMPL_FUNCTIONS(Generator)
 
@@ -382,6 +453,9 @@ private:
 	template <Interface::Direction other>
 	void newState(Interface::iterator it, Interface::UpdateFlags updated);
 
+	// connect from and to with valid previous results, return true if there were some
+	bool replay(const InterfaceState& from, const InterfaceState& to);
+
 	// ordered list of pending state pairs
 	ordered<StatePair> pending;
 };
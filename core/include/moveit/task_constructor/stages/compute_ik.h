@@ -38,6 +38,8 @@
 
 #include <moveit/task_constructor/container.h>
 #include <moveit/task_constructor/cost_queue.h>
+#include <moveit/task_constructor/ik_cache.h>
+#include <moveit/task_constructor/reachability_map.h>
 #include <geometry_msgs/PoseStamped.h>
 #include <Eigen/Geometry>
 
@@ -47,9 +49,17 @@ MOVEIT_CLASS_FORWARD(RobotState);
 MOVEIT_CLASS_FORWARD(JointModelGroup);
 }  // namespace core
 }  // namespace moveit
+namespace kinematic_constraints {
+MOVEIT_CLASS_FORWARD(KinematicConstraintSet);
+}
+namespace kinematics {
+MOVEIT_CLASS_FORWARD(KinematicsBase);
+}
 
 namespace moveit {
 namespace task_constructor {
+MOVEIT_CLASS_FORWARD(SphereCollisionFilter);
+
 namespace stages {
 
 /** Wrapper for any pose generator stage to compute IK poses for a Cartesian pose.
@@ -69,6 +79,8 @@ class ComputeIK : public WrapperBase
 {
 public:
 	ComputeIK(const std::string& name = "IK", Stage::pointer&& child = Stage::pointer());
+	~ComputeIK() override;
+	Stage::pointer cloneStage() const override;
 
 	void reset() override;
 	void init(const core::RobotModelConstPtr& robot_model) override;
@@ -77,6 +89,7 @@ public:
 	bool canCompute() const override;
 
 	void compute() override;
+	void statistics(std::map<std::string, double>& stats) const override;
 
 	void setEndEffector(const std::string& eef) { setProperty("eef", eef); }
 	void setGroup(const std::string& group) { setProperty("group", group); }
@@ -109,9 +122,106 @@ public:
 	void setMaxIKSolutions(uint32_t n) { setProperty("max_ik_solutions", n); }
 	void setIgnoreCollisions(bool flag) { setProperty("ignore_collisions", flag); }
 	void setMinSolutionDistance(double distance) { setProperty("min_solution_distance", distance); }
+	/// skip full collision checks of IK solutions that are collision-free according to a bounding-sphere approximation
+	void setCollisionPrefilter(bool flag) { setProperty("collision_prefilter", flag); }
+	/** Sample IK solutions in parallel using n threads
+	 *
+	 * Each thread uses its own solver instance, allocated from the group's kinematics plugin.
+	 * Solutions are spawned after sampling finished, ordered by their costs.
+	 */
+	void setNumThreads(uint32_t n) { setProperty("num_threads", n); }
+	/** Process up to n upstream solutions per compute() call
+	 *
+	 * Targets of a batch are prepared sequentially, but sampled in parallel if num_threads > 1.
+	 * Solutions and failures are still spawned per target, in the order of upstream solutions.
+	 */
+	void setBatchSize(uint32_t n) { setProperty("batch_size", n); }
+
+	/** Use (and fill) the given IK cache
+	 *
+	 * Cached solutions are tried as seeds first. The cache persists across Task::reset()
+	 * and might be shared between several ComputeIK stages.
+	 */
+	void setIKCache(const IKCachePtr& cache) { ik_cache_ = cache; }
+	const IKCachePtr& ikCache() const { return ik_cache_; }
+
+	/** Seed IK with up to n recent solutions of nearby targets
+	 *
+	 * Nearby targets (e.g. neighbouring grasp angles) usually have similar IK solutions.
+	 * Their solutions are tried as seeds before the current state and random restarts.
+	 * Targets are considered nearby if their distance (position + 0.1 * rotation angle) is below radius.
+	 */
+	void setWarmStartSeeds(uint32_t n) { setProperty("warm_start_seeds", n); }
+	void setWarmStartRadius(double radius) { setProperty("warm_start_radius", radius); }
+
+	/** Check targets against a precomputed reachability map before solving IK
+	 *
+	 * As the map is sampled, it may miss reachable targets. Hence, targets marked unreachable are
+	 * still searched, but only for at most unreachable_timeout seconds.
+	 * They are rejected right away only if unreachable_timeout <= 0.
+	 * The map is only used for targets matching the map's group and IK link.
+	 */
+	void setReachabilityMap(const ReachabilityMapConstPtr& map, double unreachable_timeout = 0.01) {
+		reachability_map_ = map;
+		unreachable_timeout_ = unreachable_timeout;
+	}
 
 protected:
 	ordered<const SolutionBase*> upstream_solutions_;
+
+	struct IKTarget;
+	/// initialize target from upstream solution, reporting failures immediately
+	bool prepareTarget(const SolutionBase& s, IKTarget& target);
+	/// sample IK solutions for target using given solvers (or the group's shared solver if empty)
+	static void sampleIK(IKTarget& target, const std::vector<const kinematics::KinematicsBase*>& solvers);
+	/// spawn found IK solutions of target (or a failure if there are none)
+	void spawnSolutions(IKTarget& target, bool sort);
+
+	/// property handles, resolved in init()
+	PropertyHandle<std::string> eef_;
+	PropertyHandle<std::string> group_;
+	PropertyHandle<std::string> default_pose_;
+	PropertyHandle<uint32_t> max_ik_solutions_;
+	PropertyHandle<uint32_t> num_threads_;
+	PropertyHandle<uint32_t> batch_size_;
+	PropertyHandle<uint32_t> warm_start_seeds_;
+	PropertyHandle<double> warm_start_radius_;
+	PropertyHandle<bool> ignore_collisions_;
+	PropertyHandle<double> min_solution_distance_;
+	PropertyHandle<bool> collision_prefilter_;
+	PropertyHandle<moveit_msgs::Constraints> constraints_;
+	PropertyHandle<geometry_msgs::PoseStamped> ik_frame_;
+	PropertyHandle<geometry_msgs::PoseStamped> target_pose_;
+
+	/// validated eef and group (or error message)
+	struct Groups
+	{
+		const moveit::core::JointModelGroup* eef_jmg = nullptr;
+		const moveit::core::JointModelGroup* jmg = nullptr;
+		std::string error;
+	};
+	PropertyCache<Groups> groups_cache_;
+	/// joint values of default_pose
+	PropertyCache<std::vector<double>> compare_pose_cache_;
+	PropertyCache<kinematic_constraints::KinematicConstraintSetConstPtr> constraints_cache_;
+	/// collision prefilter, shared by all targets of a scene
+	PropertyCache<SphereCollisionFilterConstPtr> collision_filter_cache_;
+	/// separate IK solver instances for parallel sampling (expensive to create: kept across reset())
+	PropertyCache<std::vector<kinematics::KinematicsBaseConstPtr>> ik_solvers_cache_;
+
+	IKCachePtr ik_cache_;
+	/// IK cache fingerprint of the last target's scene
+	PropertyCache<std::size_t> scene_fingerprint_cache_;
+	/// IK cache lookups of this stage (since last reset), the only statistics of the cache
+	std::size_t ik_cache_hits_ = 0;
+	std::size_t ik_cache_misses_ = 0;
+
+	ReachabilityMapConstPtr reachability_map_;
+	double unreachable_timeout_ = 0.01;
+
+	/// recent IK solutions, indexed by their target poses
+	struct WarmStartIndex;
+	std::unique_ptr<WarmStartIndex> warm_start_index_;
 };
 }  // namespace stages
 }  // namespace task_constructor
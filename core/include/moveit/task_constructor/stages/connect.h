@@ -43,6 +43,8 @@
 
 #include <moveit_msgs/Constraints.h>
 
+#include <Eigen/Core>
+
 namespace moveit {
 namespace core {
 MOVEIT_CLASS_FORWARD(RobotState);
@@ -60,6 +62,12 @@ namespace stages {
  * specified order. Each planner only plan for joints within the corresponding planning group.
  * Finally, an attempt is made to merge the sub trajectories of individual planning results.
  * If this fails, the sequential planning result is returned.
+ *
+ * With parallel_planning enabled, all groups are first planned concurrently from the common start state.
+ * A planner instance shared by several groups is only called for one group at a time, unless it is
+ * thread-safe (see PlannerInterface::isThreadSafe()). If planning fails or the merged result is invalid,
+ * Connect falls back to sequential planning within the remaining time.
+ * This is useful for groups not interacting with each other, e.g. two arms.
  */
 class Connect : public Connecting
 {
@@ -75,11 +83,16 @@ public:
 
 	using GroupPlannerVector = std::vector<std::pair<std::string, solvers::PlannerInterfacePtr> >;
 	Connect(const std::string& name = "connect", const GroupPlannerVector& planners = {});
+	Stage::pointer cloneStage() const override;
 
 	void setMaxDistance(double max_distance) { setProperty("max_distance", max_distance); }
 	void setPathConstraints(moveit_msgs::Constraints path_constraints) {
 		setProperty("path_constraints", std::move(path_constraints));
 	}
+	/// number of threads validating waypoints of a merged trajectory
+	void setValidationThreads(uint32_t n) { setProperty("validation_threads", n); }
+	/// plan all groups concurrently from the start state (requires merging)
+	void setParallelPlanning(bool parallel) { setProperty("parallel_planning", parallel); }
 
 	void reset() override;
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
@@ -89,13 +102,26 @@ protected:
 	SolutionSequencePtr makeSequential(const std::vector<robot_trajectory::RobotTrajectoryConstPtr>& sub_trajectories,
 	                                   const std::vector<planning_scene::PlanningSceneConstPtr>& intermediate_scenes,
 	                                   const InterfaceState& from, const InterfaceState& to);
+	/// plan all groups concurrently from the start state and merge the result, returns false on failure
+	bool computeParallel(const InterfaceState& from, const InterfaceState& to);
 	SubTrajectoryPtr merge(const std::vector<robot_trajectory::RobotTrajectoryConstPtr>& sub_trajectories,
 	                       const std::vector<planning_scene::PlanningSceneConstPtr>& intermediate_scenes,
 	                       const moveit::core::RobotState& state);
 
 protected:
 	GroupPlannerVector planner_;
-	moveit::core::JointModelGroupPtr merged_jmg_;
+	moveit::core::JointModelGroupConstPtr merged_jmg_;
+	/// per-variable weights: 1.0 for variables not planned for (need to match), 0.0 otherwise
+	Eigen::ArrayXd unplanned_variables_mask_;
+	/// joints not planned for, only used to report deviations
+	std::vector<const moveit::core::JointModel*> unplanned_joints_;
+	/// property handles, resolved in init()
+	PropertyHandle<MergeMode> merge_mode_;
+	PropertyHandle<double> max_distance_;
+	PropertyHandle<moveit_msgs::Constraints> path_constraints_;
+	PropertyHandle<trajectory_processing::TimeParameterizationPtr> merge_time_parameterization_;
+	PropertyHandle<uint32_t> validation_threads_;
+	PropertyHandle<bool> parallel_planning_;
 	std::list<SubTrajectory> subsolutions_;
 	std::list<InterfaceState> states_;
 };
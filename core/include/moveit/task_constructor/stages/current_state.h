@@ -50,7 +50,9 @@ class CurrentState : public Generator
 {
 public:
 	CurrentState(const std::string& name = "current state");
+	Stage::pointer cloneStage() const override;
 
+	void reset() override;
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
 	bool canCompute() const override;
 	void compute() override;
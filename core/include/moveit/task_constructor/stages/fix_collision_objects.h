@@ -51,6 +51,7 @@ class FixCollisionObjects : public PropagatingEitherWay
 {
 public:
 	FixCollisionObjects(const std::string& name = "fix collisions of objects");
+	Stage::pointer cloneStage() const override;
 
 	void computeForward(const InterfaceState& from) override;
 	void computeBackward(const InterfaceState& to) override;
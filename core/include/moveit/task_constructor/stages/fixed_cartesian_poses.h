@@ -50,6 +50,7 @@ class FixedCartesianPoses : public MonitoringGenerator
 {
 public:
 	FixedCartesianPoses(const std::string& name = "generate poses");
+	Stage::pointer cloneStage() const override;
 
 	void reset() override;
 	bool canCompute() const override;
@@ -49,6 +49,7 @@ class FixedState : public Generator
 {
 public:
 	FixedState(const std::string& name = "initial state", planning_scene::PlanningScenePtr scene = nullptr);
+	Stage::pointer cloneStage() const override;
 	void setState(const planning_scene::PlanningScenePtr& scene);
 
 	void setIgnoreCollisions(bool ignore) { setProperty("ignore_collisions", ignore); }
@@ -48,6 +48,7 @@ class GenerateGraspPose : public GeneratePose
 {
 public:
 	GenerateGraspPose(const std::string& name = "generate grasp pose");
+	Stage::pointer cloneStage() const override;
 
 	void init(const core::RobotModelConstPtr& robot_model) override;
 	void compute() override;
@@ -52,6 +52,7 @@ class GeneratePlacePose : public GeneratePose
 {
 public:
 	GeneratePlacePose(const std::string& name = "place pose");
+	Stage::pointer cloneStage() const override;
 
 	void compute() override;
 
@@ -50,6 +50,7 @@ class GeneratePose : public MonitoringGenerator
 {
 public:
 	GeneratePose(const std::string& name = "generate pose");
+	Stage::pointer cloneStage() const override;
 
 	void reset() override;
 	bool canCompute() const override;
@@ -50,6 +50,7 @@ class GenerateRandomPose : public GeneratePose
 {
 public:
 	GenerateRandomPose(const std::string& name = "generate random pose");
+	Stage::pointer cloneStage() const override;
 
 	bool canCompute() const override;
 	void compute() override;
@@ -83,7 +84,11 @@ public:
 		sampleDimension(pose_dimension, getPoseDimensionSampler<RandomNumberDistribution>(width));
 	}
 
-	/** Specify a sampling function of type PoseDimensionSampler for randomizing a pose dimension. */
+	/** Specify a sampling function of type PoseDimensionSampler for randomizing a pose dimension.
+	 *
+	 * The function is shared by clones of this stage (see cloneStage()), thus needs to be thread-safe
+	 * to plan those in parallel, e.g. in a TaskBatch.
+	 */
 	void sampleDimension(const PoseDimension pose_dimension, const PoseDimensionSampler& pose_dimension_sampler) {
 		pose_dimension_samplers_.emplace_back(std::make_pair(pose_dimension, pose_dimension_sampler));
 	}
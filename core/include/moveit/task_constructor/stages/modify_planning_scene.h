@@ -68,6 +68,7 @@ public:
 	using Names = std::vector<std::string>;
 	using ApplyCallback = std::function<void(const planning_scene::PlanningScenePtr&, const PropertyMap&)>;
 	ModifyPlanningScene(const std::string& name = "modify planning scene");
+	Stage::pointer cloneStage() const override;
 
 	void computeForward(const InterfaceState& from) override;
 	void computeBackward(const InterfaceState& to) override;
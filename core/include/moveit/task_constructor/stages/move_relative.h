@@ -59,6 +59,7 @@ class MoveRelative : public PropagatingEitherWay
 public:
 	MoveRelative(const std::string& name = "move relative",
 	             const solvers::PlannerInterfacePtr& planner = solvers::PlannerInterfacePtr());
+	Stage::pointer cloneStage() const override;
 
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
 
@@ -58,6 +58,7 @@ class MoveTo : public PropagatingEitherWay
 public:
 	MoveTo(const std::string& name = "move to",
 	       const solvers::PlannerInterfacePtr& planner = solvers::PlannerInterfacePtr());
+	Stage::pointer cloneStage() const override;
 
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
 
@@ -102,6 +103,12 @@ protected:
 
 protected:
 	solvers::PlannerInterfacePtr planner_;
+
+	/// property handles, resolved in init()
+	PropertyHandle<std::string> group_;
+	PropertyHandle<boost::any> goal_;
+	PropertyHandle<geometry_msgs::PoseStamped> ik_frame_;
+	PropertyHandle<moveit_msgs::Constraints> path_constraints_;
 };
 }  // namespace stages
 }  // namespace task_constructor
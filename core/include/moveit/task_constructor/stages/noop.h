@@ -51,6 +51,11 @@ class NoOp : public PropagatingEitherWay
 {
 public:
 	NoOp(const std::string& name = "no-op") : PropagatingEitherWay(name){};
+	Stage::pointer cloneStage() const override {
+		auto copy = std::make_unique<NoOp>(name());
+		copyConfigTo(*copy);
+		return copy;
+	}
 
 private:
 	bool compute(const InterfaceState& state, planning_scene::PlanningScenePtr& scene, SubTrajectory& /*trajectory*/,
@@ -50,6 +50,7 @@ class PassThrough : public WrapperBase
 {
 public:
 	PassThrough(const std::string& name = "PassThrough", Stage::pointer&& child = Stage::pointer());
+	Stage::pointer cloneStage() const override;
 
 	void onNewSolution(const SolutionBase& s) override;
 };
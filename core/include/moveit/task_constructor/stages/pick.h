@@ -64,6 +64,9 @@ namespace stages {
  *
  * The end effector postures corresponding to pre-grasp and grasp as well as
  * the end effector's Cartesian pose needs to be provided by an external grasp stage.
+ *
+ * Clones (see cloneStage()) clone the grasp stage and copy the configuration of the Cartesian solver
+ * as well as the approach and lift stages.
  */
 class PickPlaceBase : public SerialContainer
 {
@@ -72,6 +75,11 @@ class PickPlaceBase : public SerialContainer
 	Stage* approach_stage_ = nullptr;
 	Stage* lift_stage_ = nullptr;
 
+protected:
+	Stage::pointer cloneGraspStage() const { return grasp_stage_->cloneStage(); }
+	/// copy the configuration to other, which was created from cloneGraspStage()
+	void copyPickPlaceConfigTo(PickPlaceBase& other) const;
+
 public:
 	PickPlaceBase(Stage::pointer&& grasp_stage, const std::string& name, bool forward);
 
@@ -94,6 +102,7 @@ class Pick : public PickPlaceBase
 public:
 	Pick(Stage::pointer&& grasp_stage = Stage::pointer(), const std::string& name = "pick")
 	  : PickPlaceBase(std::move(grasp_stage), name, true) {}
+	Stage::pointer cloneStage() const override;
 
 	void setApproachMotion(const geometry_msgs::TwistStamped& motion, double min_distance, double max_distance) {
 		setApproachRetract(motion, min_distance, max_distance);
@@ -111,6 +120,7 @@ class Place : public PickPlaceBase
 public:
 	Place(Stage::pointer&& ungrasp_stage = Stage::pointer(), const std::string& name = "place")
 	  : PickPlaceBase(std::move(ungrasp_stage), name, false) {}
+	Stage::pointer cloneStage() const override;
 
 	void setRetractMotion(const geometry_msgs::TwistStamped& motion, double min_distance, double max_distance) {
 		setApproachRetract(motion, min_distance, max_distance);
@@ -59,6 +59,7 @@ public:
 	using Predicate = std::function<bool(const SolutionBase&, std::string&)>;
 
 	PredicateFilter(const std::string& name, Stage::pointer&& child = Stage::pointer());
+	Stage::pointer cloneStage() const override;
 
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
 
@@ -61,6 +61,9 @@ class GenerateGraspPose;
  *
  * Grasping and UnGrasping only differs in the order of subtasks. Hence, the base class
  * provides the common functionality for grasping (forward = true) and ungrasping (forward = false).
+ *
+ * Clones (see cloneStage()) clone the IK stage, including the generator. The remaining children
+ * are configured via the container's properties only, thus are created anew.
  */
 class SimpleGraspBase : public SerialContainer
 {
@@ -68,6 +71,8 @@ class SimpleGraspBase : public SerialContainer
 
 protected:
 	void setup(std::unique_ptr<Stage>&& generator, bool forward);
+	/// copy the configuration to other, which was created without a generator
+	void copySimpleGraspConfigTo(SimpleGraspBase& other) const;
 
 public:
 	SimpleGraspBase(const std::string& name);
@@ -95,6 +100,7 @@ class SimpleGrasp : public SimpleGraspBase
 {
 public:
 	SimpleGrasp(Stage::pointer&& generator = Stage::pointer(), const std::string& name = "grasp");
+	Stage::pointer cloneStage() const override;
 };
 
 /// specialization of SimpleGraspBase to realize ungrasping
@@ -102,6 +108,7 @@ class SimpleUnGrasp : public SimpleGraspBase
 {
 public:
 	SimpleUnGrasp(Stage::pointer&& generator = Stage::pointer(), const std::string& name = "ungrasp");
+	Stage::pointer cloneStage() const override;
 };
 }  // namespace stages
 }  // namespace task_constructor
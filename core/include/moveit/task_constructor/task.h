@@ -62,6 +62,7 @@ namespace task_constructor {
 MOVEIT_CLASS_FORWARD(Stage);
 MOVEIT_CLASS_FORWARD(ContainerBase);
 MOVEIT_CLASS_FORWARD(Task);
+MOVEIT_CLASS_FORWARD(SolutionStore);
 
 class TaskPrivate;
 /** A Task is the root of a tree of stages.
@@ -82,6 +83,14 @@ public:
 	Task& operator=(Task&& other);  // NOLINT(performance-noexcept-move-constructor)
 	~Task() override;
 
+	/** Create an unplanned copy of this task, e.g. to plan variants of it in parallel (see TaskBatch)
+	 *
+	 * Stages are copied via Stage::cloneStage(), sharing immutable assets like the robot model or planners.
+	 * Monitoring generators are redirected to the copies of their monitored stages.
+	 * Introspection and task callbacks are not copied.
+	 */
+	Task clone() const;
+
 	const std::string& name() const { return stages()->name(); }
 	void setName(const std::string& name) { stages()->setName(name); }
 
@@ -120,13 +129,35 @@ public:
 	using WrapperBase::pruning;
 	using WrapperBase::setPruning;
 
-	/// reset all stages
+	/** reset all stages
+	 *
+	 * Once initialized, only the per-run state (solutions, states) is reset, keeping the initialized stage tree.
+	 * init() fully re-initializes if the configuration changed meanwhile (see fingerprint()).
+	 */
 	void reset() final;
-	/// initialize all stages with given scene
+	/// initialize all stages with given scene, unless they are initialized with the current configuration already
 	void init();
 
 	/// reset, init scene (if not yet done), and init all stages, then start planning
 	moveit::core::MoveItErrorCode plan(size_t max_solutions = 0);
+	/** Like plan(), but first try to restore stored solutions starting from start_scene
+	 *
+	 * Requires a solution store. Stored solutions of an identical task (see fingerprint()) starting from
+	 * the same scene are revalidated in start_scene and, if valid, returned without planning.
+	 * Otherwise, the task is planned as usual.
+	 */
+	moveit::core::MoveItErrorCode plan(const planning_scene::PlanningSceneConstPtr& start_scene,
+	                                   size_t max_solutions = 0);
+	/** Plan again from new_start_scene, only recomputing stage results whose inputs changed
+	 *
+	 * The first stage (a generator, e.g. CurrentState) spawns new_start_scene instead of computing.
+	 * Propagating and connecting stages replay their results of the last run for inputs with an identical
+	 * robot state, identical properties and unchanged collision objects referred to by these properties
+	 * or the stage's configuration. Replayed trajectories need to remain valid in the new scene and objects
+	 * modified by a stage (e.g. attached ones) need to be unchanged. Other stages compute as usual.
+	 */
+	moveit::core::MoveItErrorCode replan(const planning_scene::PlanningSceneConstPtr& new_start_scene,
+	                                     size_t max_solutions = 0);
 	/// interrupt current planning
 	void preempt();
 	void resetPreemptRequest();
@@ -146,6 +177,19 @@ public:
 	/// publish all top-level solutions
 	void publishAllSolutions(bool wait = true);
 
+	/// store the best solutions of each plan() in store, for later reuse (nullptr disables storing)
+	void setSolutionStore(const SolutionStorePtr& store);
+	const SolutionStorePtr& solutionStore() const;
+
+	/** Hash of the task configuration: stage tree, serializable properties, and robot model
+	 *
+	 * Properties of types without serialization, e.g. planners, are not considered:
+	 * modifying a planner instance shared by an initialized task requires a full re-initialization,
+	 * e.g. via clear() or setRobotModel().
+	 * Only meaningful after init().
+	 */
+	std::size_t fingerprint() const;
+
 	// +1 TODO: convenient access to arbitrary stage by name. traverse hierarchy using / separator?
 	/// access stage tree
 	ContainerBase* stages();
@@ -165,6 +209,7 @@ protected:
 
 private:
 	using WrapperBase::init;
+	moveit::core::MoveItErrorCode run(size_t max_solutions);
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Task& task) {
@@ -0,0 +1,82 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Parallel planning of multiple tasks, e.g. clones of a task for different targets
+ */
+
+#pragma once
+
+#include <moveit/task_constructor/task.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace moveit {
+namespace task_constructor {
+
+/** Plan a batch of independent tasks in parallel
+ *
+ * Typically, the tasks are clones of a single task (see Task::clone()), configured for different
+ * targets, e.g. alternative object placements. Each worker thread plans one task at a time.
+ * As clones share immutable assets, these need to be thread-safe, e.g. planners and cost terms.
+ */
+class TaskBatch
+{
+public:
+	/// num_threads = 0: use the number of available cores
+	explicit TaskBatch(std::size_t num_threads = 0);
+
+	/// add a task to the batch, returning its index
+	std::size_t add(Task&& task);
+	std::size_t size() const { return tasks_.size(); }
+	Task& operator[](std::size_t index) { return *tasks_.at(index); }
+	const Task& operator[](std::size_t index) const { return *tasks_.at(index); }
+
+	/** Plan all tasks, returning the result of each task
+	 *
+	 * Solutions are accessible via the individual tasks. Exceptions thrown by a task are rethrown
+	 * after all workers finished.
+	 */
+	std::vector<moveit::core::MoveItErrorCode> plan(std::size_t max_solutions = 0);
+	/// interrupt planning of all tasks
+	void preempt();
+
+private:
+	std::size_t num_threads_;
+	std::vector<std::unique_ptr<Task>> tasks_;
+	std::atomic<bool> preempt_requested_{ false };
+};
+}  // namespace task_constructor
+}  // namespace moveit
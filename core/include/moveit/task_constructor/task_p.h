@@ -59,11 +59,27 @@ public:
 	const std::string& ns() const { return ns_; }
 	const ContainerBase* stages() const;
 
+	/// key of solutions of this task starting from start_scene in the solution store
+	uint64_t solutionKey(const planning_scene::PlanningScene& start_scene) const;
+	/// store the best solutions in solution_store_
+	void storeSolutions();
+	/// restore stored solutions starting from start_scene, returning their number
+	std::size_t restoreSolutions(const planning_scene::PlanningSceneConstPtr& start_scene);
+
+	/// revalidate msgs starting from start_scene and spawn the valid ones, removing the invalid ones from msgs
+	void spawnSolutions(const planning_scene::PlanningSceneConstPtr& start_scene,
+	                    std::vector<moveit_task_constructor_msgs::Solution>& msgs);
+
 private:
 	std::string ns_;
 	robot_model_loader::RobotModelLoaderPtr robot_model_loader_;
 	moveit::core::RobotModelConstPtr robot_model_;
 	std::atomic<bool> preempt_requested_;
+	bool reset_run_only_;  // reset() keeps the initialized stage tree
+	bool replanning_;  // reset() keeps the results of stages for replaying them
+	bool initialized_;  // stage tree was initialized ...
+	std::size_t init_fingerprint_;  // ... with this configuration
+	SolutionStorePtr solution_store_;
 
 	// introspection and monitoring
 	std::unique_ptr<Introspection> introspection_;
@@ -0,0 +1,156 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Persistent, memory-mapped cache of planned trajectories
+ */
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <moveit_msgs/Constraints.h>
+#include <Eigen/Geometry>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace planning_scene {
+MOVEIT_CLASS_FORWARD(PlanningScene);
+}
+namespace moveit {
+namespace core {
+MOVEIT_CLASS_FORWARD(RobotState);
+MOVEIT_CLASS_FORWARD(JointModelGroup);
+MOVEIT_CLASS_FORWARD(LinkModel);
+}  // namespace core
+}  // namespace moveit
+namespace robot_trajectory {
+MOVEIT_CLASS_FORWARD(RobotTrajectory);
+}
+
+namespace moveit {
+namespace task_constructor {
+
+MOVEIT_CLASS_FORWARD(TrajectoryCache);
+
+/** Cache of planned trajectories, persisted in a memory-mapped file
+ *
+ * Trajectories are indexed by the group, the quantized start and goal (joint positions or target pose),
+ * the path constraints, the scene fingerprint (see IKCache::sceneFingerprint()), and the planner configuration.
+ * The cache itself doesn't validate trajectories: users should revalidate hits against
+ * the actual scene and invalidate() rejected ones (see solvers::CachedPlanner).
+ *
+ * Entries are appended to the file, which grows up to the given capacity. Beyond that, the file is
+ * compacted, evicting the oldest entries if needed, which is reported by statistics() to help sizing the cache.
+ * The cache can be shared between several planners (and threads), but not between processes.
+ */
+class TrajectoryCache
+{
+public:
+	/// serialized, quantized query
+	using Key = std::string;
+
+	struct Statistics
+	{
+		std::size_t hits = 0;  // lookups returning a trajectory
+		std::size_t misses = 0;  // lookups without a trajectory
+		std::size_t rejected = 0;  // hits invalidated by the user
+		std::size_t inserted = 0;  // trajectories stored
+		std::size_t evicted = 0;  // entries removed to make room for new ones
+		std::size_t dropped = 0;  // trajectories not stored as they exceed the capacity on their own
+		std::size_t entries = 0;  // number of valid entries
+		std::size_t size = 0;  // file size used (bytes)
+		std::size_t capacity = 0;  // max file size (bytes)
+	};
+
+	/** Open (or create) a cache file
+	 *
+	 * @param file path of the cache file, existing entries are loaded
+	 * @param capacity max size of the file (bytes)
+	 * @param resolution quantization of joint positions (rad or m) and target poses
+	 */
+	TrajectoryCache(const std::string& file, std::size_t capacity = 64 << 20, double resolution = 1e-4);
+	~TrajectoryCache();
+	TrajectoryCache(const TrajectoryCache&) = delete;
+	TrajectoryCache& operator=(const TrajectoryCache&) = delete;
+
+	/** key of a joint-space query from scene from to the state of jmg in scene to
+	 *
+	 * planner_config describes all planner settings shaping the trajectory, e.g. velocity scaling,
+	 * such that trajectories planned with other settings are not returned.
+	 */
+	Key key(const planning_scene::PlanningScene& from, const planning_scene::PlanningScene& to,
+	        const moveit::core::JointModelGroup* jmg, const moveit_msgs::Constraints& path_constraints,
+	        const std::string& planner_config = std::string()) const;
+	/// key of a query from scene from moving link to target (w.r.t. the planning frame)
+	Key key(const planning_scene::PlanningScene& from, const moveit::core::LinkModel& link,
+	        const Eigen::Isometry3d& target, const moveit::core::JointModelGroup* jmg,
+	        const moveit_msgs::Constraints& path_constraints, const std::string& planner_config = std::string()) const;
+
+	/** retrieve the trajectory of key, if any
+	 *
+	 * Waypoints are initialized from base_state, setting the positions, velocities, and accelerations of jmg.
+	 */
+	bool lookup(const Key& key, const moveit::core::RobotState& base_state, const moveit::core::JointModelGroup* jmg,
+	            robot_trajectory::RobotTrajectory& trajectory);
+	/// store the trajectory for key, replacing a previous one
+	void insert(const Key& key, const robot_trajectory::RobotTrajectory& trajectory);
+	/// drop the trajectory of key, e.g. after it failed revalidation
+	void invalidate(const Key& key);
+
+	/// remove all entries and reset the statistics
+	void clear();
+	Statistics statistics() const;
+	const std::string& file() const { return file_; }
+
+private:
+	void map(std::size_t size);
+	/// move all valid entries to the front of the file, evicting the oldest ones until size bytes are free
+	void compact(std::size_t size);
+	char* entry(std::size_t offset) const { return static_cast<char*>(mapping_) + offset; }
+
+	std::string file_;
+	std::size_t capacity_;
+	double resolution_;
+
+	mutable std::mutex mutex_;
+	int fd_ = -1;
+	void* mapping_ = nullptr;
+	std::size_t mapping_size_ = 0;
+	std::unordered_map<Key, std::size_t> index_;  // key -> offset of entry in file
+	Statistics statistics_;
+};
+}  // namespace task_constructor
+}  // namespace moveit
@@ -0,0 +1,117 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Contiguous waypoint-by-variable storage of trajectory positions
+ */
+
+#pragma once
+
+#include <moveit/macros/class_forward.h>
+#include <Eigen/Core>
+
+#include <utility>
+#include <vector>
+
+namespace moveit {
+namespace core {
+MOVEIT_CLASS_FORWARD(RobotModel);
+MOVEIT_CLASS_FORWARD(RobotState);
+MOVEIT_CLASS_FORWARD(JointModel);
+MOVEIT_CLASS_FORWARD(JointModelGroup);
+}  // namespace core
+}  // namespace moveit
+namespace robot_trajectory {
+MOVEIT_CLASS_FORWARD(RobotTrajectory);
+}
+
+namespace moveit {
+namespace task_constructor {
+
+/** Joint positions of a trajectory, stored as a contiguous waypoint-by-variable matrix
+ *
+ * Each row holds all variable positions of the robot model for one waypoint,
+ * in the layout of RobotState::getVariablePositions().
+ * Kernels operate on whole columns at once instead of visiting RobotStates one by one.
+ * Conversion from/to RobotTrajectory is only required at the boundaries.
+ */
+class TrajectoryMatrix
+{
+public:
+	using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+	/// joints considered for distances, together with their weights
+	using JointWeights = std::vector<std::pair<const moveit::core::JointModel*, double>>;
+
+	/// initialize all waypoints from state
+	TrajectoryMatrix(const moveit::core::RobotState& state, std::size_t waypoints);
+	/// copy positions of all waypoints of trajectory
+	explicit TrajectoryMatrix(const robot_trajectory::RobotTrajectory& trajectory);
+
+	/// interpolate between from and to at the given fractions, equivalent to RobotState::interpolate()
+	static TrajectoryMatrix interpolate(const moveit::core::RobotState& from, const moveit::core::RobotState& to,
+	                                    const std::vector<double>& fractions);
+
+	const moveit::core::RobotModelConstPtr& getRobotModel() const { return robot_model_; }
+	std::size_t waypoints() const { return positions_.rows(); }
+	std::size_t variables() const { return positions_.cols(); }
+
+	Matrix& positions() { return positions_; }
+	const Matrix& positions() const { return positions_; }
+	/// variable positions of a single waypoint (contiguous)
+	const double* waypoint(std::size_t index) const { return positions_.row(index).data(); }
+
+	/** overwrite the group variables of all waypoints with those of trajectory
+	 *
+	 * Waypoints beyond the end of trajectory keep the positions of its last waypoint. */
+	void assignGroupPositions(const robot_trajectory::RobotTrajectory& trajectory);
+
+	/// create a RobotTrajectory (without timing), deriving all waypoints from base_state
+	robot_trajectory::RobotTrajectoryPtr toRobotTrajectory(const moveit::core::RobotState& base_state,
+	                                                        const moveit::core::JointModelGroup* group) const;
+
+	/// weights used by RobotState::distance(): distance factors of all active joints
+	static JointWeights distanceFactors(const moveit::core::RobotModel& robot_model);
+
+	/// weighted joint-space distances between consecutive waypoints (waypoints() - 1 entries)
+	Eigen::VectorXd segmentLengths(const JointWeights& weights) const;
+	/// weighted joint-space distances of all waypoints to the reference positions
+	Eigen::VectorXd distances(const double* reference, const JointWeights& weights) const;
+
+private:
+	explicit TrajectoryMatrix(moveit::core::RobotModelConstPtr robot_model) : robot_model_(std::move(robot_model)) {}
+
+	moveit::core::RobotModelConstPtr robot_model_;
+	Matrix positions_;
+};
+}  // namespace task_constructor
+}  // namespace moveit
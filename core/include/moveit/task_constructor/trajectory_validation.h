@@ -0,0 +1,93 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Validation of trajectory waypoints with early exit, bisection ordering and threading
+ */
+
+#pragma once
+
+#include <moveit_msgs/Constraints.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace planning_scene {
+class PlanningScene;
+}
+namespace robot_trajectory {
+class RobotTrajectory;
+}
+
+namespace moveit {
+namespace task_constructor {
+
+/** Indices 0..n-1 in recursive bisection order
+ *
+ * First and last index come first, followed by the midpoints of the largest intervals not yet visited.
+ * Checking waypoints in this order finds obstacles cutting through a trajectory much earlier than
+ * sequential checking, as the sampled points are spread evenly along the path from the beginning. */
+std::vector<std::size_t> bisectionOrder(std::size_t n);
+
+struct PathValidationOptions
+{
+	enum Order
+	{
+		SEQUENTIAL,
+		BISECTION,
+	};
+
+	/// group to check for collisions, empty for the whole robot
+	std::string group;
+	/// order in which waypoints are checked, only relevant with early exit
+	Order order = BISECTION;
+	/// number of threads checking waypoints concurrently
+	unsigned int num_threads = 1;
+	/// if invalid_index is requested: find all invalid waypoints, or only the first one (allowing early exit)
+	bool find_all = true;
+};
+
+/** Check all waypoints of a trajectory for collisions, feasibility and path constraints
+ *
+ * This is a drop-in replacement for PlanningScene::isPathValid() (without goal constraints).
+ * If invalid_index is not requested, validation stops at the first invalid waypoint found.
+ * Otherwise, invalid_index lists invalid waypoints in ascending order: with options.find_all,
+ * all waypoints are checked, exactly as reported by PlanningScene::isPathValid(). Without, validation
+ * stops early and only lists the first invalid waypoint found (per thread). */
+bool isPathValid(const planning_scene::PlanningScene& scene, const robot_trajectory::RobotTrajectory& trajectory,
+                 const moveit_msgs::Constraints& path_constraints = moveit_msgs::Constraints(),
+                 const PathValidationOptions& options = PathValidationOptions(),
+                 std::vector<std::size_t>* invalid_index = nullptr);
+}  // namespace task_constructor
+}  // namespace moveit
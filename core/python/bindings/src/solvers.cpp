@@ -37,6 +37,7 @@
 #include <moveit/task_constructor/solvers/pipeline_planner.h>
 #include <moveit/task_constructor/solvers/joint_interpolation.h>
 #include <moveit/task_constructor/solvers/multi_planner.h>
+#include <moveit/task_constructor/solvers/roadmap_planner.h>
 #include <moveit/task_constructor/fmt_p.h>
 #include <moveit_msgs/WorkspaceParameters.h>
 #include "utils.h"
@@ -70,6 +71,9 @@ void export_solvers(py::module& m) {
 			)")
 	    .property<std::string>("planner", "str: Planner ID")
 	    .property<uint>("num_planning_attempts", "int: Number of planning attempts")
+	    .property<uint32_t>("num_parallel_requests",
+	                        "int: Number of requests planned in parallel, returning the cheapest solution")
+	    .property<uint32_t>("pool_size", "int: Maximum number of pipeline instances for concurrent planning (0: #cores)")
 	    .property<moveit_msgs::WorkspaceParameters>(
 	        "workspace_parameters",
 	        ":moveit_msgs:`WorkspaceParameters`: Specifies workspace box to be used for Cartesian sampling")
@@ -94,6 +98,25 @@ void export_solvers(py::module& m) {
 	    .property<double>("max_step", "float: Limit any (single) joint change between two waypoints to this amount")
 	    .def(py::init<>());
 
+	properties::class_<RoadmapPlanner, PlannerInterface>(
+	    m, "RoadmapPlanner",
+	    R"(Plan in joint space on a lazily validated roadmap, which is reused by all queries
+			of the same planning group in the same scene. Well suited for many Connect stages in a static scene. ::
+
+				from moveit.task_constructor import core
+
+				roadmapPlanner = core.RoadmapPlanner()
+				roadmapPlanner.neighbors = 10
+		)")
+	    .property<double>("max_step", "float: Max joint-space distance between waypoints")
+	    .property<unsigned int>("neighbors", "int: Number of nearest neighbors to connect new nodes to")
+	    .property<unsigned int>("samples_per_iteration", "int: Number of samples added when no path was found")
+	    .property<unsigned int>("max_nodes", "int: Max number of nodes per roadmap")
+	    .property<bool>("shortcut", "bool: Shortcut the roadmap path by straight segments")
+	    .def("save", &RoadmapPlanner::save, "Write all roadmaps to a file", "file"_a)
+	    .def("clear", &RoadmapPlanner::clear, "Remove all roadmaps")
+	    .def(py::init<>());
+
 	const moveit::core::CartesianPrecision default_precision;
 	py::class_<moveit::core::CartesianPrecision>(m, "CartesianPrecision", "precision for Cartesian interpolation")
 	    .def(py::init([](double translational, double rotational, double max_resolution) {
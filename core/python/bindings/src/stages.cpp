@@ -181,6 +181,10 @@ void export_stages(pybind11::module& m) {
 			the planning scene are allowed.
 		)")
 	    .property<double>("min_solution_distance", "reject solution that are closer than this to previously found solutions")
+	    .property<uint32_t>("num_threads", "uint: number of threads sampling IK solutions in parallel")
+	    .property<uint32_t>("batch_size", "uint: max number of upstream solutions processed per compute() call")
+	    .property<uint32_t>("warm_start_seeds", "uint: max number of seeds taken from solutions of nearby targets")
+	    .property<double>("warm_start_radius", "float: max distance of nearby targets used for warm-start seeding")
 	    .property<moveit_msgs::Constraints>("constraints", "additional constraints to obey")
 	    .property<geometry_msgs::PoseStamped>("ik_frame", R"(
 			PoseStamped_: Specify the frame with respect
@@ -317,6 +321,8 @@ void export_stages(pybind11::module& m) {
 
 			.. _Constraints: https://docs.ros.org/en/api/moveit_msgs/html/msg/Constraints.html
 		)")
+	    .property<uint32_t>("validation_threads", "number of threads validating waypoints of merged trajectories")
+	    .property<bool>("parallel_planning", "Plan all groups concurrently from the start state (requires merging)")
 	    .def(py::init<const std::string&, const Connect::GroupPlannerVector&>(),
 	         "name"_a = std::string("connect"), "planners"_a);
 
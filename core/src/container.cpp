@@ -37,6 +37,7 @@
 #include <moveit/task_constructor/container_p.h>
 #include <moveit/task_constructor/introspection.h>
 #include <moveit/task_constructor/merge.h>
+#include <moveit/task_constructor/trajectory_validation.h>
 #include <moveit/task_constructor/fmt_p.h>
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/trajectory_processing/time_optimal_trajectory_generation.h>
@@ -46,6 +47,9 @@
 #include <memory>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <queue>
+#include <thread>
 #include <boost/range/adaptor/reversed.hpp>
 #include <functional>
 
@@ -402,6 +406,11 @@ void ContainerBase::clear() {
 	pimpl()->children_.clear();
 }
 
+void ContainerBase::cloneChildrenTo(ContainerBase& other) const {
+	for (const auto& child : pimpl()->children())
+		other.add(child->cloneStage());
+}
+
 void ContainerBase::reset() {
 	auto impl = pimpl();
 
@@ -416,9 +425,11 @@ void ContainerBase::reset() {
 	impl->internalToExternalMap().clear();
 
 	// interfaces depend on children which might change
-	impl->required_interface_ = UNKNOWN;
-	impl->starts_.reset();
-	impl->ends_.reset();
+	if (!impl->resetRunOnly()) {
+		impl->required_interface_ = UNKNOWN;
+		impl->starts_.reset();
+		impl->ends_.reset();
+	}
 
 	Stage::reset();
 }
@@ -570,6 +581,13 @@ void SerialContainer::onNewSolution(const SolutionBase& current) {
 SerialContainer::SerialContainer(SerialContainerPrivate* impl) : ContainerBase(impl) {}
 SerialContainer::SerialContainer(const std::string& name) : SerialContainer(new SerialContainerPrivate(this, name)) {}
 
+Stage::pointer SerialContainer::cloneStage() const {
+	auto copy = std::make_unique<SerialContainer>(name());
+	copyConfigTo(*copy);
+	cloneChildrenTo(*copy);
+	return copy;
+}
+
 SerialContainerPrivate::SerialContainerPrivate(SerialContainer* me, const std::string& name)
   : ContainerBasePrivate(me, name) {}
 
@@ -845,6 +863,13 @@ void WrapperBase::compute() {
 	wrapped()->pimpl()->runCompute();
 }
 
+Stage::pointer Alternatives::cloneStage() const {
+	auto copy = std::make_unique<Alternatives>(name());
+	copyConfigTo(*copy);
+	cloneChildrenTo(*copy);
+	return copy;
+}
+
 bool Alternatives::canCompute() const {
 	for (const auto& stage : pimpl()->children())
 		if (stage->pimpl()->canCompute())
@@ -866,6 +891,13 @@ Fallbacks::Fallbacks(const std::string& name) : Fallbacks(new FallbacksPrivate(t
 
 Fallbacks::Fallbacks(FallbacksPrivate* impl) : ParallelContainerBase(impl) {}
 
+Stage::pointer Fallbacks::cloneStage() const {
+	auto copy = std::make_unique<Fallbacks>(name());
+	copyConfigTo(*copy);
+	cloneChildrenTo(*copy);
+	return copy;
+}
+
 void Fallbacks::reset() {
 	ParallelContainerBase::reset();
 	pimpl()->reset();
@@ -1119,6 +1151,18 @@ void MergerPrivate::resolveInterface(InterfaceFlags expected) {
 Merger::Merger(const std::string& name) : Merger(new MergerPrivate(this, name)) {
 	properties().declare<TimeParameterizationPtr>("time_parameterization",
 	                                              std::make_shared<TimeOptimalTrajectoryGeneration>());
+	properties().declare<uint32_t>("validation_threads", 1,
+	                               "number of threads validating waypoints of merged trajectories");
+	properties().declare<uint32_t>("max_merges", 0,
+	                               "maximum number of (cheapest) combinations merged per new child solution, 0: all");
+	properties().declare<uint32_t>("num_threads", 1, "number of threads merging combinations in parallel");
+}
+
+Stage::pointer Merger::cloneStage() const {
+	auto copy = std::make_unique<Merger>(name());
+	copyConfigTo(*copy);
+	cloneChildrenTo(*copy);
+	return copy;
 }
 
 void Merger::reset() {
@@ -1227,77 +1271,125 @@ void MergerPrivate::onNewGeneratorSolution(const SolutionBase& /* s */) {
 void MergerPrivate::mergeAnyCombination(const ChildSolutionMap& all_solutions, const SolutionBase& current,
                                         const planning_scene::PlanningSceneConstPtr& start_scene,
                                         const Spawner& spawner) {
-	std::vector<size_t> indices;  // which solution index was considered last for i-th child?
-	indices.reserve(children().size());
-
-	ChildSolutionList sub_solutions;
-	sub_solutions.reserve(children().size());
-
-	// initialize vector of sub solutions
+	// candidate solutions of all children, sorted by cost: the current solution is fixed for its creator
+	std::vector<ChildSolutionList> candidates;
+	candidates.reserve(all_solutions.size());
 	for (const auto& pair : all_solutions) {
-		// all children, except current solution's creator, start with zero index
-		indices.push_back(pair.first != current.creator() ? 0 : pair.second.size() - 1);
-		sub_solutions.push_back(pair.second[indices.back()]);
+		if (pair.first == current.creator()) {
+			candidates.push_back({ pair.second.back() });
+			continue;
+		}
+		candidates.push_back(pair.second);
+		std::stable_sort(candidates.back().begin(), candidates.back().end(),
+		                 [](const SubTrajectory* a, const SubTrajectory* b) { return a->cost() < b->cost(); });
 	}
-	while (true) {
-		merge(sub_solutions, start_scene, spawner);
-
-		// compose next combination
-		size_t child = 0;
-		for (auto it = all_solutions.cbegin(), end = all_solutions.cend(); it != end; ++it, ++child) {
-			if (it->first == current.creator())
-				continue;  // skip current solution's child
-			if (++indices[child] >= it->second.size()) {
-				indices[child] = 0;  // start over with zero
-				sub_solutions[child] = it->second[indices[child]];
-				continue;  // and continue with next child
-			}
-			// otherwise, a new solution combination is available
-			sub_solutions[child] = it->second[indices[child]];
-			break;
+
+	if (!jmg_merged_) {
+		std::vector<const moveit::core::JointModelGroup*> groups;
+		groups.reserve(candidates.size());
+		for (const auto& solutions : candidates)
+			groups.push_back(solutions.front()->trajectory()->getGroup());
+		try {
+			jmg_merged_ = mergedGroup(start_scene->getRobotModel(), groups);
+		} catch (const std::runtime_error& e) {
+			spawner(SubTrajectory::failure(e.what()));
+			return;
+		}
+	}
+
+	// Enumerate combinations best-first w.r.t. their summed cost (lists are sorted ascendingly).
+	// Successors increment the index of a single child, but not of a child before the one incremented last.
+	// Thus, each combination is generated exactly once.
+	struct Combination
+	{
+		double cost;
+		std::vector<size_t> indices;
+		size_t last;  // child incremented last
+	};
+	auto worse = [](const Combination& a, const Combination& b) { return a.cost > b.cost; };
+	std::priority_queue<Combination, std::vector<Combination>, decltype(worse)> queue(worse);
+
+	Combination best{ 0.0, std::vector<size_t>(candidates.size(), 0), 0 };
+	for (const auto& solutions : candidates)
+		best.cost += solutions.front()->cost();
+	queue.push(std::move(best));
+
+	const auto& props = me_->properties();
+	const uint32_t max_merges = props.get<uint32_t>("max_merges");
+	std::vector<ChildSolutionList> combinations;
+	while (!queue.empty() && (max_merges == 0 || combinations.size() < max_merges)) {
+		Combination c = queue.top();
+		queue.pop();
+
+		ChildSolutionList& sub_solutions = combinations.emplace_back();
+		sub_solutions.reserve(candidates.size());
+		for (size_t child = 0; child < candidates.size(); ++child)
+			sub_solutions.push_back(candidates[child][c.indices[child]]);
+
+		for (size_t child = c.last; child < candidates.size(); ++child) {
+			const ChildSolutionList& solutions = candidates[child];
+			const size_t index = c.indices[child];
+			if (index + 1 >= solutions.size())
+				continue;
+			Combination next{ c.cost - solutions[index]->cost() + solutions[index + 1]->cost(), c.indices, child };
+			++next.indices[child];
+			queue.push(std::move(next));
 		}
-		if (child == children().size())  // all combinations exhausted?
-			break;
 	}
+
+	// merge combinations on worker threads, but spawn the results in best-first order
+	const auto timing = props.get<TimeParameterizationPtr>("time_parameterization");
+	const auto validation_threads = props.get<uint32_t>("validation_threads");
+	std::vector<SubTrajectory> results(combinations.size());
+	std::atomic<size_t> next{ 0 };
+	auto work = [&] {
+		for (size_t i = next++; i < combinations.size(); i = next++)
+			results[i] = merge(combinations[i], start_scene, *timing, validation_threads);
+	};
+
+	const size_t num_workers = std::min<size_t>(std::max(1u, props.get<uint32_t>("num_threads")), combinations.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < num_workers; ++i)
+		threads.emplace_back(work);
+	work();
+	for (auto& thread : threads)
+		thread.join();
+
+	for (auto& result : results)
+		spawner(std::move(result));
 }
 
-void MergerPrivate::merge(const ChildSolutionList& sub_solutions,
-                          const planning_scene::PlanningSceneConstPtr& start_scene, const Spawner& spawner) {
+SubTrajectory MergerPrivate::merge(const ChildSolutionList& sub_solutions,
+                                   const planning_scene::PlanningSceneConstPtr& start_scene,
+                                   const TimeParameterization& timing, uint32_t validation_threads) const {
 	// transform vector of SubTrajectories into vector of RobotTrajectories
 	std::vector<robot_trajectory::RobotTrajectoryConstPtr> sub_trajectories;
 	sub_trajectories.reserve(sub_solutions.size());
 	for (const auto& sub : sub_solutions)
 		sub_trajectories.push_back(sub->trajectory());
 
-	moveit::core::JointModelGroup* jmg = jmg_merged_.get();
 	robot_trajectory::RobotTrajectoryPtr merged;
 	try {
-		auto timing = me_->properties().get<TimeParameterizationPtr>("time_parameterization");
-		merged = task_constructor::merge(sub_trajectories, start_scene->getCurrentState(), jmg, *timing);
+		const moveit::core::JointModelGroup* jmg = jmg_merged_.get();
+		assert(jmg);
+		merged = task_constructor::merge(sub_trajectories, start_scene->getCurrentState(), jmg, timing);
 	} catch (const std::runtime_error& e) {
-		SubTrajectory t;
-		t.markAsFailure();
-		t.setComment(e.what());
-		spawner(std::move(t));
-		return;
+		return SubTrajectory::failure(e.what());
 	}
-	if (jmg_merged_.get() != jmg)
-		jmg_merged_.reset(jmg);
-
 	assert(merged);
 	SubTrajectory t(merged);
 
-	// check merged trajectory for collisions
+	// check merged trajectory for collisions, stopping at the first invalid waypoint found by bisection
 	std::vector<std::size_t> invalid_index;
-	if (!start_scene->isPathValid(*merged, "", true, &invalid_index)) {
+	PathValidationOptions options;
+	options.num_threads = validation_threads;
+	options.find_all = false;
+	if (!isPathValid(*start_scene, *merged, moveit_msgs::Constraints(), options, &invalid_index)) {
 		t.markAsFailure();
 		std::ostringstream oss;
 		oss << "Invalid waypoint(s): ";
-		if (invalid_index.size() == merged->getWayPointCount())
-			oss << "all";
-		else
-			for (size_t i : invalid_index)
-				oss << i << ", ";
+		for (size_t i : invalid_index)
+			oss << i << ", ";
 		t.setComment(oss.str());
 	} else {
 		// accumulate costs and markers
@@ -1308,7 +1400,7 @@ void MergerPrivate::merge(const ChildSolutionList& sub_solutions,
 		}
 		t.setCost(costs);
 	}
-	spawner(std::move(t));
+	return t;
 }
 }  // namespace task_constructor
 }  // namespace moveit
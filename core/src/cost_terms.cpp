@@ -36,6 +36,7 @@
 
 #include <moveit/task_constructor/cost_terms.h>
 #include <moveit/task_constructor/stage.h>
+#include <moveit/task_constructor/trajectory_matrix.h>
 #include <moveit/task_constructor/fmt_p.h>
 
 #include <moveit/collision_detection/collision_common.h>
@@ -118,27 +119,19 @@ double PathLength::operator()(const SubTrajectory& s, std::string& /*comment*/)
 	if (traj == nullptr || traj->getWayPointCount() == 0)
 		return 0.0;
 
-	std::map<const moveit::core::JointModel*, double> weights;
-	const auto& first_waypoint = traj->getWayPoint(0);
-	for (auto& joint_weight : joints) {
-		const moveit::core::JointModel* jm = first_waypoint.getJointModel(joint_weight.first);
-		if (jm)
-			weights.emplace(jm, joint_weight.second);
-	}
-
-	double path_length{ 0.0 };
-	for (size_t i = 1; i < traj->getWayPointCount(); ++i) {
-		auto& last = traj->getWayPoint(i - 1);
-		auto& curr = traj->getWayPoint(i);
-		if (joints.empty()) {
-			path_length += last.distance(curr);
-		} else {
-			for (const auto& item : weights) {
-				path_length += item.second * last.distance(curr, item.first);
-			}
+	TrajectoryMatrix::JointWeights weights;
+	if (joints.empty())
+		weights = TrajectoryMatrix::distanceFactors(*traj->getRobotModel());
+	else {
+		const auto& first_waypoint = traj->getWayPoint(0);
+		for (auto& joint_weight : joints) {
+			const moveit::core::JointModel* jm = first_waypoint.getJointModel(joint_weight.first);
+			if (jm)
+				weights.emplace_back(jm, joint_weight.second);
 		}
 	}
-	return path_length;
+
+	return TrajectoryMatrix(*traj).segmentLengths(weights).sum();
 }
 
 DistanceToReference::DistanceToReference(const moveit_msgs::RobotState& ref, Mode m, std::map<std::string, double> w)
@@ -164,32 +157,23 @@ double DistanceToReference::operator()(const SubTrajectory& s, std::string& /*co
 	moveit::core::RobotState ref_state = state->scene()->getCurrentState();
 	moveit::core::robotStateMsgToRobotState(reference, ref_state, false);
 
-	std::map<const moveit::core::JointModel*, double> w;
-	for (auto& item : weights) {
-		const moveit::core::JointModel* jm = ref_state.getJointModel(item.first);
-		if (jm)
-			w.emplace(jm, item.second);
-	}
-
-	auto distance = [this, &ref_state, &w](const moveit::core::RobotState& state) {
-		if (weights.empty()) {
-			return ref_state.distance(state);
-		} else {
-			double accumulated = 0.0;
-			for (const auto& item : w)
-				accumulated += item.second * ref_state.distance(state, item.first);
-			return accumulated;
+	TrajectoryMatrix::JointWeights w;
+	if (weights.empty())
+		w = TrajectoryMatrix::distanceFactors(*ref_state.getRobotModel());
+	else {
+		for (auto& item : weights) {
+			const moveit::core::JointModel* jm = ref_state.getJointModel(item.first);
+			if (jm)
+				w.emplace_back(jm, item.second);
 		}
-	};
+	}
 
 	if (mode == Mode::START_INTERFACE || mode == Mode::END_INTERFACE || (mode == Mode::AUTO && (traj == nullptr))) {
-		return distance(state->scene()->getCurrentState());
+		const TrajectoryMatrix positions(state->scene()->getCurrentState(), 1);
+		return positions.distances(ref_state.getVariablePositions(), w)[0];
 	} else {
-		double accumulated = 0.0;
-		for (size_t i = 0; i < traj->getWayPointCount(); ++i)
-			accumulated += distance(traj->getWayPoint(i));
-		accumulated /= traj->getWayPointCount();
-		return accumulated;
+		const TrajectoryMatrix positions(*traj);
+		return positions.distances(ref_state.getVariablePositions(), w).sum() / traj->getWayPointCount();
 	}
 }
 
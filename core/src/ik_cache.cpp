@@ -0,0 +1,271 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/task_constructor/ik_cache.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/joint_model_group.h>
+#include <geometric_shapes/shapes.h>
+#include <octomap/octomap.h>
+
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace moveit {
+namespace task_constructor {
+
+namespace {
+constexpr double SCENE_RESOLUTION = 1e-4;
+
+inline int64_t quantize(double value, double resolution) {
+	return std::llround(value / resolution);
+}
+
+void hashPose(std::size_t& seed, const Eigen::Isometry3d& pose) {
+	for (Eigen::Index i = 0; i < 3; ++i)
+		for (Eigen::Index j = 0; j < 4; ++j)
+			boost::hash_combine(seed, quantize(pose(i, j), SCENE_RESOLUTION));
+}
+
+// hash the geometry of shape: dimensions, mesh data, or octree contents
+void hashShape(std::size_t& seed, const shapes::Shape& shape) {
+	boost::hash_combine(seed, static_cast<int>(shape.type));
+	switch (shape.type) {
+		case shapes::SPHERE:
+			boost::hash_combine(seed, static_cast<const shapes::Sphere&>(shape).radius);
+			break;
+		case shapes::CYLINDER: {
+			const auto& cylinder = static_cast<const shapes::Cylinder&>(shape);
+			boost::hash_combine(seed, cylinder.radius);
+			boost::hash_combine(seed, cylinder.length);
+			break;
+		}
+		case shapes::CONE: {
+			const auto& cone = static_cast<const shapes::Cone&>(shape);
+			boost::hash_combine(seed, cone.radius);
+			boost::hash_combine(seed, cone.length);
+			break;
+		}
+		case shapes::BOX: {
+			const auto& box = static_cast<const shapes::Box&>(shape);
+			boost::hash_range(seed, box.size, box.size + 3);
+			break;
+		}
+		case shapes::PLANE: {
+			const auto& plane = static_cast<const shapes::Plane&>(shape);
+			for (double coefficient : { plane.a, plane.b, plane.c, plane.d })
+				boost::hash_combine(seed, coefficient);
+			break;
+		}
+		case shapes::MESH: {
+			const auto& mesh = static_cast<const shapes::Mesh&>(shape);
+			boost::hash_range(seed, mesh.vertices, mesh.vertices + 3 * mesh.vertex_count);
+			boost::hash_range(seed, mesh.triangles, mesh.triangles + 3 * mesh.triangle_count);
+			break;
+		}
+		case shapes::OCTREE: {
+			// octomaps are updated in place, thus hash their (binary) contents
+			const auto& octree = static_cast<const shapes::OcTree&>(shape).octree;
+			if (octree) {
+				std::ostringstream stream;
+				octree->writeBinaryConst(stream);
+				boost::hash_combine(seed, stream.str());
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+void hashObject(std::size_t& seed, const collision_detection::World::Object& object) {
+	hashPose(seed, object.pose_);
+	boost::hash_combine(seed, object.shapes_.size());
+	for (const auto& shape : object.shapes_)
+		hashShape(seed, *shape);
+	for (const auto& shape_pose : object.shape_poses_)
+		hashPose(seed, shape_pose);
+}
+
+void hashAttachedBody(std::size_t& seed, const moveit::core::AttachedBody& body) {
+	boost::hash_combine(seed, body.getAttachedLinkName());
+	for (const auto& shape : body.getShapes())
+		hashShape(seed, *shape);
+	for (const auto& shape_pose : body.getShapePosesInLinkFrame())
+		hashPose(seed, shape_pose);
+}
+}  // namespace
+
+IKCache::IKCache(double position_resolution, double orientation_resolution, std::size_t capacity)
+  : position_resolution_(position_resolution), orientation_resolution_(orientation_resolution), capacity_(capacity) {}
+
+IKCache::Key IKCache::key(std::size_t scene_fingerprint, const moveit::core::JointModelGroup* jmg,
+                          const moveit::core::LinkModel* link, const Eigen::Isometry3d& pose) const {
+	Key key;
+	key.group = jmg->getName();
+	key.link = link->getName();
+
+	const Eigen::Vector3d& p = pose.translation();
+	Eigen::Quaterniond q(pose.linear());
+	if (q.w() < 0)  // q and -q represent the same orientation
+		q.coeffs() *= -1.0;
+	key.pose = { quantize(p.x(), position_resolution_),    quantize(p.y(), position_resolution_),
+		          quantize(p.z(), position_resolution_),    quantize(q.x(), orientation_resolution_),
+		          quantize(q.y(), orientation_resolution_), quantize(q.z(), orientation_resolution_),
+		          quantize(q.w(), orientation_resolution_) };
+	key.scene = scene_fingerprint;
+	return key;
+}
+
+std::size_t IKCache::sceneFingerprint(const planning_scene::PlanningScene& scene,
+                                      const moveit::core::JointModelGroup* jmg) {
+	std::size_t seed = 0;
+
+	// collision objects (World is an ordered map, thus iteration order is well defined)
+	for (const auto& object_pair : *scene.getWorld()) {
+		boost::hash_combine(seed, object_pair.first);
+		hashObject(seed, *object_pair.second);
+	}
+
+	// attached bodies (sorted by name, as they are stored in an unordered map)
+	const moveit::core::RobotState& state = scene.getCurrentState();
+	std::vector<const moveit::core::AttachedBody*> attached;
+	state.getAttachedBodies(attached);
+	std::sort(attached.begin(), attached.end(),
+	          [](const auto* a, const auto* b) { return a->getName() < b->getName(); });
+	for (const moveit::core::AttachedBody* body : attached) {
+		boost::hash_combine(seed, body->getName());
+		hashAttachedBody(seed, *body);
+	}
+
+	// allowed collisions (entry names are sorted to obtain a well defined order)
+	const collision_detection::AllowedCollisionMatrix& acm = scene.getAllowedCollisionMatrix();
+	std::vector<std::string> names;
+	acm.getAllEntryNames(names);
+	std::sort(names.begin(), names.end());
+	collision_detection::AllowedCollision::Type type;
+	for (std::size_t i = 0; i < names.size(); ++i)
+		for (std::size_t j = i; j < names.size(); ++j)
+			if (acm.getEntry(names[i], names[j], type)) {
+				boost::hash_combine(seed, names[i]);
+				boost::hash_combine(seed, names[j]);
+				boost::hash_combine(seed, static_cast<int>(type));
+			}
+
+	// padding and scaling of links (maps are ordered by link name)
+	const collision_detection::CollisionEnvConstPtr& env = scene.getCollisionEnv();
+	for (const auto& link_padding : env->getLinkPadding()) {
+		boost::hash_combine(seed, link_padding.first);
+		boost::hash_combine(seed, link_padding.second);
+	}
+	for (const auto& link_scale : env->getLinkScale()) {
+		boost::hash_combine(seed, link_scale.first);
+		boost::hash_combine(seed, link_scale.second);
+	}
+
+	// joints outside the group (those inside are determined by IK)
+	const moveit::core::RobotModel& robot_model = *state.getRobotModel();
+	std::vector<bool> in_group(robot_model.getVariableCount(), false);
+	if (jmg)
+		for (int index : jmg->getVariableIndexList())
+			in_group[index] = true;
+	for (std::size_t i = 0; i < in_group.size(); ++i)
+		if (!in_group[i])
+			boost::hash_combine(seed, quantize(state.getVariablePosition(i), SCENE_RESOLUTION));
+
+	return seed;
+}
+
+std::size_t IKCache::objectFingerprint(const planning_scene::PlanningScene& scene, const std::string& id) {
+	std::size_t seed = 0;
+	if (const auto& object = scene.getWorld()->getObject(id)) {
+		boost::hash_combine(seed, 1);
+		hashObject(seed, *object);
+	} else if (const moveit::core::AttachedBody* body = scene.getCurrentState().getAttachedBody(id)) {
+		boost::hash_combine(seed, 2);
+		hashAttachedBody(seed, *body);
+	}
+	return seed;
+}
+
+std::size_t IKCache::KeyHash::operator()(const Key& key) const {
+	std::size_t seed = key.scene;
+	boost::hash_combine(seed, key.group);
+	boost::hash_combine(seed, key.link);
+	boost::hash_range(seed, key.pose.begin(), key.pose.end());
+	return seed;
+}
+
+IKCache::Solutions IKCache::lookup(const Key& key) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = index_.find(key);
+	if (it == index_.end())
+		return {};
+	entries_.splice(entries_.begin(), entries_, it->second);  // mark as most recently used
+	return it->second->second;
+}
+
+void IKCache::insert(const Key& key, Solutions solutions) {
+	if (capacity_ == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = index_.find(key);
+	if (it != index_.end()) {
+		it->second->second = std::move(solutions);
+		entries_.splice(entries_.begin(), entries_, it->second);
+		return;
+	}
+
+	entries_.emplace_front(key, std::move(solutions));
+	index_.emplace(key, entries_.begin());
+	if (entries_.size() > capacity_) {  // drop least recently used entry
+		index_.erase(entries_.back().first);
+		entries_.pop_back();
+	}
+}
+
+void IKCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_.clear();
+	index_.clear();
+}
+
+std::size_t IKCache::size() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return entries_.size();
+}
+}  // namespace task_constructor
+}  // namespace moveit
@@ -225,6 +225,13 @@ void Introspection::fillStageStatistics(const Stage& stage, moveit_task_construc
 
 	s.total_compute_time = stage.getTotalComputeTime();
 	s.num_failed = stage.numFailures();
+
+	std::map<std::string, double> stats;
+	stage.statistics(stats);
+	for (const auto& stat : stats) {
+		s.statistics_names.push_back(stat.first);
+		s.statistics_values.push_back(stat.second);
+	}
 }
 
 moveit_task_constructor_msgs::TaskDescription&
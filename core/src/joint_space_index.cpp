@@ -0,0 +1,221 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/task_constructor/joint_space_index.h>
+
+#include <moveit/robot_model/joint_model_group.h>
+#include <moveit/robot_model/revolute_joint_model.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace moveit {
+namespace task_constructor {
+
+JointSpaceIndex::JointSpaceIndex(const moveit::core::JointModelGroup* jmg)
+  : jmg_(jmg), dimension_(jmg->getVariableCount()) {
+	for (const moveit::core::JointModel* joint : jmg->getActiveJointModels()) {
+		bool bounded = false;
+		switch (joint->getType()) {
+			case moveit::core::JointModel::PRISMATIC:
+				bounded = true;
+				break;
+			case moveit::core::JointModel::REVOLUTE:
+				bounded = !static_cast<const moveit::core::RevoluteJointModel*>(joint)->isContinuous();
+				break;
+			default:
+				break;
+		}
+		if (bounded && joint->getDistanceFactor() > 0)
+			axes_.push_back(Axis{ static_cast<std::size_t>(jmg->getVariableGroupIndex(joint->getName())),
+			                      joint->getDistanceFactor() });
+	}
+}
+
+void JointSpaceIndex::clear() {
+	nodes_.clear();
+	data_.clear();
+}
+
+std::size_t JointSpaceIndex::insert(const double* positions) {
+	const std::size_t index = nodes_.size();
+	data_.insert(data_.end(), positions, positions + dimension_);
+	nodes_.emplace_back();
+	if (axes_.empty() || index == 0) {
+		nodes_.back().axis = 0;
+		return index;  // no splitting: a linear list suffices
+	}
+
+	// descend to leaf, cycling through axes
+	std::size_t current = 0;
+	while (true) {
+		Node& node = nodes_[current];
+		const Axis& axis = axes_[node.axis];
+		const int side = positions[axis.variable] >= (*this)[current][axis.variable];
+		if (node.children[side] == NONE) {
+			node.children[side] = index;
+			nodes_[index].axis = (node.axis + 1) % axes_.size();
+			return index;
+		}
+		current = node.children[side];
+	}
+}
+
+bool JointSpaceIndex::withinDistance(const double* positions, double radius) const {
+	if (nodes_.empty() || radius <= 0)
+		return false;
+	if (axes_.empty()) {  // linear search
+		for (std::size_t i = 0; i < nodes_.size(); ++i)
+			if (jmg_->distance(positions, (*this)[i]) < radius)
+				return true;
+		return false;
+	}
+
+	std::vector<std::size_t> stack{ 0 };
+	while (!stack.empty()) {
+		const std::size_t current = stack.back();
+		stack.pop_back();
+		const double* point = (*this)[current];
+		if (jmg_->distance(positions, point) < radius)
+			return true;
+
+		const Node& node = nodes_[current];
+		const Axis& axis = axes_[node.axis];
+		const double diff = positions[axis.variable] - point[axis.variable];
+		const int side = diff >= 0;
+		// the other side contains configurations at least weight * |diff| away
+		if (node.children[1 - side] != NONE && axis.weight * std::abs(diff) < radius)
+			stack.push_back(node.children[1 - side]);
+		if (node.children[side] != NONE)
+			stack.push_back(node.children[side]);
+	}
+	return false;
+}
+
+std::size_t JointSpaceIndex::nearest(const double* positions, double* distance) const {
+	std::size_t best = nodes_.size();
+	double best_distance = std::numeric_limits<double>::infinity();
+
+	if (axes_.empty()) {  // linear search
+		for (std::size_t i = 0; i < nodes_.size(); ++i) {
+			double d = jmg_->distance(positions, (*this)[i]);
+			if (d < best_distance) {
+				best_distance = d;
+				best = i;
+			}
+		}
+	} else if (!nodes_.empty()) {
+		// stack of nodes to visit, together with the lower bound of their distance
+		std::vector<std::pair<std::size_t, double>> stack{ { 0, 0.0 } };
+		while (!stack.empty()) {
+			const auto [current, bound] = stack.back();
+			stack.pop_back();
+			if (bound >= best_distance)
+				continue;
+
+			const double* point = (*this)[current];
+			double d = jmg_->distance(positions, point);
+			if (d < best_distance) {
+				best_distance = d;
+				best = current;
+			}
+
+			const Node& node = nodes_[current];
+			const Axis& axis = axes_[node.axis];
+			const double diff = positions[axis.variable] - point[axis.variable];
+			const int side = diff >= 0;
+			if (node.children[1 - side] != NONE)
+				stack.emplace_back(node.children[1 - side], std::max(bound, axis.weight * std::abs(diff)));
+			if (node.children[side] != NONE)  // visit near side first
+				stack.emplace_back(node.children[side], bound);
+		}
+	}
+
+	if (distance)
+		*distance = best_distance;
+	return best;
+}
+
+std::vector<std::pair<double, std::size_t>> JointSpaceIndex::nearestK(const double* positions, std::size_t k) const {
+	using Candidate = std::pair<double, std::size_t>;
+	std::priority_queue<Candidate> best;  // max-heap of the k nearest configurations found so far
+	auto consider = [&](std::size_t i) {
+		const double d = jmg_->distance(positions, (*this)[i]);
+		if (best.size() < k)
+			best.emplace(d, i);
+		else if (d < best.top().first) {
+			best.pop();
+			best.emplace(d, i);
+		}
+	};
+	auto worst = [&]() { return best.size() < k ? std::numeric_limits<double>::infinity() : best.top().first; };
+
+	if (k == 0)
+		return {};
+	if (axes_.empty()) {  // linear search
+		for (std::size_t i = 0; i < nodes_.size(); ++i)
+			consider(i);
+	} else if (!nodes_.empty()) {
+		std::vector<std::pair<std::size_t, double>> stack{ { 0, 0.0 } };
+		while (!stack.empty()) {
+			const auto [current, bound] = stack.back();
+			stack.pop_back();
+			if (bound >= worst())
+				continue;
+
+			consider(current);
+
+			const double* point = (*this)[current];
+			const Node& node = nodes_[current];
+			const Axis& axis = axes_[node.axis];
+			const double diff = positions[axis.variable] - point[axis.variable];
+			const int side = diff >= 0;
+			if (node.children[1 - side] != NONE)
+				stack.emplace_back(node.children[1 - side], std::max(bound, axis.weight * std::abs(diff)));
+			if (node.children[side] != NONE)  // visit near side first
+				stack.emplace_back(node.children[side], bound);
+		}
+	}
+
+	std::vector<Candidate> result(best.size());
+	for (auto it = result.rbegin(); it != result.rend(); ++it) {
+		*it = best.top();
+		best.pop();
+	}
+	return result;
+}
+}  // namespace task_constructor
+}  // namespace moveit
@@ -36,29 +36,75 @@
 /* Authors: Luca Lach, Robert Haschke */
 
 #include <moveit/task_constructor/merge.h>
+#include <moveit/task_constructor/trajectory_matrix.h>
 
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/algorithm/string/join.hpp>
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
 namespace {
+// active joints occurring in more than one group, in order of their second occurrence
 std::vector<const moveit::core::JointModel*>
-findDuplicates(const std::vector<const moveit::core::JointModelGroup*>& groups,
-               std::vector<const moveit::core::JointModel*> joints) {
+findDuplicates(const std::vector<const moveit::core::JointModelGroup*>& groups) {
 	std::vector<const moveit::core::JointModel*> duplicates;
+	std::unordered_set<const moveit::core::JointModel*> seen, reported;
 	for (const moveit::core::JointModelGroup* jmg : groups) {
 		for (const moveit::core::JointModel* jm : jmg->getJointModels()) {
-			auto it = std::find(joints.begin(), joints.end(), jm);
-			if (it == joints.end()) {  // jm not found anymore -> duplicate
-				if (jm->getType() == moveit::core::JointModel::FIXED || jm->getMimic())
-					continue;  // fixed joints and mimic joints are OK
-				if (std::find(duplicates.begin(), duplicates.end(), jm) == duplicates.end())
-					duplicates.push_back(jm);  // add to duplicates only once
-			} else
-				joints.erase(it);  // remove from list as processed
+			if (seen.insert(jm).second)
+				continue;  // first occurrence
+			if (jm->getType() == moveit::core::JointModel::FIXED || jm->getMimic())
+				continue;  // fixed joints and mimic joints are OK
+			if (reported.insert(jm).second)
+				duplicates.push_back(jm);  // add to duplicates only once
 		}
 	}
 	return duplicates;
 }
+
+// merged groups of all robot models, indexed by the sorted names of their groups
+class MergedGroupRegistry
+{
+	using GroupMap = std::map<std::vector<std::string>, moveit::core::JointModelGroupConstPtr>;
+	std::mutex mutex_;
+	std::map<std::weak_ptr<const moveit::core::RobotModel>, GroupMap,
+	         std::owner_less<std::weak_ptr<const moveit::core::RobotModel>>>
+	    models_;
+
+public:
+	static MergedGroupRegistry& instance() {
+		static MergedGroupRegistry registry;
+		return registry;
+	}
+
+	moveit::core::JointModelGroupConstPtr get(const moveit::core::RobotModelConstPtr& robot_model,
+	                                          std::vector<const moveit::core::JointModelGroup*> groups) {
+		std::sort(groups.begin(), groups.end(),
+		          [](const auto* a, const auto* b) { return a->getName() < b->getName(); });
+		std::vector<std::string> key;
+		key.reserve(groups.size());
+		for (const moveit::core::JointModelGroup* jmg : groups)
+			key.push_back(jmg->getName());
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		// drop groups of robot models that don't exist anymore
+		for (auto it = models_.begin(); it != models_.end();)
+			it = it->first.expired() ? models_.erase(it) : std::next(it);
+
+		GroupMap& merged_groups = models_[robot_model];
+		auto it = merged_groups.find(key);
+		if (it == merged_groups.end())  // construct only once, throws on overlapping groups
+			it = merged_groups
+			         .emplace(std::move(key),
+			                  moveit::core::JointModelGroupConstPtr(moveit::task_constructor::merge(groups)))
+			         .first;
+		return it->second;
+	}
+};
 }  // namespace
 
 namespace moveit {
@@ -86,9 +132,12 @@ moveit::core::JointModelGroup* merge(const std::vector<const moveit::core::Joint
 		merged_group_name.append(jmg->getName());
 	}
 
+	// deterministic joint order, independent of memory layout
 	std::vector<const moveit::core::JointModel*> joints(jset.cbegin(), jset.cend());
+	std::sort(joints.begin(), joints.end(),
+	          [](const auto* a, const auto* b) { return a->getJointIndex() < b->getJointIndex(); });
 	if (joints.size() != sum_joints) {  // overlapping joint groups: analyse in more detail
-		auto duplicates = findDuplicates(groups, joints);
+		auto duplicates = findDuplicates(groups);
 		if (!duplicates.empty()) {
 			// NOLINTNEXTLINE(readability-identifier-naming): getJointName is a function (variable)
 			auto getJointName = boost::adaptors::transformed([](auto&& jm) { return jm->getName(); });
@@ -103,25 +152,32 @@ moveit::core::JointModelGroup* merge(const std::vector<const moveit::core::Joint
 	return new moveit::core::JointModelGroup(merged_group_name, dummy_srdf, joints, robot_model);
 }
 
+moveit::core::JointModelGroupConstPtr mergedGroup(const moveit::core::RobotModelConstPtr& robot_model,
+                                                  const std::vector<const moveit::core::JointModelGroup*>& groups) {
+	for (const moveit::core::JointModelGroup* jmg : groups)
+		if (&jmg->getParentModel() != robot_model.get())
+			throw std::runtime_error("groups refer to different robot models");
+	return MergedGroupRegistry::instance().get(robot_model, groups);
+}
+
 robot_trajectory::RobotTrajectoryPtr
 merge(const std::vector<robot_trajectory::RobotTrajectoryConstPtr>& sub_trajectories,
-      const moveit::core::RobotState& base_state, moveit::core::JointModelGroup*& merged_group,
+      const moveit::core::RobotState& base_state, const moveit::core::JointModelGroup*& merged_group,
       const trajectory_processing::TimeParameterization& time_parameterization) {
 	if (sub_trajectories.size() <= 1)
 		throw std::runtime_error("Expected multiple sub solutions");
 
-	if (!merged_group) {  // create (and return) a merged group if not yet done
+	if (!merged_group) {  // fetch (and return) the shared merged group if not yet done
 		std::vector<const moveit::core::JointModelGroup*> groups;
 		groups.reserve(sub_trajectories.size());
 		for (const auto& sub : sub_trajectories)
 			groups.push_back(sub->getGroup());
-		merged_group = merge(groups);
+		merged_group = mergedGroup(base_state.getRobotModel(), groups).get();
 	}
-	const std::vector<const moveit::core::JointModel*>* merged_joints = &merged_group->getJointModels();
 
 	// sanity checks: all sub solutions must share the same robot model and use disjoint joint sets
 	const moveit::core::RobotModelConstPtr& robot_model = base_state.getRobotModel();
-	unsigned int max_num_vars = 0;  // maximum number of joint variables across sub groups
+	std::size_t num_waypoints = 0;  // maximum number of waypoints across sub solutions
 	for (const robot_trajectory::RobotTrajectoryConstPtr& sub : sub_trajectories) {
 		if (sub->getRobotModel() != robot_model)
 			throw std::runtime_error("subsolutions refer to multiple robot models");
@@ -130,40 +186,18 @@ merge(const std::vector<robot_trajectory::RobotTrajectoryConstPtr>& sub_trajecto
 		const auto& joints = jmg->getJointModels();
 		// validate that the joint model is known
 		for (const moveit::core::JointModel* jm : joints) {
-			if (std::find(merged_joints->cbegin(), merged_joints->cend(), jm) == merged_joints->cend())
+			if (!merged_group->hasJointModel(jm->getName()))
 				throw std::runtime_error("subsolutions refers to unknown joint: " + jm->getName());
 		}
-		max_num_vars = std::max(max_num_vars, jmg->getVariableCount());
+		num_waypoints = std::max(num_waypoints, sub->getWayPointCount());
 	}
 
-	// do the actual trajectory merging
-	auto merged_traj = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, merged_group);
-	std::vector<double> values;
-	values.reserve(max_num_vars);
-
-	auto merged_state = std::make_shared<moveit::core::RobotState>(base_state);
-	while (true) {
-		bool finished = true;
-		size_t index = merged_traj->getWayPointCount();
-
-		for (const robot_trajectory::RobotTrajectoryConstPtr& sub : sub_trajectories) {
-			if (index >= sub->getWayPointCount())
-				continue;  // no more waypoints in this sub solution
-
-			finished = false;  // there was a waypoint, continue while loop
-			const moveit::core::RobotState& sub_state = sub->getWayPoint(index);
-			sub_state.copyJointGroupPositions(sub->getGroup(), values);
-			merged_state->setJointGroupPositions(sub->getGroup(), values);
-		}
-		if (finished)
-			break;
-
-		merged_state->update();
-		// add waypoint without timing
-		merged_traj->addSuffixWayPoint(merged_state, 0.0);
-		// create new RobotState for next waypoint
-		merged_state = std::make_shared<moveit::core::RobotState>(*merged_state);
-	}
+	// do the actual trajectory merging on a contiguous waypoint x variable matrix:
+	// sub solutions that finished early hold their last waypoint
+	TrajectoryMatrix positions(base_state, num_waypoints);
+	for (const robot_trajectory::RobotTrajectoryConstPtr& sub : sub_trajectories)
+		positions.assignGroupPositions(*sub);
+	auto merged_traj = positions.toRobotTrajectory(base_state, merged_group);
 
 	// add timing
 	time_parameterization.computeTimeStamps(*merged_traj, 1.0, 1.0);
@@ -39,6 +39,7 @@
 #include <moveit/task_constructor/properties.h>
 #include <moveit/task_constructor/fmt_p.h>
 #include <functional>
+#include <atomic>
 #include <ros/console.h>
 
 namespace moveit {
@@ -53,6 +54,7 @@ class PropertyTypeRegistry
 		std::string name_;
 		PropertySerializerBase::SerializeFunction serialize_;
 		PropertySerializerBase::DeserializeFunction deserialize_;
+		PropertySerializerBase::EqualFunction equal_;
 	};
 	Entry dummy_;
 
@@ -65,10 +67,11 @@ class PropertyTypeRegistry
 
 public:
 	PropertyTypeRegistry()
-	  : dummy_{ "", PropertySerializerBase::dummySerialize, PropertySerializerBase::dummyDeserialize } {}
+	  : dummy_{ "", PropertySerializerBase::dummySerialize, PropertySerializerBase::dummyDeserialize, nullptr } {}
 	inline bool insert(const std::type_index& type_index, const std::string& type_name,
 	                   PropertySerializerBase::SerializeFunction serialize,
-	                   PropertySerializerBase::DeserializeFunction deserialize);
+	                   PropertySerializerBase::DeserializeFunction deserialize,
+	                   PropertySerializerBase::EqualFunction equal);
 
 	const Entry& entry(const std::type_index& type_index) const {
 		auto it = types_.find(type_index);
@@ -79,6 +82,11 @@ public:
 		}
 		return it->second;
 	}
+	/// entry of type_index, nullptr if unregistered
+	const Entry* find(const std::type_index& type_index) const {
+		auto it = types_.find(type_index);
+		return it == types_.end() ? nullptr : &it->second;
+	}
 	const Entry& entry(const std::string& type_name) const {
 		auto it = names_.find(type_name);
 		if (it == names_.end())
@@ -90,11 +98,12 @@ static PropertyTypeRegistry REGISTRY_SINGLETON;
 
 bool PropertyTypeRegistry::insert(const std::type_index& type_index, const std::string& type_name,
                                   PropertySerializerBase::SerializeFunction serialize,
-                                  PropertySerializerBase::DeserializeFunction deserialize) {
+                                  PropertySerializerBase::DeserializeFunction deserialize,
+                                  PropertySerializerBase::EqualFunction equal) {
 	if (type_index == std::type_index(typeid(boost::any)))
 		return false;
 
-	auto it_inserted = types_.insert(std::make_pair(type_index, Entry{ type_name, serialize, deserialize }));
+	auto it_inserted = types_.insert(std::make_pair(type_index, Entry{ type_name, serialize, deserialize, equal }));
 	if (!it_inserted.second)
 		return false;  // was already registered before
 
@@ -106,17 +115,33 @@ bool PropertyTypeRegistry::insert(const std::type_index& type_index, const std::
 
 bool PropertySerializerBase::insert(const std::type_index& type_index, const std::string& type_name,
                                     PropertySerializerBase::SerializeFunction serialize,
-                                    PropertySerializerBase::DeserializeFunction deserialize) {
-	return REGISTRY_SINGLETON.insert(type_index, type_name, serialize, deserialize);
+                                    PropertySerializerBase::DeserializeFunction deserialize,
+                                    PropertySerializerBase::EqualFunction equal) {
+	return REGISTRY_SINGLETON.insert(type_index, type_name, serialize, deserialize, equal);
 }
 
 Property::Property(const type_info& type_info, const std::string& description, const boost::any& default_value)
   : description_(description), type_info_(type_info), default_(default_value), value_(), initialized_from_(-1) {
 	// default value's type should match declared type by construction
 	assert(default_.empty() || default_.type() == type_info_ || type_info_ == typeid(boost::any));
+	updateVersion();
 	reset();
 }
 
+void Property::updateVersion() {
+	static std::atomic<Version> counter{ 0 };
+	version_ = ++counter;
+}
+
+bool Property::equal(const boost::any& a, const boost::any& b) {
+	if (a.empty() || b.empty())
+		return a.empty() && b.empty();
+	if (a.type() != b.type())
+		return false;
+	const auto* entry = REGISTRY_SINGLETON.find(a.type());
+	return entry && entry->equal_ && entry->equal_(a, b);
+}
+
 Property::Property() : Property(typeid(boost::any), "", boost::any()) {}
 
 void Property::setValue(const boost::any& value) {
@@ -129,24 +154,41 @@ void Property::setCurrentValue(const boost::any& value) {
 	if (!value.empty() && type_info_ != typeid(boost::any) && value.type() != type_info_)
 		throw Property::type_error(value.type().name(), type_info_.name());
 
+	// only a change of the effective value (current or default) yields a new version
+	const bool changed = !equal(this->value(), value.empty() ? default_ : value);
 	value_ = value;
 	initialized_from_ = 1;  // manually initialized TODO: use enums
+	if (changed)
+		updateVersion();
 }
 
 void Property::setDefaultValue(const boost::any& value) {
 	if (!value.empty() && type_info_ != typeid(boost::any) && value.type() != type_info_)
 		throw Property::type_error(value.type().name(), type_info_.name());
 
+	const bool changed = value_.empty() && !equal(default_, value);
 	default_ = value;
+	if (changed)
+		updateVersion();
 }
 
 void Property::reset() {
 	if (initialized_from_ == 0)  // TODO: use enum
 		return;  // keep manually set values
-	boost::any().swap(value_);
+	if (!value_.empty()) {
+		const bool changed = !equal(value_, default_);
+		boost::any().swap(value_);
+		if (changed)
+			updateVersion();
+	}
 	initialized_from_ = -1;  // set to max value
 }
 
+void Property::reset(SourceFlags sources) {
+	if (defined() && (initialized_from_ & sources))
+		reset();
+}
+
 std::string Property::serialize(const boost::any& value) {
 	if (value.empty())
 		return "";
@@ -191,9 +233,54 @@ Property& Property::configureInitFrom(SourceFlags source, const std::string& nam
 	return configureInitFrom(source, [name](const PropertyMap& other) { return fromName(other, name); });
 }
 
+PropertyMap::PropertyMap(const PropertyMap& other)
+  : props_(other.shareable_ || !other.props_ ? other.props_ : std::make_shared<container_type>(*other.props_)) {}
+
+namespace {
+void checkNoHandles(const std::shared_ptr<const void>& handles) {
+	if (handles.use_count() > 1)
+		throw Property::error("cannot assign to a PropertyMap with resolved property handles");
+}
+}  // namespace
+
+PropertyMap& PropertyMap::operator=(const PropertyMap& other) {
+	if (this != &other) {
+		checkNoHandles(handles_);
+		props_ = other.shareable_ || !other.props_ ? other.props_ : std::make_shared<container_type>(*other.props_);
+		shareable_ = true;
+		handles_.reset();
+	}
+	return *this;
+}
+
+PropertyMap& PropertyMap::operator=(PropertyMap&& other) {
+	if (this != &other) {
+		checkNoHandles(handles_);
+		// handles of other remain valid: they refer to the moved container
+		props_ = std::move(other.props_);
+		shareable_ = other.shareable_;
+		handles_ = std::move(other.handles_);
+		other.shareable_ = true;
+	}
+	return *this;
+}
+
+const PropertyMap::container_type& PropertyMap::emptyProps() {
+	static const container_type EMPTY;
+	return EMPTY;
+}
+
+PropertyMap::container_type& PropertyMap::mutableProps() {
+	if (!props_)
+		props_ = std::make_shared<container_type>();
+	else if (props_.use_count() > 1)  // shared with other copies: detach
+		props_ = std::make_shared<container_type>(*props_);
+	return *props_;
+}
+
 Property& PropertyMap::declare(const std::string& name, const Property::type_info& type_info,
                                const std::string& description, const boost::any& default_value) {
-	auto it_inserted = props_.insert(std::make_pair(name, Property(type_info, description, default_value)));
+	auto it_inserted = mutableProps().insert(std::make_pair(name, Property(type_info, description, default_value)));
 	// if name was already declared, the new declaration should match in type (except it was boost::any)
 	if (!it_inserted.second && it_inserted.first->second.type_info_ != typeid(boost::any) &&
 	    type_info != it_inserted.first->second.type_info_)
@@ -202,13 +289,22 @@ Property& PropertyMap::declare(const std::string& name, const Property::type_inf
 }
 
 bool PropertyMap::hasProperty(const std::string& name) const {
-	auto it = props_.find(name);
-	return it != props_.end();
+	const auto& props = this->props();
+	return props.find(name) != props.end();
 }
 
 Property& PropertyMap::property(const std::string& name) {
-	auto it = props_.find(name);
-	if (it == props_.end())
+	auto& props = leakProps();
+	auto it = props.find(name);
+	if (it == props.end())
+		throw Property::undeclared(name);
+	return it->second;
+}
+
+const Property& PropertyMap::property(const std::string& name) const {
+	const auto& props = this->props();
+	auto it = props.find(name);
+	if (it == props.end())
 		throw Property::undeclared(name);
 	return it->second;
 }
@@ -224,7 +320,7 @@ void PropertyMap::exposeTo(PropertyMap& other, const std::string& name, const st
 }
 
 void PropertyMap::configureInitFrom(Property::SourceFlags source, const std::set<std::string>& properties) {
-	for (auto& pair : props_) {
+	for (auto& pair : mutableProps()) {
 		if (properties.empty() || properties.count(pair.first))
 			try {
 				pair.second.configureInitFrom(source, std::bind(&fromName, std::placeholders::_1, pair.first));
@@ -237,18 +333,23 @@ void PropertyMap::configureInitFrom(Property::SourceFlags source, const std::set
 
 template <>
 void PropertyMap::set<boost::any>(const std::string& name, const boost::any& value) {
-	auto range = props_.equal_range(name);
+	auto& props = mutableProps();
+	auto range = props.equal_range(name);
 	if (range.first == range.second) {  // name is not yet declared
 		if (value.empty())
 			throw Property::undeclared(name, "trying to set undeclared property '" + name + "' with NULL value");
-		auto it = props_.insert(range.first, std::make_pair(name, Property(value.type(), "", boost::any())));
+		auto it = props.insert(range.first, std::make_pair(name, Property(value.type(), "", boost::any())));
 		it->second.setValue(value);
 	} else
 		range.first->second.setValue(value);
 }
 
 void PropertyMap::setCurrent(const std::string& name, const boost::any& value) {
-	property(name).setCurrentValue(value);
+	auto& props = mutableProps();
+	auto it = props.find(name);
+	if (it == props.end())
+		throw Property::undeclared(name);
+	it->second.setCurrentValue(value);
 }
 
 const boost::any& PropertyMap::get(const std::string& name) const {
@@ -265,12 +366,23 @@ size_t PropertyMap::countDefined(const std::vector<std::string>& list) const {
 }
 
 void PropertyMap::reset() {
-	for (auto& pair : props_)
+	if (!props_)
+		return;
+	for (auto& pair : mutableProps())
 		pair.second.reset();
 }
 
+void PropertyMap::reset(Property::SourceFlags sources) {
+	if (!props_)
+		return;
+	for (auto& pair : mutableProps())
+		pair.second.reset(sources);
+}
+
 void PropertyMap::performInitFrom(Property::SourceFlags source, const PropertyMap& other) {
-	for (auto& pair : props_) {
+	if (!props_)
+		return;
+	for (auto& pair : mutableProps()) {
 		Property& p = pair.second;
 
 		// don't override value previously set by higher-priority source
@@ -0,0 +1,297 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/task_constructor/reachability_map.h>
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <random_numbers/random_numbers.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace moveit {
+namespace task_constructor {
+
+namespace {
+constexpr char MAGIC[8] = { 'M', 'T', 'C', 'R', 'E', 'A', 'C', 'H' };
+constexpr uint32_t VERSION = 1;
+constexpr std::size_t NAME_LENGTH = 64;
+// directions closer than this angle are considered neighbours
+constexpr double NEIGHBOUR_ANGLE = 0.6;
+
+// on-disk layout, followed by the cells' bitmasks
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t num_directions;
+	double resolution;
+	double origin[3];
+	uint32_t size[3];
+	uint32_t reserved;
+	uint64_t samples;
+	char group[NAME_LENGTH];
+	char link[NAME_LENGTH];
+	char base_link[NAME_LENGTH];
+};
+static_assert(sizeof(FileHeader) % sizeof(uint64_t) == 0, "cells need to be aligned");
+
+using Directions = std::array<Eigen::Vector3d, ReachabilityMap::NUM_DIRECTIONS>;
+
+// directions evenly distributed on the unit sphere (Fibonacci lattice)
+const Directions& directions() {
+	static const Directions directions = [] {
+		Directions result;
+		const double golden_angle = M_PI * (3.0 - std::sqrt(5.0));
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			double z = 1.0 - (2.0 * i + 1.0) / result.size();
+			double r = std::sqrt(1.0 - z * z);
+			result[i] = Eigen::Vector3d(r * std::cos(golden_angle * i), r * std::sin(golden_angle * i), z);
+		}
+		return result;
+	}();
+	return directions;
+}
+
+// bitmask of neighbouring directions (including itself) for each direction
+const std::array<uint64_t, ReachabilityMap::NUM_DIRECTIONS>& neighbours() {
+	static const std::array<uint64_t, ReachabilityMap::NUM_DIRECTIONS> neighbours = [] {
+		std::array<uint64_t, ReachabilityMap::NUM_DIRECTIONS> result;
+		const double min_cos = std::cos(NEIGHBOUR_ANGLE);
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			result[i] = 0;
+			for (std::size_t j = 0; j < result.size(); ++j)
+				if (directions()[i].dot(directions()[j]) >= min_cos)
+					result[i] |= uint64_t(1) << j;
+		}
+		return result;
+	}();
+	return neighbours;
+}
+
+std::size_t nearestDirection(const Eigen::Vector3d& direction) {
+	const Directions& dirs = directions();
+	std::size_t best = 0;
+	double best_dot = -std::numeric_limits<double>::infinity();
+	for (std::size_t i = 0; i < dirs.size(); ++i) {
+		double dot = dirs[i].dot(direction);
+		if (dot > best_dot) {
+			best_dot = dot;
+			best = i;
+		}
+	}
+	return best;
+}
+
+void copyName(char (&dest)[NAME_LENGTH], const std::string& name) {
+	if (name.size() >= NAME_LENGTH)
+		throw std::runtime_error("name too long for reachability map: " + name);
+	std::memset(dest, 0, NAME_LENGTH);
+	std::memcpy(dest, name.data(), name.size());
+}
+
+const moveit::core::LinkModel* baseLinkModel(const moveit::core::JointModelGroup* jmg) {
+	const moveit::core::JointModel* root = jmg->getCommonRoot();
+	return root ? root->getParentLinkModel() : nullptr;
+}
+}  // namespace
+
+ReachabilityMapPtr ReachabilityMap::build(const moveit::core::RobotModelConstPtr& robot_model, const std::string& group,
+                                          const std::string& link, double resolution, std::size_t samples,
+                                          unsigned int seed) {
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(group);
+	if (!jmg)
+		throw std::runtime_error("unknown group: " + group);
+	const moveit::core::LinkModel* link_model = robot_model->getLinkModel(link);
+	if (!link_model)
+		throw std::runtime_error("unknown link: " + link);
+	if (resolution <= 0 || samples == 0)
+		throw std::runtime_error("invalid resolution or number of samples");
+	const moveit::core::LinkModel* base_link = baseLinkModel(jmg);
+
+	ReachabilityMapPtr map(new ReachabilityMap());
+	map->group_ = group;
+	map->link_ = link;
+	map->base_link_ = base_link ? base_link->getName() : std::string();
+	map->resolution_ = resolution;
+	map->samples_ = samples;
+
+	// sample link poses w.r.t. base link
+	moveit::core::RobotState state(robot_model);
+	state.setToDefaultValues();
+	random_numbers::RandomNumberGenerator rng(seed);
+	std::vector<std::pair<Eigen::Vector3f, uint8_t>> reached;
+	reached.reserve(samples);
+	Eigen::Vector3d lower = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+	Eigen::Vector3d upper = -lower;
+	for (std::size_t i = 0; i < samples; ++i) {
+		state.setToRandomPositions(jmg, rng);
+		state.updateLinkTransforms();
+		Eigen::Isometry3d pose = state.getGlobalLinkTransform(link_model);
+		if (base_link)
+			pose = state.getGlobalLinkTransform(base_link).inverse() * pose;
+		lower = lower.cwiseMin(pose.translation());
+		upper = upper.cwiseMax(pose.translation());
+		reached.emplace_back(pose.translation().cast<float>(), nearestDirection(pose.linear().col(2)));
+	}
+
+	// grid covering all samples, padded by one voxel
+	map->origin_ = lower - Eigen::Vector3d::Constant(resolution);
+	for (int d = 0; d < 3; ++d)
+		map->size_[d] = static_cast<uint32_t>(std::ceil((upper[d] - lower[d]) / resolution)) + 3;
+
+	map->storage_.assign(map->numCells(), 0);
+	for (const auto& sample : reached) {
+		Eigen::Vector3d cell = (sample.first.cast<double>() - map->origin_) / resolution;
+		map->storage_[map->cellIndex(static_cast<uint32_t>(cell.x()), static_cast<uint32_t>(cell.y()),
+		                             static_cast<uint32_t>(cell.z()))] |= uint64_t(1) << sample.second;
+	}
+	map->cells_ = map->storage_.data();
+	return map;
+}
+
+void ReachabilityMap::save(const std::string& file) const {
+	FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.num_directions = NUM_DIRECTIONS;
+	header.resolution = resolution_;
+	for (int d = 0; d < 3; ++d) {
+		header.origin[d] = origin_[d];
+		header.size[d] = size_[d];
+	}
+	header.samples = samples_;
+	copyName(header.group, group_);
+	copyName(header.link, link_);
+	copyName(header.base_link, base_link_);
+
+	std::ofstream out(file, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(cells_), numCells() * sizeof(uint64_t));
+	if (!out)
+		throw std::runtime_error("failed to write reachability map: " + file);
+}
+
+ReachabilityMapPtr ReachabilityMap::load(const std::string& file) {
+	int fd = ::open(file.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error("failed to open reachability map: " + file);
+	struct stat info;
+	if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+		::close(fd);
+		throw std::runtime_error("invalid reachability map: " + file);
+	}
+	const std::size_t file_size = info.st_size;
+	void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);  // mapping remains valid
+	if (mapping == MAP_FAILED)
+		throw std::runtime_error("failed to map reachability map: " + file);
+
+	ReachabilityMapPtr map(new ReachabilityMap());
+	map->mapping_ = mapping;  // unmapped by destructor, also on errors below
+	map->mapping_size_ = file_size;
+
+	const FileHeader& header = *static_cast<const FileHeader*>(mapping);
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+	    header.num_directions != NUM_DIRECTIONS)
+		throw std::runtime_error("incompatible reachability map: " + file);
+
+	map->resolution_ = header.resolution;
+	for (int d = 0; d < 3; ++d) {
+		map->origin_[d] = header.origin[d];
+		map->size_[d] = header.size[d];
+	}
+	map->samples_ = header.samples;
+	map->group_.assign(header.group, strnlen(header.group, NAME_LENGTH));
+	map->link_.assign(header.link, strnlen(header.link, NAME_LENGTH));
+	map->base_link_.assign(header.base_link, strnlen(header.base_link, NAME_LENGTH));
+
+	if (file_size != sizeof(FileHeader) + map->numCells() * sizeof(uint64_t))
+		throw std::runtime_error("truncated reachability map: " + file);
+	map->cells_ = reinterpret_cast<const uint64_t*>(static_cast<const char*>(mapping) + sizeof(FileHeader));
+	return map;
+}
+
+ReachabilityMap::~ReachabilityMap() {
+	if (mapping_)
+		::munmap(mapping_, mapping_size_);
+}
+
+bool ReachabilityMap::reachable(const Eigen::Isometry3d& pose) const {
+	const Eigen::Vector3d cell = (pose.translation() - origin_) / resolution_;
+	const uint64_t mask = neighbours()[nearestDirection(pose.linear().col(2))];
+
+	// check all neighbouring voxels (within grid)
+	int64_t lower[3], upper[3];
+	for (int d = 0; d < 3; ++d) {
+		const int64_t center = static_cast<int64_t>(std::floor(cell[d]));
+		lower[d] = std::max<int64_t>(center - 1, 0);
+		upper[d] = std::min<int64_t>(center + 1, static_cast<int64_t>(size_[d]) - 1);
+		if (lower[d] > upper[d])
+			return false;  // outside grid
+	}
+	for (int64_t z = lower[2]; z <= upper[2]; ++z)
+		for (int64_t y = lower[1]; y <= upper[1]; ++y)
+			for (int64_t x = lower[0]; x <= upper[0]; ++x)
+				if (cells_[cellIndex(x, y, z)] & mask)
+					return true;
+	return false;
+}
+
+bool ReachabilityMap::reachable(const moveit::core::RobotState& state, const Eigen::Isometry3d& pose) const {
+	if (base_link_.empty())
+		return reachable(pose);
+	return reachable(state.getGlobalLinkTransform(base_link_).inverse() * pose);
+}
+
+double ReachabilityMap::occupancy() const {
+	const std::size_t num_cells = numCells();
+	if (num_cells == 0)
+		return 0.0;
+	return static_cast<double>(std::count_if(cells_, cells_ + num_cells, [](uint64_t cell) { return cell != 0; })) /
+	       num_cells;
+}
+}  // namespace task_constructor
+}  // namespace moveit
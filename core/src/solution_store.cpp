@@ -0,0 +1,158 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Local store of task solutions, indexed by task and start scene fingerprints
+ */
+
+#include <moveit/task_constructor/solution_store.h>
+#include <ros/serialization.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+namespace moveit {
+namespace task_constructor {
+
+namespace {
+constexpr char MAGIC[8] = { 'M', 'T', 'C', 'S', 'O', 'L', 'N', 'S' };
+constexpr uint32_t VERSION = 1;
+}  // namespace
+
+SolutionStore::SolutionStore(std::string directory, std::size_t max_solutions)
+  : directory_(std::move(directory)), max_solutions_(max_solutions) {
+	if (directory_.empty())
+		directory_ = ".";
+	if (::mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST)
+		throw std::runtime_error("failed to create solution store: " + directory_);
+}
+
+std::string SolutionStore::file(uint64_t key) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.solutions", static_cast<unsigned long long>(key));
+	return directory_ + "/" + name;
+}
+
+void SolutionStore::store(uint64_t key, const std::vector<moveit_task_constructor_msgs::Solution>& solutions) {
+	const std::size_t count = std::min(solutions.size(), max_solutions_);
+	if (count == 0) {
+		erase(key);
+		return;
+	}
+
+	// each solution is stored as its size followed by the serialized message
+	std::vector<uint8_t> buffer;
+	for (std::size_t i = 0; i < count; ++i) {
+		const uint32_t size = ros::serialization::serializationLength(solutions[i]);
+		const std::size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(size) + size);
+		std::memcpy(buffer.data() + offset, &size, sizeof(size));
+		ros::serialization::OStream stream(buffer.data() + offset + sizeof(size), size);
+		ros::serialization::serialize(stream, solutions[i]);
+	}
+
+	// write to a temporary file first, such that readers never see partial files
+	// (one per thread, as clones of a task, planned in parallel, store with the same key)
+	const std::string path = file(key);
+	const std::string tmp = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	{
+		std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+		const uint32_t num = count;
+		out.write(MAGIC, sizeof(MAGIC));
+		out.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+		out.write(reinterpret_cast<const char*>(&num), sizeof(num));
+		out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		if (!out)
+			throw std::runtime_error("failed to write solutions: " + tmp);
+	}
+	if (std::rename(tmp.c_str(), path.c_str()) != 0)
+		throw std::runtime_error("failed to write solutions: " + path);
+}
+
+std::vector<moveit_task_constructor_msgs::Solution> SolutionStore::load(uint64_t key) {
+	std::vector<moveit_task_constructor_msgs::Solution> solutions;
+	std::ifstream in(file(key), std::ios::binary);
+	if (!in) {
+		++misses_;
+		return solutions;
+	}
+	const std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	const std::size_t header = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+	uint32_t version = 0, num = 0;
+	if (data.size() >= header) {
+		std::memcpy(&version, data.data() + sizeof(MAGIC), sizeof(version));
+		std::memcpy(&num, data.data() + sizeof(MAGIC) + sizeof(version), sizeof(num));
+	}
+	if (data.size() < header || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+		++misses_;  // foreign file or outdated format
+		return solutions;
+	}
+
+	std::size_t offset = header;
+	for (uint32_t i = 0; i < num; ++i) {
+		uint32_t size;
+		if (offset + sizeof(size) > data.size())
+			break;
+		std::memcpy(&size, data.data() + offset, sizeof(size));
+		offset += sizeof(size);
+		if (offset + size > data.size())
+			break;
+		solutions.emplace_back();
+		// IStream requires a non-const buffer, but doesn't modify it
+		ros::serialization::IStream stream(const_cast<uint8_t*>(data.data() + offset), size);
+		ros::serialization::deserialize(stream, solutions.back());
+		offset += size;
+	}
+	if (solutions.size() != num) {  // truncated file
+		++misses_;
+		return {};
+	}
+	++hits_;
+	return solutions;
+}
+
+void SolutionStore::erase(uint64_t key) {
+	std::remove(file(key).c_str());
+}
+}  // namespace task_constructor
+}  // namespace moveit
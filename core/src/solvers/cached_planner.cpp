@@ -0,0 +1,146 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Planner wrapper reusing trajectories from a TrajectoryCache
+ */
+
+#include <moveit/task_constructor/solvers/cached_planner.h>
+#include <moveit/task_constructor/trajectory_cache.h>
+#include <moveit/task_constructor/trajectory_validation.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/trajectory_processing/time_parameterization.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+
+namespace moveit {
+namespace task_constructor {
+namespace solvers {
+
+namespace {
+// is a cached trajectory valid in the actual scene?
+bool isValid(const planning_scene::PlanningScene& scene, const robot_trajectory::RobotTrajectory& trajectory,
+             const moveit_msgs::Constraints& path_constraints) {
+	PathValidationOptions options;
+	options.group = trajectory.getGroupName();
+	return isPathValid(scene, trajectory, path_constraints, options);
+}
+
+// settings of planner shaping its trajectories beyond the query itself
+std::string plannerConfig(const PlannerInterface& planner) {
+	const PropertyMap& props = planner.properties();
+	auto timing = props.get<trajectory_processing::TimeParameterizationPtr>("time_parameterization");
+	std::ostringstream config;
+	config.precision(17);
+	config << props.get<double>("max_velocity_scaling_factor") << ' '
+	       << props.get<double>("max_acceleration_scaling_factor") << ' ';
+	if (const trajectory_processing::TimeParameterization* t = timing.get())
+		config << typeid(*t).name();  // mangled, but stable for a given build
+	return config.str();
+}
+}  // namespace
+
+CachedPlanner::CachedPlanner(const PlannerInterfacePtr& planner, const TrajectoryCachePtr& cache)
+  : planner_(planner), cache_(cache) {
+	if (!planner_ || !cache_)
+		throw std::runtime_error("CachedPlanner requires a planner and a cache");
+}
+
+void CachedPlanner::init(const core::RobotModelConstPtr& robot_model) {
+	planner_->init(robot_model);
+}
+
+PlannerInterface::Result CachedPlanner::plan(const planning_scene::PlanningSceneConstPtr& from,
+                                             const planning_scene::PlanningSceneConstPtr& to,
+                                             const moveit::core::JointModelGroup* jmg, double timeout,
+                                             robot_trajectory::RobotTrajectoryPtr& result,
+                                             const moveit_msgs::Constraints& path_constraints) {
+	const TrajectoryCache::Key key = cache_->key(*from, *to, jmg, path_constraints, plannerConfig(*planner_));
+	auto cached = std::make_shared<robot_trajectory::RobotTrajectory>(from->getRobotModel(), jmg);
+	if (cache_->lookup(key, from->getCurrentState(), jmg, *cached)) {
+		// start and goal only match up to the quantization: use the exact ones
+		std::vector<double> positions;
+		from->getCurrentState().copyJointGroupPositions(jmg, positions);
+		cached->getFirstWayPointPtr()->setJointGroupPositions(jmg, positions);
+		cached->getFirstWayPointPtr()->update();
+		to->getCurrentState().copyJointGroupPositions(jmg, positions);
+		cached->getLastWayPointPtr()->setJointGroupPositions(jmg, positions);
+		cached->getLastWayPointPtr()->update();
+
+		if (isValid(*from, *cached, path_constraints)) {
+			result = cached;
+			return { true, "cached" };
+		}
+		cache_->invalidate(key);
+	}
+
+	timeout = std::min(timeout, properties().get<double>("timeout"));
+	Result r = planner_->plan(from, to, jmg, timeout, result, path_constraints);
+	if (r && result)
+		cache_->insert(key, *result);
+	return r;
+}
+
+PlannerInterface::Result CachedPlanner::plan(const planning_scene::PlanningSceneConstPtr& from,
+                                             const moveit::core::LinkModel& link, const Eigen::Isometry3d& offset,
+                                             const Eigen::Isometry3d& target, const moveit::core::JointModelGroup* jmg,
+                                             double timeout, robot_trajectory::RobotTrajectoryPtr& result,
+                                             const moveit_msgs::Constraints& path_constraints) {
+	const TrajectoryCache::Key key =
+	    cache_->key(*from, link, target * offset.inverse(), jmg, path_constraints, plannerConfig(*planner_));
+	auto cached = std::make_shared<robot_trajectory::RobotTrajectory>(from->getRobotModel(), jmg);
+	if (cache_->lookup(key, from->getCurrentState(), jmg, *cached)) {
+		std::vector<double> positions;
+		from->getCurrentState().copyJointGroupPositions(jmg, positions);
+		cached->getFirstWayPointPtr()->setJointGroupPositions(jmg, positions);
+		cached->getFirstWayPointPtr()->update();
+
+		if (isValid(*from, *cached, path_constraints)) {
+			result = cached;
+			return { true, "cached" };
+		}
+		cache_->invalidate(key);
+	}
+
+	timeout = std::min(timeout, properties().get<double>("timeout"));
+	Result r = planner_->plan(from, link, offset, target, jmg, timeout, result, path_constraints);
+	if (r && result)
+		cache_->insert(key, *result);
+	return r;
+}
+}  // namespace solvers
+}  // namespace task_constructor
+}  // namespace moveit
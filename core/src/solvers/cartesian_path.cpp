@@ -38,6 +38,7 @@
 
 #include <moveit/task_constructor/solvers/cartesian_path.h>
 #include <moveit/task_constructor/utils.h>
+#include <moveit/task_constructor/sphere_collision_filter.h>
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/trajectory_processing/time_parameterization.h>
 #include <moveit/kinematics_base/kinematics_base.h>
@@ -57,6 +58,8 @@ CartesianPath::CartesianPath() {
 	p.declare<moveit::core::CartesianPrecision>("precision", moveit::core::CartesianPrecision(),
 	                                            "precision of linear path");
 	p.declare<double>("min_fraction", 1.0, "fraction of motion required for success");
+	p.declare<bool>("collision_prefilter", false,
+	                "skip full collision checks for states found collision-free by spheres");
 	p.declare<kinematics::KinematicsQueryOptions>("kinematics_options", kinematics::KinematicsQueryOptions(),
 	                                              "KinematicsQueryOptions to pass to CartesianInterpolator");
 }
@@ -101,12 +104,24 @@ PlannerInterface::Result CartesianPath::plan(const planning_scene::PlanningScene
 	kinematic_constraints::KinematicConstraintSet kcs(sandbox_scene->getRobotModel());
 	kcs.add(path_constraints, sandbox_scene->getTransforms());
 
-	auto is_valid = [&sandbox_scene, &kcs](moveit::core::RobotState* state, const moveit::core::JointModelGroup* jmg,
-	                                       const double* joint_positions) {
+	// the filter only depends on the start scene (not its state): share it by all plans from this scene
+	SphereCollisionFilterConstPtr filter;
+	if (props.get<bool>("collision_prefilter")) {
+		std::lock_guard<std::mutex> lock(collision_filter_mutex_);
+		filter = collision_filter_cache_.get({ from, jmg }, [&] {
+			return SphereCollisionFilterConstPtr(std::make_shared<SphereCollisionFilter>(from, jmg));
+		});
+	}
+
+	auto is_valid = [&sandbox_scene, &kcs, &filter](moveit::core::RobotState* state,
+	                                                const moveit::core::JointModelGroup* jmg,
+	                                                const double* joint_positions) {
 		state->setJointGroupPositions(jmg, joint_positions);
 		state->update();
-		return !sandbox_scene->isStateColliding(const_cast<const moveit::core::RobotState&>(*state), jmg->getName()) &&
-		       kcs.decide(*state).satisfied;
+		const moveit::core::RobotState& const_state = *state;
+		bool colliding = filter ? filter->isStateColliding(const_state) :
+		                          sandbox_scene->isStateColliding(const_state, jmg->getName());
+		return !colliding && kcs.decide(*state).satisfied;
 	};
 
 	std::vector<moveit::core::RobotStatePtr> trajectory;
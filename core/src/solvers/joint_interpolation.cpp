@@ -37,6 +37,9 @@
 */
 
 #include <moveit/task_constructor/solvers/joint_interpolation.h>
+#include <moveit/task_constructor/sphere_collision_filter.h>
+#include <moveit/task_constructor/trajectory_matrix.h>
+#include <moveit/task_constructor/trajectory_validation.h>
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/trajectory_processing/time_parameterization.h>
 
@@ -51,6 +54,8 @@ using namespace trajectory_processing;
 JointInterpolationPlanner::JointInterpolationPlanner() {
 	auto& p = properties();
 	p.declare<double>("max_step", 0.1, "max joint step");
+	p.declare<bool>("collision_prefilter", false,
+	                "skip full collision checks for states found collision-free by spheres");
 	// allow passing max_effort to GripperCommand actions via
 	p.declare<double>("max_effort", "max_effort for GripperCommand actions");
 }
@@ -64,43 +69,80 @@ PlannerInterface::Result JointInterpolationPlanner::plan(const planning_scene::P
                                                          const moveit_msgs::Constraints& /*path_constraints*/) {
 	const auto& props = properties();
 
-	// Get maximum joint distance
+	// Get maximum joint distance of the group's joints
 	double d = 0.0;
 	const moveit::core::RobotState& from_state = from->getCurrentState();
 	const moveit::core::RobotState& to_state = to->getCurrentState();
-	for (const moveit::core::JointModel* jm : from_state.getRobotModel()->getActiveJointModels())
+	for (const moveit::core::JointModel* jm : jmg->getActiveJointModels())
 		d = std::max(d, jm->getDistanceFactor() * from_state.distance(to_state, jm));
 
 	result = std::make_shared<robot_trajectory::RobotTrajectory>(from->getRobotModel(), jmg);
 
-	// add first point
-	result->addSuffixWayPoint(from->getCurrentState(), 0.0);
-	if (from->isStateColliding(from_state, jmg->getName()))
-		return { false, "Start state is in collision!" };
-
-	if (!from_state.satisfiesBounds(jmg))
-		return { false, "Start state is out of bounds!" };
-
-	moveit::core::RobotState waypoint(from_state);
-	double delta = d < 1e-6 ? 1.0 : props.get<double>("max_step") / d;
-	for (double t = delta; t < 1.0; t += delta) {  // NOLINT(clang-analyzer-security.FloatLoopCounter)
-		from_state.interpolate(to_state, t, waypoint);
-		result->addSuffixWayPoint(waypoint, t);
-
-		if (from->isStateColliding(waypoint, jmg->getName()))
-			return { false, "Waypoint is in collision!" };
-
-		if (!waypoint.satisfiesBounds(jmg))
-			return { false, "Waypoint is out of bounds!" };
+	// the filter only depends on the start scene (not its state): share it by all plans from this scene
+	SphereCollisionFilterConstPtr filter;
+	if (props.get<bool>("collision_prefilter")) {
+		std::lock_guard<std::mutex> lock(collision_filter_mutex_);
+		filter = collision_filter_cache_.get({ from, jmg }, [&] {
+			return SphereCollisionFilterConstPtr(std::make_shared<SphereCollisionFilter>(from, jmg));
+		});
 	}
+	auto is_colliding = [&from, &filter, jmg](const moveit::core::RobotState& state) {
+		return filter ? filter->isStateColliding(state) : from->isStateColliding(state, jmg->getName());
+	};
 
-	// add goal point
-	result->addSuffixWayPoint(to_state, 1.0);
-	if (from->isStateColliding(to_state, jmg->getName()))
-		return { false, "Goal state is in collision!" };
-
-	if (!to_state.satisfiesBounds(jmg))
-		return { false, "Goal state is out of bounds!" };
+	// allocate all waypoints, including start and goal, up front
+	std::vector<double> stamps{ 0.0 };
+	double delta = d < 1e-6 ? 1.0 : props.get<double>("max_step") / d;
+	for (double t = delta; t < 1.0; t += delta)  // NOLINT(clang-analyzer-security.FloatLoopCounter)
+		stamps.push_back(t);
+	stamps.push_back(1.0);
+
+	const std::size_t goal = stamps.size() - 1;
+	const TrajectoryMatrix positions = TrajectoryMatrix::interpolate(from_state, to_state, stamps);
+
+	// robot states are only created for the returned trajectory, which ends at the offending waypoint on failure
+	auto add_waypoints = [&](std::size_t last) {
+		for (std::size_t i = 0; i <= last; ++i) {
+			if (i == 0 || i == goal) {
+				result->addSuffixWayPoint(i == 0 ? from_state : to_state, stamps[i]);
+				continue;
+			}
+			auto waypoint = std::make_shared<moveit::core::RobotState>(from_state);
+			waypoint->setVariablePositions(positions.waypoint(i));
+			waypoint->update();
+			result->addSuffixWayPoint(waypoint, stamps[i]);
+		}
+	};
+	auto fail = [&](std::size_t index, const char* what) {
+		add_waypoints(index);
+		const char* state = index == 0 ? "Start state" : index == goal ? "Goal state" : "Waypoint";
+		return Result{ false, std::string(state) + " is " + what + "!" };
+	};
+	// validate a waypoint, computing its forward kinematics only now
+	moveit::core::RobotState scratch(from_state);
+	auto invalid = [&](std::size_t index) -> const char* {
+		const moveit::core::RobotState* state = &from_state;
+		if (index == goal)
+			state = &to_state;
+		else if (index != 0) {
+			scratch.setVariablePositions(positions.waypoint(index));
+			scratch.update();
+			state = &scratch;
+		}
+		if (!state->satisfiesBounds(jmg))
+			return "out of bounds";
+		if (is_colliding(*state))
+			return "in collision";
+		return nullptr;
+	};
+
+	// validate start and goal first, then the intermediate waypoints by recursive bisection,
+	// exposing obstacles cutting through the path early
+	for (std::size_t index : bisectionOrder(stamps.size()))
+		if (const char* what = invalid(index))
+			return fail(index, what);
+
+	add_waypoints(goal);
 
 	auto timing = props.get<TimeParameterizationPtr>("time_parameterization");
 	if (timing)
@@ -38,6 +38,7 @@
 
 #include <moveit/task_constructor/solvers/multi_planner.h>
 #include <moveit/robot_trajectory/robot_trajectory.h>
+#include <algorithm>
 #include <chrono>
 
 namespace moveit {
@@ -49,6 +50,10 @@ void MultiPlanner::init(const core::RobotModelConstPtr& robot_model) {
 		p->init(robot_model);
 }
 
+bool MultiPlanner::isThreadSafe() const {
+	return std::all_of(begin(), end(), [](const auto& p) { return p->isThreadSafe(); });
+}
+
 PlannerInterface::Result MultiPlanner::plan(const planning_scene::PlanningSceneConstPtr& from,
                                             const planning_scene::PlanningSceneConstPtr& to,
                                             const moveit::core::JointModelGroup* jmg, double timeout,
@@ -38,47 +38,58 @@
 
 #include <moveit/task_constructor/solvers/pipeline_planner.h>
 #include <moveit/task_constructor/task.h>
+#include <moveit/task_constructor/cost_terms.h>
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/planning_pipeline/planning_pipeline.h>
 #include <moveit_msgs/MotionPlanRequest.h>
 #include <moveit/kinematic_constraints/utils.h>
 #include <tf2_eigen/tf2_eigen.h>
 
+#include <limits>
+#include <optional>
+#include <thread>
+
 namespace moveit {
 namespace task_constructor {
 namespace solvers {
 
-struct PlannerCache
+namespace {
+constexpr char const* PLUGIN_PARAMETER_NAME = "planning_plugin";
+
+// thread-safe cache of values per robot model and planner id
+template <typename Value>
+class PlannerCache
 {
+public:
 	using PlannerID = std::tuple<std::string, std::string>;
-	using PlannerMap = std::map<PlannerID, std::weak_ptr<planning_pipeline::PlanningPipeline> >;
-	using ModelList = std::list<std::pair<std::weak_ptr<const moveit::core::RobotModel>, PlannerMap> >;
-	ModelList cache_;
-
-	PlannerMap::mapped_type& retrieve(const moveit::core::RobotModelConstPtr& model, const PlannerID& id) {
-		// find model in cache_ and remove expired entries while doing so
-		ModelList::iterator model_it = cache_.begin();
-		while (model_it != cache_.end()) {
-			if (model_it->first.expired()) {
-				model_it = cache_.erase(model_it);
-				continue;
-			}
-			if (model_it->first.lock() == model)
-				break;
-			++model_it;
-		}
-		if (model_it == cache_.end())  // if not found, create a new PlannerMap for this model
-			model_it = cache_.insert(cache_.begin(), std::make_pair(model, PlannerMap()));
 
-		return model_it->second.insert(std::make_pair(id, PlannerMap::mapped_type())).first->second;
-	}
-};
+	// retrieve the cached value or create a new one via factory (called with the lock held)
+	template <typename Factory>
+	std::shared_ptr<Value> retrieve(const moveit::core::RobotModelConstPtr& model, const PlannerID& id,
+	                                const Factory& factory) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		// remove entries of expired models
+		for (auto it = cache_.begin(); it != cache_.end();)
+			it = it->first.expired() ? cache_.erase(it) : std::next(it);
 
-planning_pipeline::PlanningPipelinePtr PipelinePlanner::create(const PipelinePlanner::Specification& spec) {
-	static PlannerCache cache;
+		std::weak_ptr<Value>& entry = cache_[model][id];
+		std::shared_ptr<Value> value = entry.lock();
+		if (!value) {
+			value = factory();
+			entry = value;
+		}
+		return value;
+	}
 
-	static constexpr char const* PLUGIN_PARAMETER_NAME = "planning_plugin";
+private:
+	using PlannerMap = std::map<PlannerID, std::weak_ptr<Value>>;
+	std::mutex mutex_;
+	std::map<std::weak_ptr<const moveit::core::RobotModel>, PlannerMap,
+	         std::owner_less<std::weak_ptr<const moveit::core::RobotModel>>>
+	    cache_;
+};
 
+std::string pipelineNamespace(const PipelinePlanner::Specification& spec) {
 	std::string pipeline_ns = spec.ns + "/planning_pipelines/" + spec.pipeline;
 	// fallback to old structure for pipeline parameters in MoveIt
 	if (!ros::NodeHandle(pipeline_ns).hasParam(PLUGIN_PARAMETER_NAME)) {
@@ -86,19 +97,73 @@ planning_pipeline::PlanningPipelinePtr PipelinePlanner::create(const PipelinePla
 		         "Attempting to load pipeline from old parameter structure. Please update your MoveIt config.");
 		pipeline_ns = spec.ns;
 	}
+	return pipeline_ns;
+}
+
+planning_pipeline::PlanningPipelinePtr createPipeline(const moveit::core::RobotModelConstPtr& model,
+                                                      const std::string& pipeline_ns,
+                                                      const std::string& adapter_param) {
+	// plugin loading isn't thread-safe
+	static std::mutex mutex;
+	std::lock_guard<std::mutex> lock(mutex);
+	return std::make_shared<planning_pipeline::PlanningPipeline>(model, ros::NodeHandle(pipeline_ns),
+	                                                             PLUGIN_PARAMETER_NAME, adapter_param);
+}
+}  // namespace
 
-	PlannerCache::PlannerID id(pipeline_ns, spec.adapter_param);
+std::optional<size_t>
+planCheapest(size_t num_attempts, const std::function<bool(size_t, robot_trajectory::RobotTrajectoryPtr&)>& attempt,
+             const CostTerm& cost_term, robot_trajectory::RobotTrajectoryPtr& result) {
+	std::vector<robot_trajectory::RobotTrajectoryPtr> trajectories(num_attempts);
+	std::vector<char> succeeded(num_attempts, 0);
+	auto work = [&](size_t i) { succeeded[i] = attempt(i, trajectories[i]) && trajectories[i]; };
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < num_attempts; ++i)
+		threads.emplace_back(work, i);
+	if (num_attempts > 0)
+		work(0);
+	for (auto& thread : threads)
+		thread.join();
 
-	std::weak_ptr<planning_pipeline::PlanningPipeline>& entry = cache.retrieve(spec.model, id);
-	planning_pipeline::PlanningPipelinePtr planner = entry.lock();
-	if (!planner) {
-		// create new entry
-		planner = std::make_shared<planning_pipeline::PlanningPipeline>(spec.model, ros::NodeHandle(pipeline_ns),
-		                                                                PLUGIN_PARAMETER_NAME, spec.adapter_param);
-		// store in cache
-		entry = planner;
+	// pick the cheapest successful trajectory
+	double best_cost = std::numeric_limits<double>::infinity();
+	std::optional<size_t> best;
+	for (size_t i = 0; i < num_attempts; ++i) {
+		if (!succeeded[i])
+			continue;
+		std::string comment;
+		double cost = cost_term(SubTrajectory(trajectories[i]), comment);
+		if (!best || cost < best_cost) {
+			best = i;
+			best_cost = cost;
+		}
 	}
-	return planner;
+	if (best)
+		result = trajectories[*best];
+	return best;
+}
+
+planning_pipeline::PlanningPipelinePtr PipelinePlanner::create(const PipelinePlanner::Specification& spec) {
+	static PlannerCache<planning_pipeline::PlanningPipeline> cache;
+
+	const std::string pipeline_ns = pipelineNamespace(spec);
+	return cache.retrieve(spec.model, { pipeline_ns, spec.adapter_param },
+	                      [&] { return createPipeline(spec.model, pipeline_ns, spec.adapter_param); });
+}
+
+PipelinePoolPtr PipelinePlanner::pool(const Specification& spec, size_t max_size) {
+	static PlannerCache<PipelinePool> cache;
+
+	const std::string pipeline_ns = pipelineNamespace(spec);
+	auto pool = cache.retrieve(spec.model, { pipeline_ns, spec.adapter_param }, [&] {
+		return std::make_shared<PipelinePool>(
+		    [model = spec.model, pipeline_ns, adapter_param = spec.adapter_param] {
+			    return createPipeline(model, pipeline_ns, adapter_param);
+		    },
+		    max_size);
+	});
+	pool->reserve(max_size);
+	return pool;
 }
 
 PipelinePlanner::PipelinePlanner(const std::string& pipeline_name) : pipeline_name_{ pipeline_name } {
@@ -113,43 +178,66 @@ PipelinePlanner::PipelinePlanner(const std::string& pipeline_name) : pipeline_na
 	p.declare<double>("goal_position_tolerance", 1e-4, "tolerance for reaching position goals");
 	p.declare<double>("goal_orientation_tolerance", 1e-4, "tolerance for reaching orientation goals");
 
+	p.declare<uint32_t>("num_parallel_requests", 1,
+	                    "number of independent requests planned in parallel, returning the cheapest solution "
+	                    "(at most pool_size, a custom pipeline only plans a single request)");
+	p.declare<uint32_t>("pool_size", 0,
+	                    "maximum number of pipeline instances for concurrent planning, 0: number of cores");
+
 	p.declare<bool>("display_motion_plans", false,
 	                "publish generated solutions on topic " + planning_pipeline::PlanningPipeline::DISPLAY_PATH_TOPIC);
 	p.declare<bool>("publish_planning_requests", false,
 	                "publish motion planning requests on topic " +
 	                    planning_pipeline::PlanningPipeline::MOTION_PLAN_REQUEST_TOPIC);
+
+	// all properties are declared now: resolve handles here, such that plan() works without init() too
+	props_.planner = p.handle<std::string>("planner");
+	props_.timeout = p.handle<double>("timeout");
+	props_.num_planning_attempts = p.handle<uint>("num_planning_attempts");
+	props_.num_parallel_requests = p.handle<uint32_t>("num_parallel_requests");
+	props_.max_velocity_scaling_factor = p.handle<double>("max_velocity_scaling_factor");
+	props_.max_acceleration_scaling_factor = p.handle<double>("max_acceleration_scaling_factor");
+	props_.workspace_parameters = p.handle<moveit_msgs::WorkspaceParameters>("workspace_parameters");
+	props_.goal_joint_tolerance = p.handle<double>("goal_joint_tolerance");
+	props_.goal_position_tolerance = p.handle<double>("goal_position_tolerance");
+	props_.goal_orientation_tolerance = p.handle<double>("goal_orientation_tolerance");
 }
 
 PipelinePlanner::PipelinePlanner(const planning_pipeline::PlanningPipelinePtr& planning_pipeline) : PipelinePlanner() {
 	planner_ = planning_pipeline;
+	pool_ = std::make_shared<PipelinePool>(planner_);  // serialize access to the custom pipeline
 }
 
 void PipelinePlanner::init(const core::RobotModelConstPtr& robot_model) {
+	auto& p = properties();
 	if (!planner_) {
 		Specification spec;
 		spec.model = robot_model;
 		spec.pipeline = pipeline_name_;
-		planner_ = create(spec);
+		size_t pool_size = p.get<uint32_t>("pool_size");
+		max_parallel_requests_ = pool_size ? pool_size : std::max(1u, std::thread::hardware_concurrency());
+		pool_ = pool(spec, max_parallel_requests_);
 	} else if (robot_model != planner_->getRobotModel()) {
 		throw std::runtime_error(
 		    "The robot model of the planning pipeline isn't the same as the task's robot model -- "
 		    "use Task::setRobotModel for setting the robot model when using custom planning pipeline");
 	}
-	planner_->displayComputedMotionPlans(properties().get<bool>("display_motion_plans"));
-	planner_->publishReceivedRequests(properties().get<bool>("publish_planning_requests"));
+
+	display_motion_plans_ = p.get<bool>("display_motion_plans");
+	publish_planning_requests_ = p.get<bool>("publish_planning_requests");
 }
 
-void initMotionPlanRequest(moveit_msgs::MotionPlanRequest& req, const PropertyMap& p,
-                           const moveit::core::JointModelGroup* jmg, double timeout) {
+void PipelinePlanner::initMotionPlanRequest(moveit_msgs::MotionPlanRequest& req,
+                                            const moveit::core::JointModelGroup* jmg, double timeout) const {
 	req.group_name = jmg->getName();
-	req.planner_id = p.get<std::string>("planner");
-	req.allowed_planning_time = std::min(timeout, p.get<double>("timeout"));
+	req.planner_id = props_.planner.get();
+	req.allowed_planning_time = std::min(timeout, props_.timeout.get());
 	req.start_state.is_diff = true;  // we don't specify an extra start state
 
-	req.num_planning_attempts = p.get<uint>("num_planning_attempts");
-	req.max_velocity_scaling_factor = p.get<double>("max_velocity_scaling_factor");
-	req.max_acceleration_scaling_factor = p.get<double>("max_acceleration_scaling_factor");
-	req.workspace_parameters = p.get<moveit_msgs::WorkspaceParameters>("workspace_parameters");
+	req.num_planning_attempts = props_.num_planning_attempts.get();
+	req.max_velocity_scaling_factor = props_.max_velocity_scaling_factor.get();
+	req.max_acceleration_scaling_factor = props_.max_acceleration_scaling_factor.get();
+	req.workspace_parameters = props_.workspace_parameters.get();
 }
 
 PlannerInterface::Result PipelinePlanner::plan(const planning_scene::PlanningSceneConstPtr& from,
@@ -157,13 +245,12 @@ PlannerInterface::Result PipelinePlanner::plan(const planning_scene::PlanningSce
                                                const moveit::core::JointModelGroup* jmg, double timeout,
                                                robot_trajectory::RobotTrajectoryPtr& result,
                                                const moveit_msgs::Constraints& path_constraints) {
-	const auto& props = properties();
 	moveit_msgs::MotionPlanRequest req;
-	initMotionPlanRequest(req, props, jmg, timeout);
+	initMotionPlanRequest(req, jmg, timeout);
 
 	req.goal_constraints.resize(1);
 	req.goal_constraints[0] = kinematic_constraints::constructGoalConstraints(to->getCurrentState(), jmg,
-	                                                                          props.get<double>("goal_joint_tolerance"));
+	                                                                          props_.goal_joint_tolerance.get());
 	req.path_constraints = path_constraints;
 
 	return plan(from, req, result);
@@ -175,9 +262,8 @@ PlannerInterface::Result PipelinePlanner::plan(const planning_scene::PlanningSce
                                                const moveit::core::JointModelGroup* jmg, double timeout,
                                                robot_trajectory::RobotTrajectoryPtr& result,
                                                const moveit_msgs::Constraints& path_constraints) {
-	const auto& props = properties();
 	moveit_msgs::MotionPlanRequest req;
-	initMotionPlanRequest(req, props, jmg, timeout);
+	initMotionPlanRequest(req, jmg, timeout);
 
 	geometry_msgs::PoseStamped target;
 	target.header.frame_id = from->getPlanningFrame();
@@ -185,8 +271,7 @@ PlannerInterface::Result PipelinePlanner::plan(const planning_scene::PlanningSce
 
 	req.goal_constraints.resize(1);
 	req.goal_constraints[0] = kinematic_constraints::constructGoalConstraints(
-	    link.getName(), target, props.get<double>("goal_position_tolerance"),
-	    props.get<double>("goal_orientation_tolerance"));
+	    link.getName(), target, props_.goal_position_tolerance.get(), props_.goal_orientation_tolerance.get());
 	req.path_constraints = path_constraints;
 
 	return plan(from, req, result);
@@ -195,12 +280,48 @@ PlannerInterface::Result PipelinePlanner::plan(const planning_scene::PlanningSce
 PlannerInterface::Result PipelinePlanner::plan(const planning_scene::PlanningSceneConstPtr& from,
                                                const moveit_msgs::MotionPlanRequest& req,
                                                robot_trajectory::RobotTrajectoryPtr& result) {
+	uint32_t num_requests = props_.num_parallel_requests.get();
+	// all requests share the same timeout, but need a pipeline instance each: don't exceed the configured pool size
+	if (num_requests > max_parallel_requests_) {
+		ROS_WARN_STREAM_ONCE_NAMED("PipelinePlanner", "Cannot plan " << num_requests << " requests in parallel with "
+		                                                              << max_parallel_requests_
+		                                                              << " pipeline instance(s)");
+		num_requests = max_parallel_requests_;
+	}
+	if (num_requests > 1)
+		return planParallel(from, req, num_requests, result);
+
 	::planning_interface::MotionPlanResponse res;
-	bool success = planner_->generatePlan(from, req, res);
+	planning_pipeline::PlanningPipelinePtr pipeline = pool_->checkout();
+	pipeline->displayComputedMotionPlans(display_motion_plans_);
+	pipeline->publishReceivedRequests(publish_planning_requests_);
+	bool success = pipeline->generatePlan(from, req, res);
 	result = res.trajectory_;
 	return { success, success ? std::string() : static_cast<std::string>(res.error_code_) };
 }
 
+PlannerInterface::Result PipelinePlanner::planParallel(const planning_scene::PlanningSceneConstPtr& from,
+                                                       const moveit_msgs::MotionPlanRequest& req,
+                                                       uint32_t num_requests,
+                                                       robot_trajectory::RobotTrajectoryPtr& result) {
+	std::vector<::planning_interface::MotionPlanResponse> responses(num_requests);
+	auto attempt = [&](size_t i, robot_trajectory::RobotTrajectoryPtr& trajectory) {
+		planning_pipeline::PlanningPipelinePtr pipeline = pool_->checkout();
+		pipeline->displayComputedMotionPlans(display_motion_plans_);
+		pipeline->publishReceivedRequests(publish_planning_requests_);
+		bool success = pipeline->generatePlan(from, req, responses[i]);
+		trajectory = responses[i].trajectory_;
+		return success;
+	};
+
+	const CostTermConstPtr cost_term = cost_term_ ? cost_term_ : std::make_shared<cost::PathLength>();
+	if (!planCheapest(num_requests, attempt, *cost_term, result)) {  // report the first failure
+		result = responses[0].trajectory_;
+		return { false, static_cast<std::string>(responses[0].error_code_) };
+	}
+	return { true, std::string() };
+}
+
 }  // namespace solvers
 }  // namespace task_constructor
 }  // namespace moveit
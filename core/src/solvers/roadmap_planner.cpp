@@ -0,0 +1,611 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Plan on a lazily validated roadmap, reused across queries in the same scene
+ */
+
+#include <moveit/task_constructor/solvers/roadmap_planner.h>
+#include <moveit/task_constructor/ik_cache.h>
+#include <moveit/task_constructor/joint_space_index.h>
+#include <moveit/task_constructor/trajectory_validation.h>
+#include <moveit/kinematic_constraints/kinematic_constraint.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/trajectory_processing/time_parameterization.h>
+#include <random_numbers/random_numbers.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+
+namespace moveit {
+namespace task_constructor {
+namespace solvers {
+
+using namespace trajectory_processing;
+
+namespace {
+constexpr char MAGIC[8] = { 'M', 'T', 'C', 'R', 'O', 'A', 'D', 'M' };
+constexpr uint32_t VERSION = 1;
+// configurations closer than this are considered identical
+constexpr double IDENTICAL = 1e-9;
+
+enum Validity : uint8_t
+{
+	UNKNOWN,
+	VALID,
+	INVALID
+};
+
+// outcome of checking a single state
+enum Check
+{
+	OK,
+	OUT_OF_BOUNDS,
+	COLLIDING,
+	VIOLATING,  // collision-free, but violating the path constraints of the current query
+};
+
+// checks group configurations w.r.t. a scene and (optional) path constraints
+class StateChecker
+{
+public:
+	StateChecker(const planning_scene::PlanningScene& scene, const moveit::core::JointModelGroup* jmg,
+	             const moveit_msgs::Constraints& path_constraints, double max_step)
+	  : scene_(scene)
+	  , jmg_(jmg)
+	  , constraints_(scene.getRobotModel())
+	  , state_(scene.getCurrentState())
+	  , buffer_(jmg->getVariableCount())
+	  , max_step_(max_step) {
+		constraints_.add(path_constraints, scene.getTransforms());
+	}
+
+	bool hasConstraints() const { return !constraints_.empty(); }
+
+	Check check(const double* positions) {
+		state_.setJointGroupPositions(jmg_, positions);
+		state_.update();
+		if (!state_.satisfiesBounds(jmg_))
+			return OUT_OF_BOUNDS;
+		if (scene_.isStateColliding(state_, jmg_->getName()))
+			return COLLIDING;
+		if (hasConstraints() && !constraints_.decide(state_).satisfied)
+			return VIOLATING;
+		return OK;
+	}
+
+	/** check the interior of the straight segment from -> to, validating waypoints by bisection
+	 *
+	 * If collisions are already known to be absent, only constraints are checked. */
+	Check checkSegment(const double* from, const double* to, double length, bool collision_free = false) {
+		if (collision_free && !hasConstraints())
+			return OK;
+		const std::size_t steps = std::max<std::size_t>(1, std::ceil(length / max_step_));
+		for (std::size_t i : bisectionOrder(steps + 1)) {
+			if (i == 0 || i == steps)  // end points are checked as nodes
+				continue;
+			jmg_->interpolate(from, to, static_cast<double>(i) / steps, buffer_.data());
+			state_.setJointGroupPositions(jmg_, buffer_.data());
+			state_.update();
+			if (!collision_free && scene_.isStateColliding(state_, jmg_->getName()))
+				return COLLIDING;
+			if (hasConstraints() && !constraints_.decide(state_).satisfied)
+				return VIOLATING;
+		}
+		return OK;
+	}
+
+private:
+	const planning_scene::PlanningScene& scene_;
+	const moveit::core::JointModelGroup* jmg_;
+	kinematic_constraints::KinematicConstraintSet constraints_;
+	moveit::core::RobotState state_;
+	std::vector<double> buffer_;
+	double max_step_;
+};
+
+template <typename T>
+void write(std::ostream& out, const T& value) {
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+template <typename T>
+T read(std::istream& in) {
+	T value;
+	in.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return value;
+}
+}  // namespace
+
+/** Roadmap of a single planning group in a single scene
+ *
+ * Nodes and edges carry their collision status (UNKNOWN until checked).
+ * Path constraints differ between queries and are never recorded in the roadmap. */
+class RoadmapPlanner::Roadmap
+{
+public:
+	struct Edge
+	{
+		uint32_t a, b;
+		double length;
+		Validity validity;
+
+		uint32_t other(uint32_t node) const { return node == a ? b : a; }
+	};
+	using Path = std::vector<uint32_t>;  // edge indices from start to goal
+
+	explicit Roadmap(const moveit::core::JointModelGroup* jmg) : index(jmg) {}
+
+	const moveit::core::JointModelGroup* group() const { return index.group(); }
+	std::size_t size() const { return nodes.size(); }
+	const double* operator[](std::size_t node) const { return index[node]; }
+
+	uint32_t addNode(const double* positions, Validity validity, std::size_t neighbors) {
+		const auto nearest = index.nearestK(positions, neighbors);
+		const uint32_t node = index.insert(positions);
+		nodes.push_back(validity);
+		adjacency.emplace_back();
+		for (const auto& [distance, other] : nearest)
+			addEdge(node, other, distance, UNKNOWN);
+		return node;
+	}
+
+	// node at positions, reusing an existing one at the very same configuration
+	uint32_t findOrAddNode(const double* positions, Validity validity, std::size_t neighbors) {
+		double distance;
+		const std::size_t nearest = index.nearest(positions, &distance);
+		if (nearest < size() && distance < IDENTICAL) {
+			if (nodes[nearest] == UNKNOWN)
+				nodes[nearest] = validity;
+			return nearest;
+		}
+		return addNode(positions, validity, neighbors);
+	}
+
+	void addEdge(uint32_t a, uint32_t b, double length, Validity validity) {
+		const uint32_t edge = edges.size();
+		edges.push_back(Edge{ a, b, length, validity });
+		adjacency[a].push_back(edge);
+		adjacency[b].push_back(edge);
+	}
+
+	bool connected(uint32_t a, uint32_t b) const {
+		const auto& candidates = adjacency[a].size() < adjacency[b].size() ? adjacency[a] : adjacency[b];
+		return std::any_of(candidates.begin(), candidates.end(), [&](uint32_t edge) {
+			return (edges[edge].a == a && edges[edge].b == b) || (edges[edge].a == b && edges[edge].b == a);
+		});
+	}
+
+	/** A* search for the shortest path from start to goal, avoiding invalid and blocked nodes and edges
+	 *
+	 * Returns false if there is no such path. */
+	bool shortestPath(uint32_t start, uint32_t goal, const std::vector<bool>& blocked_nodes,
+	                  const std::vector<bool>& blocked_edges, Path& path) const {
+		const auto* jmg = group();
+		auto usable_node = [&](uint32_t n) {
+			return nodes[n] != INVALID && !(n < blocked_nodes.size() && blocked_nodes[n]);
+		};
+		auto usable_edge = [&](uint32_t e) {
+			return edges[e].validity != INVALID && !(e < blocked_edges.size() && blocked_edges[e]);
+		};
+
+		constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+		std::vector<double> cost(size(), std::numeric_limits<double>::infinity());
+		std::vector<uint32_t> via(size(), NONE);  // edge leading to node on the best path
+		using Entry = std::tuple<double, double, uint32_t>;  // estimated total cost, cost so far, node
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+		cost[start] = 0.0;
+		open.emplace(jmg->distance(index[start], index[goal]), 0.0, start);
+		while (!open.empty()) {
+			const auto [estimate, reached, node] = open.top();
+			open.pop();
+			if (node == goal)
+				break;
+			if (reached > cost[node])
+				continue;  // outdated entry
+			for (uint32_t edge : adjacency[node]) {
+				const uint32_t next = edges[edge].other(node);
+				if (!usable_edge(edge) || !usable_node(next))
+					continue;
+				const double next_cost = cost[node] + edges[edge].length;
+				if (next_cost < cost[next]) {
+					cost[next] = next_cost;
+					via[next] = edge;
+					open.emplace(next_cost + jmg->distance(index[next], index[goal]), next_cost, next);
+				}
+			}
+		}
+		if (start != goal && via[goal] == NONE)
+			return false;
+
+		path.clear();
+		for (uint32_t node = goal; node != start; node = edges[via[node]].other(node))
+			path.push_back(via[node]);
+		std::reverse(path.begin(), path.end());
+		return true;
+	}
+
+	std::mutex mutex;  // serializes queries on this roadmap
+	JointSpaceIndex index;  // node positions
+	std::vector<Validity> nodes;
+	std::vector<Edge> edges;
+	std::vector<std::vector<uint32_t>> adjacency;  // edge indices per node
+	random_numbers::RandomNumberGenerator rng;
+};
+
+RoadmapPlanner::RoadmapPlanner() {
+	auto& p = properties();
+	p.declare<double>("max_step", 0.1, "max joint-space distance between waypoints");
+	p.declare<unsigned int>("neighbors", 10, "number of nearest neighbors to connect new nodes to");
+	p.declare<unsigned int>("samples_per_iteration", 50, "number of samples added when no path was found");
+	p.declare<unsigned int>("max_nodes", 20000, "max number of nodes per roadmap");
+	p.declare<unsigned int>("max_roadmaps", 16, "max number of roadmaps kept, least recently used ones are dropped");
+	p.declare<bool>("shortcut", true, "shortcut the roadmap path by straight segments");
+}
+
+RoadmapPlanner::~RoadmapPlanner() = default;
+
+void RoadmapPlanner::init(const core::RobotModelConstPtr& robot_model) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (robot_model_ != robot_model)  // roadmaps refer to groups of the previous model
+		roadmaps_.clear();
+	robot_model_ = robot_model;
+}
+
+std::shared_ptr<RoadmapPlanner::Roadmap> RoadmapPlanner::roadmapFor(const moveit::core::JointModelGroup* jmg,
+                                                                    std::size_t fingerprint) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto& entry = roadmaps_[Key(jmg->getName(), fingerprint)];
+	if (!entry.roadmap || entry.roadmap->group() != jmg)
+		entry.roadmap = std::make_shared<Roadmap>(jmg);
+	entry.last_used = ++uses_;
+	std::shared_ptr<Roadmap> roadmap = entry.roadmap;
+	evict();  // never drops entry, as it was used most recently
+	return roadmap;
+}
+
+void RoadmapPlanner::evict() {
+	const std::size_t max_roadmaps = properties().get<unsigned int>("max_roadmaps");
+	if (max_roadmaps == 0)
+		return;
+	// roadmaps still used by a running query stay alive until it finishes
+	while (roadmaps_.size() > max_roadmaps)
+		roadmaps_.erase(std::min_element(roadmaps_.begin(), roadmaps_.end(), [](const auto& a, const auto& b) {
+			return a.second.last_used < b.second.last_used;
+		}));
+}
+
+PlannerInterface::Result RoadmapPlanner::plan(const planning_scene::PlanningSceneConstPtr& from,
+                                              const planning_scene::PlanningSceneConstPtr& to,
+                                              const moveit::core::JointModelGroup* jmg, double timeout,
+                                              robot_trajectory::RobotTrajectoryPtr& result,
+                                              const moveit_msgs::Constraints& path_constraints) {
+	const auto& props = properties();
+	timeout = std::min(timeout, props.get<double>("timeout"));
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double, std::ratio<1>>(timeout);
+	const double max_step = props.get<double>("max_step");
+	const std::size_t neighbors = props.get<unsigned int>("neighbors");
+	const std::size_t samples = props.get<unsigned int>("samples_per_iteration");
+	const std::size_t max_nodes = props.get<unsigned int>("max_nodes");
+
+	const moveit::core::RobotState& from_state = from->getCurrentState();
+	const moveit::core::RobotState& to_state = to->getCurrentState();
+	std::vector<double> start_positions, goal_positions;
+	from_state.copyJointGroupPositions(jmg, start_positions);
+	to_state.copyJointGroupPositions(jmg, goal_positions);
+
+	// all checks are performed in the start scene, which equals the goal scene apart from jmg's joints
+	StateChecker checker(*from, jmg, path_constraints, max_step);
+	for (const auto& [positions, name] : { std::make_pair(&start_positions, "Start state"),
+	                                       std::make_pair(&goal_positions, "Goal state") }) {
+		switch (checker.check(positions->data())) {
+			case OUT_OF_BOUNDS:
+				return { false, std::string(name) + " is out of bounds!" };
+			case COLLIDING:
+				return { false, std::string(name) + " is in collision!" };
+			case VIOLATING:
+				return { false, std::string(name) + " violates the path constraints!" };
+			case OK:
+				break;
+		}
+	}
+
+	const std::shared_ptr<Roadmap> roadmap_ptr = roadmapFor(jmg, IKCache::sceneFingerprint(*from, jmg));
+	Roadmap& roadmap = *roadmap_ptr;
+	std::lock_guard<std::mutex> lock(roadmap.mutex);
+
+	const uint32_t start = roadmap.findOrAddNode(start_positions.data(), VALID, neighbors);
+	const uint32_t goal = roadmap.findOrAddNode(goal_positions.data(), VALID, neighbors);
+	if (start != goal && !roadmap.connected(start, goal))  // try the direct connection too
+		roadmap.addEdge(start, goal, jmg->distance(roadmap[start], roadmap[goal]), UNKNOWN);
+
+	// violations of the path constraints only apply to this query
+	std::vector<bool> blocked_nodes, blocked_edges;
+	auto block = [](std::vector<bool>& blocked, std::size_t index) {
+		if (blocked.size() <= index)
+			blocked.resize(index + 1, false);
+		blocked[index] = true;
+	};
+	auto validNode = [&](uint32_t node) {
+		if (roadmap.nodes[node] == UNKNOWN || checker.hasConstraints()) {
+			const Check check = checker.check(roadmap[node]);
+			if (roadmap.nodes[node] == UNKNOWN)
+				roadmap.nodes[node] = check == OUT_OF_BOUNDS || check == COLLIDING ? INVALID : VALID;
+			if (check == VIOLATING)
+				block(blocked_nodes, node);
+			return check == OK;
+		}
+		return roadmap.nodes[node] == VALID;
+	};
+	auto validEdge = [&](uint32_t index) {
+		Roadmap::Edge& edge = roadmap.edges[index];
+		if (edge.validity == INVALID)
+			return false;
+		const Check check = checker.checkSegment(roadmap[edge.a], roadmap[edge.b], edge.length, edge.validity == VALID);
+		if (check == COLLIDING)
+			edge.validity = INVALID;
+		else if (check == VIOLATING)
+			block(blocked_edges, index);
+		else
+			edge.validity = VALID;
+		return check == OK;
+	};
+
+	// search the roadmap, lazily validating the shortest path, and grow the roadmap while there is none
+	Roadmap::Path path;
+	while (true) {
+		if (std::chrono::steady_clock::now() >= deadline)
+			return { false, "timeout" };
+
+		if (roadmap.shortestPath(start, goal, blocked_nodes, blocked_edges, path)) {
+			// nodes are cheaper to check than edges, thus check them first
+			bool valid = true;
+			uint32_t node = start;
+			for (uint32_t edge : path) {
+				node = roadmap.edges[edge].other(node);
+				valid = valid && validNode(node);
+			}
+			for (uint32_t edge : path)
+				valid = valid && validEdge(edge);
+			if (valid)
+				break;
+			continue;
+		}
+
+		if (roadmap.size() >= max_nodes)
+			return { false, "no path found in roadmap of " + std::to_string(roadmap.size()) + " nodes" };
+		moveit::core::RobotState sample(from_state);
+		std::vector<double> positions;
+		for (std::size_t i = 0; i < samples && roadmap.size() < max_nodes; ++i) {
+			sample.setToRandomPositions(jmg, roadmap.rng);
+			sample.copyJointGroupPositions(jmg, positions);
+			roadmap.addNode(positions.data(), UNKNOWN, neighbors);
+		}
+	}
+
+	// collect the configurations along the path
+	std::vector<const double*> configurations{ roadmap[start] };
+	uint32_t node = start;
+	for (uint32_t edge : path) {
+		node = roadmap.edges[edge].other(node);
+		configurations.push_back(roadmap[node]);
+	}
+
+	// greedily shortcut the path, connecting each configuration to the farthest one reachable on a straight line
+	if (props.get<bool>("shortcut") && configurations.size() > 2) {
+		std::vector<const double*> shortcut{ configurations.front() };
+		for (std::size_t i = 0; i + 1 < configurations.size();) {
+			std::size_t j = configurations.size() - 1;
+			for (; j > i + 1; --j)
+				if (checker.checkSegment(configurations[i], configurations[j],
+				                         jmg->distance(configurations[i], configurations[j])) == OK)
+					break;
+			shortcut.push_back(configurations[j]);
+			i = j;
+		}
+		configurations.swap(shortcut);
+	}
+
+	// densify to max_step, keeping the exact start and goal states
+	result = std::make_shared<robot_trajectory::RobotTrajectory>(from->getRobotModel(), jmg);
+	result->addSuffixWayPoint(from_state, 0.0);
+	moveit::core::RobotState waypoint(from_state);
+	std::vector<double> positions(jmg->getVariableCount());
+	for (std::size_t i = 0; i + 1 < configurations.size(); ++i) {
+		const double length = jmg->distance(configurations[i], configurations[i + 1]);
+		const std::size_t steps = std::max<std::size_t>(1, std::ceil(length / max_step));
+		for (std::size_t k = 1; k <= steps; ++k) {
+			if (i + 2 == configurations.size() && k == steps)
+				break;  // goal state is added below
+			jmg->interpolate(configurations[i], configurations[i + 1], static_cast<double>(k) / steps, positions.data());
+			waypoint.setJointGroupPositions(jmg, positions);
+			waypoint.update();
+			result->addSuffixWayPoint(waypoint, 0.0);
+		}
+	}
+	result->addSuffixWayPoint(to_state, 0.0);
+
+	auto timing = props.get<TimeParameterizationPtr>("time_parameterization");
+	if (timing)
+		timing->computeTimeStamps(*result, props.get<double>("max_velocity_scaling_factor"),
+		                          props.get<double>("max_acceleration_scaling_factor"));
+	return { true, "" };
+}
+
+PlannerInterface::Result RoadmapPlanner::plan(const planning_scene::PlanningSceneConstPtr& from,
+                                              const moveit::core::LinkModel& link, const Eigen::Isometry3d& offset,
+                                              const Eigen::Isometry3d& target, const moveit::core::JointModelGroup* jmg,
+                                              double timeout, robot_trajectory::RobotTrajectoryPtr& result,
+                                              const moveit_msgs::Constraints& path_constraints) {
+	timeout = std::min(timeout, properties().get<double>("timeout"));
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double, std::ratio<1>>(timeout);
+
+	auto to{ from->diff() };
+
+	kinematic_constraints::KinematicConstraintSet constraints{ to->getRobotModel() };
+	constraints.add(path_constraints, from->getTransforms());
+
+	auto is_valid{ [&constraints, &to](moveit::core::RobotState* robot_state, const moveit::core::JointModelGroup* jmg,
+		                                const double* joint_values) -> bool {
+		robot_state->setJointGroupPositions(jmg, joint_values);
+		robot_state->update();
+		return to->isStateValid(*robot_state, constraints, jmg->getName());
+	} };
+
+	if (!to->getCurrentStateNonConst().setFromIK(jmg, target * offset.inverse(), link.getName(), timeout, is_valid))
+		return { false, "IK failed for pose target." };
+	to->getCurrentStateNonConst().update();
+
+	const double remaining = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+	if (remaining <= 0)
+		return { false, "timeout" };
+
+	return plan(from, to, jmg, remaining, result, path_constraints);
+}
+
+std::size_t RoadmapPlanner::numRoadmaps() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return roadmaps_.size();
+}
+
+std::size_t RoadmapPlanner::numNodes() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::size_t nodes = 0;
+	for (const auto& entry : roadmaps_) {
+		std::lock_guard<std::mutex> roadmap_lock(entry.second.roadmap->mutex);
+		nodes += entry.second.roadmap->size();
+	}
+	return nodes;
+}
+
+void RoadmapPlanner::clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	roadmaps_.clear();
+}
+
+void RoadmapPlanner::save(const std::string& file) const {
+	std::ofstream out(file, std::ios::binary | std::ios::trunc);
+	out.write(MAGIC, sizeof(MAGIC));
+	write(out, VERSION);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	write<uint32_t>(out, roadmaps_.size());
+	for (const auto& [key, entry] : roadmaps_) {
+		const std::shared_ptr<Roadmap>& roadmap = entry.roadmap;
+		std::lock_guard<std::mutex> roadmap_lock(roadmap->mutex);
+		const std::size_t dimension = roadmap->group()->getVariableCount();
+		write<uint32_t>(out, key.first.size());
+		out.write(key.first.data(), key.first.size());
+		write<uint64_t>(out, key.second);
+		write<uint32_t>(out, dimension);
+		write<uint64_t>(out, roadmap->size());
+		write<uint64_t>(out, roadmap->edges.size());
+		for (std::size_t i = 0; i < roadmap->size(); ++i) {
+			out.write(reinterpret_cast<const char*>((*roadmap)[i]), dimension * sizeof(double));
+			write<uint8_t>(out, roadmap->nodes[i]);
+		}
+		for (const Roadmap::Edge& edge : roadmap->edges) {
+			write(out, edge.a);
+			write(out, edge.b);
+			write(out, edge.length);
+			write<uint8_t>(out, edge.validity);
+		}
+	}
+	if (!out)
+		throw std::runtime_error("failed to write roadmaps: " + file);
+}
+
+void RoadmapPlanner::load(const std::string& file, const moveit::core::RobotModelConstPtr& robot_model) {
+	std::ifstream in(file, std::ios::binary);
+	if (!in)
+		throw std::runtime_error("failed to open roadmaps: " + file);
+	char magic[sizeof(MAGIC)];
+	in.read(magic, sizeof(magic));
+	if (!in || !std::equal(magic, magic + sizeof(MAGIC), MAGIC) || read<uint32_t>(in) != VERSION)
+		throw std::runtime_error("incompatible roadmaps: " + file);
+
+	// parse everything before modifying any roadmap
+	std::map<Key, std::shared_ptr<Roadmap>> loaded;
+	for (uint32_t count = read<uint32_t>(in); in && count > 0; --count) {
+		std::string group(read<uint32_t>(in), '\0');
+		in.read(&group[0], group.size());
+		const std::size_t fingerprint = read<uint64_t>(in);
+		const std::size_t dimension = read<uint32_t>(in);
+		const uint64_t num_nodes = read<uint64_t>(in);
+		const uint64_t num_edges = read<uint64_t>(in);
+		if (!in)
+			break;
+
+		const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(group);
+		if (!jmg || jmg->getVariableCount() != dimension)
+			throw std::runtime_error("roadmap of group '" + group + "' doesn't match the robot model: " + file);
+
+		auto roadmap = std::make_shared<Roadmap>(jmg);
+		std::vector<double> positions(dimension);
+		for (uint64_t i = 0; i < num_nodes && in; ++i) {
+			in.read(reinterpret_cast<char*>(positions.data()), dimension * sizeof(double));
+			roadmap->index.insert(positions.data());
+			roadmap->nodes.push_back(static_cast<Validity>(read<uint8_t>(in)));
+			roadmap->adjacency.emplace_back();
+		}
+		for (uint64_t i = 0; i < num_edges && in; ++i) {
+			const uint32_t a = read<uint32_t>(in);
+			const uint32_t b = read<uint32_t>(in);
+			const double length = read<double>(in);
+			const auto validity = static_cast<Validity>(read<uint8_t>(in));
+			if (a >= num_nodes || b >= num_nodes)
+				throw std::runtime_error("invalid roadmap edge: " + file);
+			roadmap->addEdge(a, b, length, validity);
+		}
+		loaded[Key(group, fingerprint)] = roadmap;
+	}
+	if (!in)
+		throw std::runtime_error("truncated roadmaps: " + file);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (robot_model_ != robot_model)
+		roadmaps_.clear();
+	robot_model_ = robot_model;
+	for (auto& entry : loaded)
+		roadmaps_[entry.first] = Entry{ std::move(entry.second), ++uses_ };
+	evict();
+}
+}  // namespace solvers
+}  // namespace task_constructor
+}  // namespace moveit
@@ -0,0 +1,274 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/task_constructor/sphere_collision_filter.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_state/robot_state.h>
+#include <geometric_shapes/shape_operations.h>
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <set>
+
+namespace moveit {
+namespace task_constructor {
+
+namespace {
+struct Sphere
+{
+	Eigen::Vector3d center;
+	double radius;
+	bool exact;  // shape is a sphere
+};
+
+// bounding sphere of shape, given its pose, scaled and padded as by the collision environment
+Sphere boundingSphere(const shapes::Shape& shape, const Eigen::Isometry3d& pose, double scale = 1.0,
+                      double padding = 0.0) {
+	Sphere sphere;
+	sphere.exact = shape.type == shapes::SPHERE;
+	if (shape.type == shapes::PLANE || shape.type == shapes::OCTREE) {
+		sphere.center = pose.translation();
+		sphere.radius = std::numeric_limits<double>::infinity();
+		return sphere;
+	}
+	// padding inflates each face of a box or cylinder, thus bound the actually scaled and padded shape
+	const shapes::Shape* bounded = &shape;
+	std::unique_ptr<shapes::Shape> scaled;
+	if (scale != 1.0 || padding != 0.0) {
+		scaled.reset(shape.clone());
+		scaled->scaleAndPadd(scale, padding);
+		bounded = scaled.get();
+	}
+	Eigen::Vector3d center;
+	shapes::computeShapeBoundingSphere(bounded, center, sphere.radius);
+	sphere.center = pose * center;
+	return sphere;
+}
+
+using collision_detection::AllowedCollision::Type;
+
+// allowed collision type of pair, mimicking AllowedCollisionMatrix::getAllowedCollision()
+Type allowedCollision(const collision_detection::AllowedCollisionMatrix& acm, const std::string& a,
+                      const std::string& b) {
+	Type type;
+	if (acm.getEntry(a, b, type))
+		return type;
+	Type type_a, type_b;
+	bool found_a = acm.getDefaultEntry(a, type_a);
+	bool found_b = acm.getDefaultEntry(b, type_b);
+	if (!found_a && !found_b)
+		return collision_detection::AllowedCollision::NEVER;
+	if (!found_b)
+		return type_a;
+	if (!found_a)
+		return type_b;
+	if (type_a == collision_detection::AllowedCollision::NEVER || type_b == collision_detection::AllowedCollision::NEVER)
+		return collision_detection::AllowedCollision::NEVER;
+	if (type_a == collision_detection::AllowedCollision::CONDITIONAL ||
+	    type_b == collision_detection::AllowedCollision::CONDITIONAL)
+		return collision_detection::AllowedCollision::CONDITIONAL;
+	return collision_detection::AllowedCollision::ALWAYS;
+}
+}  // namespace
+
+SphereCollisionFilter::SphereCollisionFilter(const planning_scene::PlanningSceneConstPtr& scene,
+                                             const moveit::core::JointModelGroup* jmg)
+  : scene_(scene), group_name_(jmg ? jmg->getName() : std::string()) {
+	const moveit::core::RobotModel& robot_model = *scene->getRobotModel();
+	const moveit::core::RobotState& state = scene->getCurrentState();
+	const collision_detection::AllowedCollisionMatrix& acm = scene->getAllowedCollisionMatrix();
+	const auto& env = scene->getCollisionEnv();
+
+	std::set<const moveit::core::LinkModel*> active_links;
+	if (jmg) {
+		const auto& links = jmg->getUpdatedLinkModelsWithGeometry();
+		active_links.insert(links.begin(), links.end());
+	}
+
+	// robot spheres: one per link (enclosing all its shapes) and one per shape of attached bodies
+	struct RobotSphere
+	{
+		Sphere sphere;
+		const std::string* name;  // name used for ACM lookup
+		const std::set<std::string>* touch_links;
+		bool active;
+	};
+	std::vector<RobotSphere> robot;
+	for (const moveit::core::LinkModel* link : robot_model.getLinkModelsWithCollisionGeometry()) {
+		const auto& shapes = link->getShapes();
+		const auto& origins = link->getCollisionOriginTransforms();
+		const double scale = env->getLinkScale(link->getName());
+		const double padding = env->getLinkPadding(link->getName());
+
+		std::vector<Sphere> spheres;
+		for (std::size_t i = 0; i < shapes.size(); ++i)
+			spheres.push_back(boundingSphere(*shapes[i], origins[i], scale, padding));
+		if (spheres.empty())
+			continue;
+
+		// enclose all shape spheres by a single sphere around their mean center
+		Sphere sphere{ Eigen::Vector3d::Zero(), 0.0, spheres.size() == 1 && spheres.front().exact };
+		for (const Sphere& s : spheres)
+			sphere.center += s.center / spheres.size();
+		for (const Sphere& s : spheres)
+			sphere.radius = std::max(sphere.radius, (s.center - sphere.center).norm() + s.radius);
+
+		links_.push_back(LinkSphere{ link, sphere.center });
+		robot.push_back(RobotSphere{ sphere, &link->getName(), nullptr, !jmg || active_links.count(link) > 0 });
+	}
+
+	std::vector<const moveit::core::AttachedBody*> attached;
+	state.getAttachedBodies(attached);
+	for (const moveit::core::AttachedBody* body : attached) {
+		const moveit::core::LinkModel* link = body->getAttachedLink();
+		const double padding = env->getLinkPadding(link->getName());
+		const auto& poses = body->getShapePosesInLinkFrame();
+		for (std::size_t i = 0; i < body->getShapes().size(); ++i) {
+			Sphere sphere = boundingSphere(*body->getShapes()[i], poses[i], 1.0, padding);
+			sphere.exact = false;
+			links_.push_back(LinkSphere{ link, sphere.center });
+			robot.push_back(RobotSphere{ sphere, &body->getName(), &body->getTouchLinks(),
+			                             !jmg || active_links.count(link) > 0 });
+		}
+	}
+
+	// world spheres: one per shape
+	std::vector<Sphere> world;
+	std::vector<const std::string*> world_names;
+	for (const auto& object_pair : *scene->getWorld()) {
+		const collision_detection::World::Object& object = *object_pair.second;
+		for (std::size_t i = 0; i < object.shapes_.size(); ++i) {
+			world.push_back(boundingSphere(*object.shapes_[i], object.global_shape_poses_[i]));
+			world_names.push_back(&object_pair.first);
+		}
+	}
+
+	const Eigen::Index n = robot.size();
+	const Eigen::Index m = world.size();
+	world_centers_.resize(3, m);
+	for (Eigen::Index j = 0; j < m; ++j)
+		world_centers_.col(j) = world[j].center;
+
+	world_thresholds_.setConstant(n, m, -1.0);
+	world_exact_.setConstant(n, m, false);
+	for (Eigen::Index i = 0; i < n; ++i) {
+		if (!robot[i].active)
+			continue;
+		for (Eigen::Index j = 0; j < m; ++j) {
+			Type type = allowedCollision(acm, *robot[i].name, *world_names[j]);
+			if (type == collision_detection::AllowedCollision::ALWAYS)
+				continue;
+			world_thresholds_(i, j) = std::pow(robot[i].sphere.radius + world[j].radius, 2);
+			world_exact_(i, j) = type == collision_detection::AllowedCollision::NEVER && robot[i].sphere.exact &&
+			                     world[j].exact;
+		}
+	}
+
+	self_thresholds_.setConstant(n, n, -1.0);
+	self_exact_.setConstant(n, n, false);
+	for (Eigen::Index i = 0; i < n; ++i) {
+		for (Eigen::Index j = i + 1; j < n; ++j) {
+			const RobotSphere& a = robot[i];
+			const RobotSphere& b = robot[j];
+			if (!(a.active || b.active) || a.name == b.name || links_[i].link == links_[j].link)
+				continue;
+			if ((a.touch_links && a.touch_links->count(*b.name)) || (b.touch_links && b.touch_links->count(*a.name)))
+				continue;
+			Type type = allowedCollision(acm, *a.name, *b.name);
+			if (type == collision_detection::AllowedCollision::ALWAYS)
+				continue;
+			self_thresholds_(i, j) = std::pow(a.sphere.radius + b.sphere.radius, 2);
+			self_exact_(i, j) = type == collision_detection::AllowedCollision::NEVER && a.sphere.exact && b.sphere.exact;
+		}
+	}
+}
+
+SphereCollisionFilter::Result SphereCollisionFilter::check(const moveit::core::RobotState& state) const {
+	if (state.dirtyLinkTransforms())
+		return UNKNOWN;
+
+	const Eigen::Index n = links_.size();
+	// per-thread buffer of sphere centers, only growing: no allocations in the hot path
+	thread_local Eigen::Matrix3Xd centers;
+	if (centers.cols() < n)
+		centers.resize(3, n);
+	for (Eigen::Index i = 0; i < n; ++i)
+		centers.col(i) = state.getGlobalLinkTransform(links_[i].link) * links_[i].center;
+
+	// distances are evaluated lazily within the reductions below, i.e. without temporaries
+	bool overlapping = false;
+	if (world_centers_.cols() > 0) {
+		for (Eigen::Index i = 0; i < n; ++i) {
+			if ((world_thresholds_.row(i) < 0).all())
+				continue;
+			const Eigen::Vector3d center = centers.col(i);
+			const auto overlap =
+			    (world_centers_.colwise() - center).colwise().squaredNorm().array() < world_thresholds_.row(i);
+			if ((overlap && world_exact_.row(i)).any())
+				return COLLIDING;
+			overlapping = overlapping || overlap.any();
+		}
+	}
+
+	for (Eigen::Index i = 0; i + 1 < n; ++i) {
+		const Eigen::Index count = n - i - 1;
+		const auto thresholds = self_thresholds_.row(i).tail(count);
+		if ((thresholds < 0).all())
+			continue;
+		const Eigen::Vector3d center = centers.col(i);
+		const auto overlap = (centers.middleCols(i + 1, count).colwise() - center).colwise().squaredNorm().array() <
+		                     thresholds;
+		if ((overlap && self_exact_.row(i).tail(count)).any())
+			return COLLIDING;
+		overlapping = overlapping || overlap.any();
+	}
+
+	return overlapping ? UNKNOWN : FREE;
+}
+
+bool SphereCollisionFilter::isStateColliding(const moveit::core::RobotState& state) const {
+	switch (check(state)) {
+		case FREE:
+			return false;
+		case COLLIDING:
+			return true;
+		default:
+			return scene_->isStateColliding(state, group_name_);
+	}
+}
+}  // namespace task_constructor
+}  // namespace moveit
@@ -38,11 +38,14 @@
 #include <moveit/task_constructor/stage_p.h>
 #include <moveit/task_constructor/container_p.h>
 #include <moveit/task_constructor/introspection.h>
+#include <moveit/task_constructor/ik_cache.h>
+#include <moveit/task_constructor/trajectory_validation.h>
 #include <moveit/task_constructor/fmt_p.h>
 
 #include <moveit/planning_scene/planning_scene.h>
 
 #include <ros/console.h>
+#include <boost/functional/hash.hpp>
 
 #include <iostream>
 #include <iomanip>
@@ -103,7 +106,9 @@ StagePrivate::StagePrivate(Stage* me, const std::string& name)
   , total_compute_time_{}
   , parent_{ nullptr }
   , introspection_{ nullptr }
-  , preempt_requested_{ nullptr } {}
+  , preempt_requested_{ nullptr }
+  , reset_run_only_{ nullptr }
+  , replanning_{ nullptr } {}
 
 StagePrivate& StagePrivate::operator=(StagePrivate&& other) {
 	assert(typeid(*this) == typeid(other));
@@ -342,12 +347,21 @@ void Stage::reset() {
 		impl->starts_->clear();
 	if (impl->ends_)
 		impl->ends_->clear();
+	impl->total_compute_time_ = std::chrono::duration<double>::zero();
+	// keep the results of the last run only for replanning
+	if (auto* compute = dynamic_cast<ComputeBasePrivate*>(impl))
+		compute->replay_.reset(impl->resetRunOnly() && impl->replanning(), impl->properties_);
+	if (impl->resetRunOnly()) {
+		// keep initialization for the next run, but drop values of the last run's interface states
+		impl->properties_.reset(INTERFACE);
+		return;
+	}
+
 	// reset push interfaces
 	impl->prev_ends_.reset();
 	impl->next_starts_.reset();
 	// reset inherited properties
 	impl->properties_.reset();
-	impl->total_compute_time_ = std::chrono::duration<double>::zero();
 }
 
 void Stage::init(const moveit::core::RobotModelConstPtr& /* robot_model */) {
@@ -369,6 +383,29 @@ void Stage::init(const moveit::core::RobotModelConstPtr& /* robot_model */) {
 	}
 }
 
+Stage::pointer Stage::cloneStage() const {
+	throw std::runtime_error(name() + ": stage type doesn't support cloning");
+}
+
+void Stage::copyConfigTo(Stage& other) const {
+	auto impl = pimpl();
+	auto other_impl = other.pimpl();
+	other_impl->name_ = impl->name_;
+	other_impl->properties_ = impl->properties_;
+	other_impl->cost_term_ = impl->cost_term_;
+
+	// configuration held by intermediate base classes
+	const auto* propagating = dynamic_cast<const PropagatingEitherWayPrivate*>(impl);
+	auto* other_propagating = dynamic_cast<PropagatingEitherWayPrivate*>(other_impl);
+	if (propagating && other_propagating)
+		other_propagating->configured_dir_ = propagating->configured_dir_;
+	// Task::clone() redirects the monitored stage to its copy
+	const auto* monitoring = dynamic_cast<const MonitoringGeneratorPrivate*>(impl);
+	auto* other_monitoring = dynamic_cast<MonitoringGenerator*>(&other);
+	if (monitoring && other_monitoring)
+		other_monitoring->setMonitoredStage(monitoring->monitored_);
+}
+
 const ContainerBase* Stage::parent() const {
 	return pimpl_->parent_;
 }
@@ -504,6 +541,116 @@ std::ostream& operator<<(std::ostream& os, const StagePrivate& impl) {
 	return os;
 }
 
+void ReplayCache::reset(bool keep, const PropertyMap& stage_properties) {
+	previous_.clear();
+	config_.clear();
+	if (keep) {
+		for (const auto& pair : stage_properties)
+			if (!pair.second.initsFrom(Stage::INTERFACE))
+				config_.push_back(pair.second.serialize());
+		// equivalent inputs yield the same results: keep those of the first input only to avoid duplicates
+		using Inputs = std::pair<const InterfaceState*, const InterfaceState*>;
+		std::unordered_map<std::size_t, Inputs> inputs;
+		for (Result& result : recorded_) {
+			std::size_t key = this->key(*result.input.scene, result.input.properties);
+			if (key && result.end.scene) {
+				const std::size_t end_key = this->key(*result.end.scene, result.end.properties);
+				boost::hash_combine(key, end_key);
+				key = end_key ? key : 0;
+			}
+			if (!key)
+				continue;
+			const Inputs current(result.input.state, result.end.state);
+			if (inputs.emplace(key, current).first->second == current)
+				previous_.emplace(key, std::move(result));
+		}
+	}
+	recorded_.clear();
+}
+
+std::size_t ReplayCache::key(const planning_scene::PlanningScene& scene, const PropertyMap& properties) const {
+	// trajectories need to continue from the exact same robot state, carrying the same objects
+	const moveit::core::RobotState& state = scene.getCurrentState();
+	std::size_t seed = 0;
+	boost::hash_range(seed, state.getVariablePositions(), state.getVariablePositions() + state.getVariableCount());
+	std::vector<const moveit::core::AttachedBody*> attached;
+	state.getAttachedBodies(attached);
+	std::sort(attached.begin(), attached.end(),
+	          [](const auto* a, const auto* b) { return a->getName() < b->getName(); });
+	for (const moveit::core::AttachedBody* body : attached) {
+		boost::hash_combine(seed, body->getName());
+		boost::hash_combine(seed, IKCache::objectFingerprint(scene, body->getName()));
+	}
+
+	std::vector<std::string> wires;
+	for (const auto& pair : properties) {
+		std::string wire = pair.second.serialize();
+		if (wire.empty() && !pair.second.value().empty())
+			return 0;  // cannot tell whether the value changed
+		boost::hash_combine(seed, pair.first);
+		boost::hash_combine(seed, wire);
+		wires.push_back(std::move(wire));
+	}
+
+	// collision objects referred to by name, e.g. as frame of a target pose
+	auto refers_to = [this, &wires](const std::string& id) {
+		auto contains = [&id](const std::string& wire) { return wire.find(id) != std::string::npos; };
+		return std::any_of(config_.begin(), config_.end(), contains) ||
+		       std::any_of(wires.begin(), wires.end(), contains);
+	};
+	for (const auto& object : *scene.getWorld())
+		if (refers_to(object.first)) {
+			boost::hash_combine(seed, object.first);
+			boost::hash_combine(seed, IKCache::objectFingerprint(scene, object.first));
+		}
+	return seed ? seed : 1;
+}
+
+std::vector<const ReplayCache::Result*> ReplayCache::find(const InterfaceState& input,
+                                                         const InterfaceState* end) const {
+	std::vector<const Result*> results;
+	std::size_t key = this->key(*input.scene(), input.properties());
+	if (key && end) {
+		const std::size_t end_key = this->key(*end->scene(), end->properties());
+		boost::hash_combine(key, end_key);
+		key = end_key ? key : 0;
+	}
+	if (!key)
+		return results;
+	auto range = previous_.equal_range(key);
+	for (auto it = range.first; it != range.second; ++it)
+		results.push_back(&it->second);
+	return results;
+}
+
+planning_scene::PlanningScenePtr ReplayCache::rebase(const Result& result,
+                                                     const planning_scene::PlanningSceneConstPtr& scene) {
+	moveit_msgs::PlanningScene diff;
+	result.created.scene->getPlanningSceneDiffMsg(diff);
+
+	// objects modified by the result, e.g. attached ones, need to be unchanged
+	auto unchanged = [&result, &scene](const std::string& id) {
+		return IKCache::objectFingerprint(*result.input.scene, id) == IKCache::objectFingerprint(*scene, id);
+	};
+	for (const auto& object : diff.world.collision_objects)
+		if (!unchanged(object.id))
+			return nullptr;
+	for (const auto& object : diff.robot_state.attached_collision_objects)
+		if (!unchanged(object.object.id))
+			return nullptr;
+	if (!diff.allowed_collision_matrix.entry_names.empty()) {
+		moveit_msgs::AllowedCollisionMatrix previous, current;
+		result.input.scene->getAllowedCollisionMatrix().getMessage(previous);
+		scene->getAllowedCollisionMatrix().getMessage(current);
+		if (previous != current)
+			return nullptr;
+	}
+
+	planning_scene::PlanningScenePtr rebased = scene->diff();
+	rebased->setPlanningSceneDiffMsg(diff);
+	return rebased;
+}
+
 ComputeBase::ComputeBase(ComputeBasePrivate* impl) : Stage(impl) {}
 
 PropagatingEitherWayPrivate::PropagatingEitherWayPrivate(PropagatingEitherWay* me, PropagatingEitherWay::Direction dir,
@@ -588,14 +735,41 @@ void PropagatingEitherWayPrivate::compute() {
 		const InterfaceState& state = fetchStartState();
 		// enforce property initialization from INTERFACE
 		properties_.performInitFrom(Stage::INTERFACE, state.properties());
-		me->computeForward(state);
+		if (!replay<Interface::FORWARD>(state))
+			me->computeForward(state);
 	}
 	if (hasEndState()) {
 		const InterfaceState& state = fetchEndState();
 		// enforce property initialization from INTERFACE
 		properties_.performInitFrom(Stage::INTERFACE, state.properties());
-		me->computeBackward(state);
+		if (!replay<Interface::BACKWARD>(state))
+			me->computeBackward(state);
+	}
+}
+
+template <Interface::Direction dir>
+bool PropagatingEitherWayPrivate::replay(const InterfaceState& state) {
+	if (replay_.empty())
+		return false;
+
+	bool replayed = false;
+	for (const ReplayCache::Result* result : replay_.find(state)) {
+		planning_scene::PlanningScenePtr scene = ReplayCache::rebase(*result, state.scene());
+		if (!scene)
+			continue;
+		// forward trajectories run in the input scene, backward ones in the created scene
+		const planning_scene::PlanningScene& trajectory_scene = dir == Interface::FORWARD ? *state.scene() : *scene;
+		if (result->trajectory && !isPathValid(trajectory_scene, *result->trajectory))
+			continue;
+
+		InterfaceState created(scene);
+		created.properties() = result->created.properties;
+		SubTrajectory trajectory(result->trajectory, 0.0, result->comment);
+		trajectory.markers() = result->markers;
+		static_cast<PropagatingEitherWay*>(me_)->send<dir>(state, std::move(created), std::move(trajectory));
+		replayed = true;
 	}
+	return replayed;
 }
 
 PropagatingEitherWay::PropagatingEitherWay(const std::string& name)
@@ -615,7 +789,18 @@ void PropagatingEitherWay::restrictDirection(PropagatingEitherWay::Direction dir
 
 template <Interface::Direction dir>
 void PropagatingEitherWay::send(const InterfaceState& start, InterfaceState&& end, SubTrajectory&& trajectory) {
-	pimpl()->send<dir>(start, std::move(end), std::make_shared<SubTrajectory>(std::move(trajectory)));
+	auto impl = pimpl();
+	// record successful results for replanning, which can replay them only as diffs of the start scene
+	if (!trajectory.isFailure() && end.scene()->getParent() == start.scene()) {
+		ReplayCache::Result result{ { &start, start.scene(), start.properties() },
+		                            {},
+		                            { nullptr, end.scene(), end.properties() },
+		                            trajectory.trajectory(),
+		                            trajectory.comment(),
+		                            trajectory.markers() };
+		impl->replay_.record(std::move(result));
+	}
+	impl->send<dir>(start, std::move(end), std::make_shared<SubTrajectory>(std::move(trajectory)));
 }
 // Explicit template instantiation is required. The compiler, otherwise, might just inline them.
 template void PropagatingEitherWay::send<Interface::FORWARD>(const InterfaceState& start, InterfaceState&& end,
@@ -675,10 +860,17 @@ InterfaceFlags GeneratorPrivate::requiredInterface() const {
 }
 
 bool GeneratorPrivate::canCompute() const {
+	if (substituted_)
+		return static_cast<bool>(substitute_);
 	return static_cast<Generator*>(me_)->canCompute();
 }
 
 void GeneratorPrivate::compute() {
+	if (substituted_) {
+		spawn(InterfaceState(substitute_), std::make_shared<SubTrajectory>());
+		substitute_.reset();
+		return;
+	}
 	static_cast<Generator*>(me_)->compute();
 }
 
@@ -879,7 +1071,24 @@ void ConnectingPrivate::compute() {
 	const InterfaceState& from = *top.first;
 	const InterfaceState& to = *top.second;
 	assert(from.priority().enabled() && to.priority().enabled());
-	static_cast<Connecting*>(me_)->compute(from, to);
+	if (!replay(from, to))
+		static_cast<Connecting*>(me_)->compute(from, to);
+}
+
+bool ConnectingPrivate::replay(const InterfaceState& from, const InterfaceState& to) {
+	if (replay_.empty())
+		return false;
+
+	bool replayed = false;
+	for (const ReplayCache::Result* result : replay_.find(from, &to)) {
+		if (result->trajectory && !isPathValid(*from.scene(), *result->trajectory))
+			continue;
+		auto trajectory = std::make_shared<SubTrajectory>(result->trajectory, 0.0, result->comment);
+		trajectory->markers() = result->markers;
+		static_cast<Connecting*>(me_)->connect(from, to, trajectory);
+		replayed = true;
+	}
+	return replayed;
 }
 
 std::ostream& operator<<(std::ostream& os, const PendingPairsPrinter& p) {
@@ -973,7 +1182,19 @@ bool Connecting::compatible(const InterfaceState& from_state, const InterfaceSta
 }
 
 void Connecting::connect(const InterfaceState& from, const InterfaceState& to, const SolutionBasePtr& s) {
-	pimpl()->connect(from, to, s);
+	auto impl = pimpl();
+	// record successful plain trajectories for replanning
+	const auto* trajectory = dynamic_cast<const SubTrajectory*>(s.get());
+	if (trajectory && !trajectory->isFailure()) {
+		ReplayCache::Result result{ { &from, from.scene(), from.properties() },
+		                            { &to, to.scene(), to.properties() },
+		                            {},
+		                            trajectory->trajectory(),
+		                            trajectory->comment(),
+		                            trajectory->markers() };
+		impl->replay_.record(std::move(result));
+	}
+	impl->connect(from, to, s);
 }
 
 std::ostream& operator<<(std::ostream& os, const Stage& stage) {
@@ -38,16 +38,31 @@
 #include <moveit/task_constructor/storage.h>
 #include <moveit/task_constructor/marker_tools.h>
 #include <moveit/task_constructor/fmt_p.h>
+#include <moveit/task_constructor/joint_space_index.h>
+#include <moveit/task_constructor/sphere_collision_filter.h>
 
 #include <moveit/planning_scene/planning_scene.h>
+#include <moveit/kinematic_constraints/utils.h>
 #include <moveit/robot_state/conversions.h>
 #include <moveit/robot_state/robot_state.h>
 
+#include <moveit/kinematics_base/kinematics_base.h>
+
 #include <Eigen/Geometry>
 #include <tf2_eigen/tf2_eigen.h>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <iterator>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 #include <ros/console.h>
 
 namespace moveit {
@@ -63,6 +78,13 @@ ComputeIK::ComputeIK(const std::string& name, Stage::pointer&& child) : WrapperB
 	p.declare<bool>("ignore_collisions", false);
 	p.declare<double>("min_solution_distance", 0.1,
 	                  "minimum distance between seperate IK solutions for the same target");
+	p.declare<bool>("collision_prefilter", false,
+	                "skip full collision checks for states found collision-free by spheres");
+	p.declare<uint32_t>("num_threads", 1,
+	                    "number of threads sampling IK solutions in parallel (using separate solver instances)");
+	p.declare<uint32_t>("batch_size", 1, "max number of upstream solutions processed per compute() call");
+	p.declare<uint32_t>("warm_start_seeds", 0, "max number of seeds taken from solutions of nearby targets");
+	p.declare<double>("warm_start_radius", 0.05, "max distance of nearby targets (position + 0.1 * rotation angle)");
 	p.declare<moveit_msgs::Constraints>("constraints", moveit_msgs::Constraints(), "additional constraints to obey");
 
 	// ik_frame and target_pose are read from the interface
@@ -70,6 +92,19 @@ ComputeIK::ComputeIK(const std::string& name, Stage::pointer&& child) : WrapperB
 	p.declare<geometry_msgs::PoseStamped>("target_pose", "goal pose for ik frame");
 }
 
+ComputeIK::~ComputeIK() = default;
+
+Stage::pointer ComputeIK::cloneStage() const {
+	auto copy = std::make_unique<ComputeIK>(name());
+	copyConfigTo(*copy);
+	// sharing the IK cache and reachability map
+	copy->ik_cache_ = ik_cache_;
+	copy->reachability_map_ = reachability_map_;
+	copy->unreachable_timeout_ = unreachable_timeout_;
+	cloneChildrenTo(*copy);
+	return copy;
+}
+
 void ComputeIK::setIKFrame(const Eigen::Isometry3d& pose, const std::string& link) {
 	geometry_msgs::PoseStamped pose_msg;
 	pose_msg.header.frame_id = link;
@@ -94,7 +129,8 @@ struct IKSolution
 	bool satisfies_constraints;
 };
 
-using IKSolutions = std::vector<IKSolution>;
+// deque: references to elements remain valid while appending (from multiple threads)
+using IKSolutions = std::deque<IKSolution>;
 
 namespace {
 
@@ -140,6 +176,61 @@ bool isTargetPoseCollidingInEEF(const planning_scene::PlanningSceneConstPtr& sce
 	return res.collision;
 }
 
+std::string stripLeadingSlash(const std::string& frame) {
+	return (!frame.empty() && frame[0] == '/') ? frame.substr(1) : frame;
+}
+
+/** Solve IK using the given solver instance instead of the group's shared one
+ *
+ * This mimicks RobotState::setFromIK() for a single (rigidly attached) tip, allowing
+ * for concurrent IK queries using separate solver instances.
+ */
+template <typename Callback>
+bool setFromIK(const kinematics::KinematicsBase& solver, moveit::core::RobotState& state,
+               const moveit::core::JointModelGroup* jmg, const Eigen::Isometry3d& target,
+               const moveit::core::LinkModel* link, double timeout, const Callback& is_valid) {
+	const moveit::core::RobotModel& robot_model = *state.getRobotModel();
+	const moveit::core::LinkModel* tip = robot_model.getLinkModel(stripLeadingSlash(solver.getTipFrame()));
+	if (!tip || moveit::core::RobotModel::getRigidlyConnectedParentLinkModel(tip) !=
+	                moveit::core::RobotModel::getRigidlyConnectedParentLinkModel(link))
+		return false;
+
+	// target pose of solver's tip, expressed w.r.t. solver's base frame
+	Eigen::Isometry3d pose = target;
+	if (tip != link)
+		pose = pose * state.getGlobalLinkTransform(link).inverse() * state.getGlobalLinkTransform(tip);
+	const std::string base_frame = stripLeadingSlash(solver.getBaseFrame());
+	if (base_frame != robot_model.getModelFrame())
+		pose = state.getGlobalLinkTransform(base_frame).inverse() * pose;
+
+	// map between solver's joint order and group's variable order
+	const std::vector<unsigned int>& bijection = jmg->getKinematicsSolverJointBijection();
+	std::vector<double> values;
+	state.copyJointGroupPositions(jmg, values);
+	std::vector<double> seed(bijection.size());
+	for (size_t i = 0; i < bijection.size(); ++i)
+		seed[i] = values[bijection[i]];
+
+	auto callback = [&](const geometry_msgs::Pose& /*pose*/, const std::vector<double>& solution,
+	                    moveit_msgs::MoveItErrorCodes& error_code) {
+		for (size_t i = 0; i < bijection.size(); ++i)
+			values[bijection[i]] = solution[i];
+		error_code.val = is_valid(&state, jmg, values.data()) ? moveit_msgs::MoveItErrorCodes::SUCCESS :
+		                                                         moveit_msgs::MoveItErrorCodes::NO_IK_SOLUTION;
+	};
+
+	std::vector<double> solution;
+	moveit_msgs::MoveItErrorCodes error_code;
+	if (!solver.searchPositionIK(tf2::toMsg(pose), seed, timeout, solution, callback, error_code))
+		return false;
+
+	for (size_t i = 0; i < bijection.size(); ++i)
+		values[bijection[i]] = solution[i];
+	state.setJointGroupPositions(jmg, values);
+	state.update();
+	return true;
+}
+
 std::string listCollisionPairs(const collision_detection::CollisionResult::ContactMap& contacts,
                                const std::string& separator) {
 	std::string result;
@@ -189,6 +280,14 @@ bool validateGroup(const PropertyMap& props, const moveit::core::RobotModelConst
 
 void ComputeIK::reset() {
 	upstream_solutions_.clear();
+	groups_cache_.reset();
+	compare_pose_cache_.reset();
+	constraints_cache_.reset();
+	collision_filter_cache_.reset();
+	scene_fingerprint_cache_.reset();
+	ik_cache_hits_ = 0;
+	ik_cache_misses_ = 0;
+	warm_start_index_.reset();
 	WrapperBase::reset();
 }
 
@@ -200,6 +299,22 @@ void ComputeIK::init(const moveit::core::RobotModelConstPtr& robot_model) {
 		errors.append(e);
 	}
 
+	auto& p = properties();
+	eef_ = p.handle<std::string>("eef");
+	group_ = p.handle<std::string>("group");
+	default_pose_ = p.handle<std::string>("default_pose");
+	max_ik_solutions_ = p.handle<uint32_t>("max_ik_solutions");
+	num_threads_ = p.handle<uint32_t>("num_threads");
+	batch_size_ = p.handle<uint32_t>("batch_size");
+	warm_start_seeds_ = p.handle<uint32_t>("warm_start_seeds");
+	warm_start_radius_ = p.handle<double>("warm_start_radius");
+	ignore_collisions_ = p.handle<bool>("ignore_collisions");
+	min_solution_distance_ = p.handle<double>("min_solution_distance");
+	collision_prefilter_ = p.handle<bool>("collision_prefilter");
+	constraints_ = p.handle<moveit_msgs::Constraints>("constraints");
+	ik_frame_ = p.handle<geometry_msgs::PoseStamped>("ik_frame");
+	target_pose_ = p.handle<geometry_msgs::PoseStamped>("target_pose");
+
 	// all properties can be derived from the interface state
 	// however, if they are defined already now, we validate here
 	const auto& props = properties();
@@ -228,6 +343,114 @@ bool ComputeIK::canCompute() const {
 	return !upstream_solutions_.empty() || WrapperBase::canCompute();
 }
 
+/// per-target data, prepared from an upstream solution before sampling IK
+struct ComputeIK::IKTarget
+{
+	const SolutionBase* upstream = nullptr;
+	planning_scene::PlanningSceneConstPtr scene;
+	const moveit::core::JointModelGroup* jmg = nullptr;
+	const moveit::core::LinkModel* link = nullptr;
+	Eigen::Isometry3d pose;  // target pose of link w.r.t. planning frame
+
+	// property values, captured for this target
+	bool ignore_collisions = false;
+	double min_solution_distance = 0.0;
+	uint32_t max_ik_solutions = 1;
+	double timeout = 0.0;
+	kinematic_constraints::KinematicConstraintSetConstPtr constraints;
+	SphereCollisionFilterConstPtr collision_filter;
+	std::vector<double> compare_pose;  // joint values of robot pose to compare IK solution with for costs
+	std::vector<std::vector<double>> seeds;  // tried before the current state and random seeds
+	std::optional<IKCache::Key> cache_key;
+
+	std::deque<visualization_msgs::Marker> frame_markers;
+	std::deque<visualization_msgs::Marker> eef_markers;
+
+	IKSolutions ik_solutions;
+	std::optional<JointSpaceIndex> ik_solutions_index;  // for min_solution_distance checks
+	std::mutex ik_solutions_mutex;  // guards ik_solutions during parallel sampling
+};
+
+/// recent IK solutions, spatially hashed by their target position into voxels of size resolution
+struct ComputeIK::WarmStartIndex
+{
+	static constexpr std::size_t CAPACITY = 1000;
+	static constexpr double ORIENTATION_WEIGHT = 0.1;  // pose distance per radian
+
+	using Voxel = std::array<int64_t, 3>;
+	struct VoxelHash
+	{
+		std::size_t operator()(const Voxel& voxel) const { return boost::hash_range(voxel.begin(), voxel.end()); }
+	};
+	struct Entry
+	{
+		const moveit::core::JointModelGroup* jmg;
+		const moveit::core::LinkModel* link;
+		Eigen::Isometry3d pose;
+		std::vector<double> solution;
+		Voxel voxel;
+	};
+	using Entries = std::list<Entry>;  // oldest first
+
+	explicit WarmStartIndex(double resolution) : resolution(resolution) {}
+
+	Voxel voxel(const Eigen::Vector3d& position) const {
+		return { static_cast<int64_t>(std::floor(position.x() / resolution)),
+			      static_cast<int64_t>(std::floor(position.y() / resolution)),
+			      static_cast<int64_t>(std::floor(position.z() / resolution)) };
+	}
+
+	static double distance(const Eigen::Isometry3d& a, const Eigen::Isometry3d& b) {
+		return (a.translation() - b.translation()).norm() +
+		       ORIENTATION_WEIGHT * Eigen::AngleAxisd(a.linear().transpose() * b.linear()).angle();
+	}
+
+	void insert(const moveit::core::JointModelGroup* jmg, const moveit::core::LinkModel* link,
+	            const Eigen::Isometry3d& pose, const std::vector<double>& solution) {
+		entries.push_back(Entry{ jmg, link, pose, solution, voxel(pose.translation()) });
+		voxels[entries.back().voxel].push_back(std::prev(entries.end()));
+
+		if (entries.size() > CAPACITY) {  // drop oldest entry
+			auto& bucket = voxels[entries.front().voxel];
+			bucket.erase(std::find(bucket.begin(), bucket.end(), entries.begin()));
+			if (bucket.empty())
+				voxels.erase(entries.front().voxel);
+			entries.pop_front();
+		}
+	}
+
+	/// append solutions of up to n nearest targets (of same group and link) within resolution to seeds
+	void nearest(const moveit::core::JointModelGroup* jmg, const moveit::core::LinkModel* link,
+	             const Eigen::Isometry3d& pose, std::size_t n, std::vector<std::vector<double>>& seeds) const {
+		std::vector<std::pair<double, const Entry*>> candidates;
+		const Voxel center = voxel(pose.translation());
+		for (int64_t dx = -1; dx <= 1; ++dx)
+			for (int64_t dy = -1; dy <= 1; ++dy)
+				for (int64_t dz = -1; dz <= 1; ++dz) {
+					auto it = voxels.find({ center[0] + dx, center[1] + dy, center[2] + dz });
+					if (it == voxels.end())
+						continue;
+					for (const auto& entry : it->second) {
+						if (entry->jmg != jmg || entry->link != link)
+							continue;
+						double d = distance(pose, entry->pose);
+						if (d <= resolution)
+							candidates.emplace_back(d, &*entry);
+					}
+				}
+
+		n = std::min(n, candidates.size());
+		std::partial_sort(candidates.begin(), candidates.begin() + n, candidates.end(),
+		                  [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (std::size_t i = 0; i < n; ++i)
+			seeds.push_back(candidates[i].second->solution);
+	}
+
+	const double resolution;
+	Entries entries;
+	std::unordered_map<Voxel, std::vector<Entries::iterator>, VoxelHash> voxels;
+};
+
 void ComputeIK::compute() {
 	if (WrapperBase::canCompute())
 		WrapperBase::compute();
@@ -235,8 +458,77 @@ void ComputeIK::compute() {
 	if (upstream_solutions_.empty())
 		return;
 
-	const SolutionBase& s = *upstream_solutions_.pop();
+	// prepare a batch of targets (sequentially, as properties are initialized from each target's interface)
+	const uint32_t batch_size = std::max(batch_size_.get(), 1u);
+	std::deque<IKTarget> targets;  // deque: IKTarget is not movable
+	while (targets.size() < batch_size && !upstream_solutions_.empty()) {
+		const SolutionBase& s = *upstream_solutions_.pop();
+		if (!prepareTarget(s, targets.emplace_back()))
+			targets.pop_back();  // failure was already reported
+	}
+	if (targets.empty())
+		return;
+
+	// separate solver instances are only used if all targets share the same group
+	const moveit::core::JointModelGroup* jmg = targets.front().jmg;
+	const bool single_group =
+	    std::all_of(targets.begin(), targets.end(), [jmg](const IKTarget& target) { return target.jmg == jmg; });
+	// a single solution (of a single target) is only searched from the current state as seed
+	const bool parallelizable = targets.size() > 1 || targets.front().max_ik_solutions > 1;
+	const uint32_t num_threads = single_group && parallelizable ? num_threads_.get() : 1u;
+
+	std::vector<const kinematics::KinematicsBase*> solvers;
+	if (num_threads > 1) {
+		// depending on the robot model keeps jmg alive
+		const auto& robot_model = targets.front().scene->getRobotModel();
+		const auto& instances = ik_solvers_cache_.get({ num_threads_.property(), robot_model, jmg }, [jmg, num_threads] {
+			std::vector<kinematics::KinematicsBaseConstPtr> solvers;
+			const auto& allocator = jmg->getSolverAllocators().first;
+			if (!jmg->getSolverInstance() || !allocator)
+				return solvers;  // no solver for the group itself, but only for its subgroups
+			for (uint32_t i = 0; i != num_threads; ++i) {
+				kinematics::KinematicsBaseConstPtr solver = allocator(jmg);
+				if (!solver || solver->getTipFrames().size() != 1)
+					return std::vector<kinematics::KinematicsBaseConstPtr>();
+				solvers.push_back(solver);
+			}
+			return solvers;
+		});
+		if (instances.empty())
+			ROS_WARN_STREAM_ONCE_NAMED("ComputeIK", fmt::format("{}: Cannot create separate IK solver instances for "
+			                                                    "group '{}'. Falling back to sequential IK sampling.",
+			                                                    name(), jmg->getName()));
+		for (const auto& solver : instances)
+			solvers.push_back(solver.get());
+	}
+
+	if (solvers.empty()) {  // sequential sampling, using the group's shared solver
+		for (auto& target : targets)
+			sampleIK(target, solvers);
+	} else if (targets.size() == 1) {  // sample a single target with all solvers
+		sampleIK(targets.front(), solvers);
+	} else {  // distribute targets onto threads, each one using its own solver instance
+		std::atomic<size_t> next_target{ 0 };
+		auto work = [&](const kinematics::KinematicsBase* solver) {
+			for (size_t i = next_target++; i < targets.size(); i = next_target++)
+				sampleIK(targets[i], { solver });
+		};
+		const size_t num_workers = std::min(solvers.size(), targets.size());
+		std::vector<std::thread> threads;
+		threads.reserve(num_workers - 1);
+		for (size_t thread = 1; thread < num_workers; ++thread)
+			threads.emplace_back(work, solvers[thread]);
+		work(solvers[0]);
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	// spawn solutions (or failures) in the order of upstream solutions
+	for (auto& target : targets)
+		spawnSolutions(target, !solvers.empty());
+}
 
+bool ComputeIK::prepareTarget(const SolutionBase& s, IKTarget& target) {
 	// -1 TODO: this should not be necessary in my opinion: Why do you think so?
 	// It is, because the properties on the interface might change from call to call...
 	// enforced initialization from interface ensures that new target_pose is read
@@ -244,13 +536,11 @@ void ComputeIK::compute() {
 	const auto& props = properties();
 
 	const planning_scene::PlanningSceneConstPtr& scene{ s.start()->scene() };
+	target.upstream = &s;
+	target.scene = scene;
 
-	const bool ignore_collisions = props.get<bool>("ignore_collisions");
+	const bool ignore_collisions = ignore_collisions_.get();
 	const auto& robot_model = scene->getRobotModel();
-	const moveit::core::JointModelGroup* eef_jmg = nullptr;
-	const moveit::core::JointModelGroup* jmg = nullptr;
-	std::string msg;
-
 	auto report_failure = [&s, this](const std::string& msg) {
 		planning_scene::PlanningScenePtr scene = s.start()->scene()->diff();
 		SubTrajectory solution;
@@ -258,22 +548,26 @@ void ComputeIK::compute() {
 		spawn(InterfaceState(scene), std::move(solution));
 	};
 
-	if (!validateEEF(props, robot_model, eef_jmg, &msg)) {
-		report_failure(msg);
-		return;
-	}
-	if (!validateGroup(props, robot_model, eef_jmg, jmg, &msg)) {
-		report_failure(msg);
-		return;
-	}
-	if (!eef_jmg && !jmg) {
-		report_failure("Neither eef nor group are well defined");
-		return;
+	// validate eef and group, only if any of them changed
+	const Groups& groups = groups_cache_.get({ eef_.property(), group_.property(), robot_model }, [&] {
+		Groups groups;
+		if (!validateEEF(props, robot_model, groups.eef_jmg, &groups.error) ||
+		    !validateGroup(props, robot_model, groups.eef_jmg, groups.jmg, &groups.error))
+			return groups;
+		if (!groups.eef_jmg && !groups.jmg)
+			groups.error = "Neither eef nor group are well defined";
+		return groups;
+	});
+	if (!groups.error.empty()) {
+		report_failure(groups.error);
+		return false;
 	}
+	const moveit::core::JointModelGroup* eef_jmg = groups.eef_jmg;
+	const moveit::core::JointModelGroup* jmg = groups.jmg;
 	properties().property("timeout").setDefaultValue(jmg->getDefaultIKTimeout());
 
 	// extract target_pose
-	geometry_msgs::PoseStamped target_pose_msg = props.get<geometry_msgs::PoseStamped>("target_pose");
+	geometry_msgs::PoseStamped target_pose_msg = target_pose_.get();
 	if (target_pose_msg.header.frame_id.empty())  // if not provided, assume planning frame
 		target_pose_msg.header.frame_id = scene->getPlanningFrame();
 
@@ -282,7 +576,7 @@ void ComputeIK::compute() {
 	if (target_pose_msg.header.frame_id != scene->getPlanningFrame()) {
 		if (!scene->knowsFrameTransform(target_pose_msg.header.frame_id)) {
 			report_failure(fmt::format("Unknown reference frame for target pose: '{}'", target_pose_msg.header.frame_id));
-			return;
+			return false;
 		}
 		// transform target_pose w.r.t. planning frame
 		target_pose = scene->getFrameTransform(target_pose_msg.header.frame_id) * target_pose;
@@ -291,24 +585,23 @@ void ComputeIK::compute() {
 	// determine IK link from ik_frame
 	const moveit::core::LinkModel* link = nullptr;
 	geometry_msgs::PoseStamped ik_pose_msg;
-	const boost::any& value = props.get("ik_frame");
-	if (value.empty()) {  // property undefined
+	if (ik_frame_.property().value().empty()) {  // property undefined
 		//  determine IK link from eef/group
 		if (!(link = eef_jmg ? robot_model->getLinkModel(eef_jmg->getEndEffectorParentGroup().second) :
 		                       jmg->getOnlyOneEndEffectorTip())) {
 			report_failure("Failed to derive IK target link");
-			return;
+			return false;
 		}
 		ik_pose_msg.header.frame_id = link->getName();
 		ik_pose_msg.pose.orientation.w = 1.0;
 	} else {
-		ik_pose_msg = boost::any_cast<geometry_msgs::PoseStamped>(value);
+		ik_pose_msg = ik_frame_.get();
 		Eigen::Isometry3d ik_pose;
 		tf2::fromMsg(ik_pose_msg.pose, ik_pose);
 
 		if (!scene->getCurrentState().knowsFrameTransform(ik_pose_msg.header.frame_id)) {
 			report_failure(fmt::format("ik frame unknown in robot: '{}'", ik_pose_msg.header.frame_id));
-			return;
+			return false;
 		}
 		ik_pose = scene->getCurrentState().getFrameTransform(ik_pose_msg.header.frame_id) * ik_pose;
 
@@ -318,6 +611,24 @@ void ComputeIK::compute() {
 		target_pose = target_pose * ik_pose.inverse() * scene->getCurrentState().getFrameTransform(link->getName());
 	}
 
+	// reject (or deprioritize) targets, which are unreachable according to the reachability map
+	bool unreachable = false;
+	if (reachability_map_) {
+		if (reachability_map_->group() != jmg->getName() || reachability_map_->link() != link->getName())
+			ROS_WARN_STREAM_ONCE_NAMED("ComputeIK",
+			                           fmt::format("{}: Reachability map for '{}' / '{}' doesn't match group '{}' / "
+			                                       "link '{}'",
+			                                       name(), reachability_map_->group(), reachability_map_->link(),
+			                                       jmg->getName(), link->getName()));
+		else if (!reachability_map_->reachable(scene->getCurrentState(), target_pose)) {
+			if (unreachable_timeout_ <= 0) {
+				report_failure("target unreachable according to reachability map");
+				return false;
+			}
+			unreachable = true;
+		}
+	}
+
 	// validate placed link for collisions
 	collision_detection::CollisionResult collisions;
 	moveit::core::RobotState sandbox_state{ scene->getCurrentState() };
@@ -325,11 +636,11 @@ void ComputeIK::compute() {
 	    !ignore_collisions && isTargetPoseCollidingInEEF(scene, sandbox_state, target_pose, link, jmg, &collisions);
 
 	// frames at target pose and ik frame
-	std::deque<visualization_msgs::Marker> frame_markers;
+	auto& frame_markers = target.frame_markers;
 	rviz_marker_tools::appendFrame(frame_markers, target_pose_msg, 0.1, "target frame");
 	rviz_marker_tools::appendFrame(frame_markers, ik_pose_msg, 0.1, "ik frame");
 	// end-effector markers
-	std::deque<visualization_msgs::Marker> eef_markers;
+	auto& eef_markers = target.eef_markers;
 	// visualize placed end-effector
 	auto appender = [&eef_markers](visualization_msgs::Marker& marker, const std::string& /*name*/) {
 		marker.ns = "ik target";
@@ -350,124 +661,251 @@ void ComputeIK::compute() {
 		auto colliding_scene{ scene->diff() };
 		colliding_scene->setCurrentState(sandbox_state);
 		spawn(InterfaceState(colliding_scene), std::move(solution));
-		return;
+		return false;
 	} else
 		generateVisualMarkers(sandbox_state, appender, links_to_visualize);
 
 	// determine joint values of robot pose to compare IK solution with for costs
-	std::vector<double> compare_pose;
-	const std::string& compare_pose_name = props.get<std::string>("default_pose");
+	const std::string& compare_pose_name = default_pose_.get();
 	if (!compare_pose_name.empty()) {
-		moveit::core::RobotState compare_state(robot_model);
-		compare_state.setToDefaultValues(jmg, compare_pose_name);
-		compare_state.copyJointGroupPositions(jmg, compare_pose);
+		target.compare_pose = compare_pose_cache_.get({ default_pose_.property(), jmg }, [&] {
+			std::vector<double> positions;
+			moveit::core::RobotState compare_state(robot_model);
+			compare_state.setToDefaultValues(jmg, compare_pose_name);
+			compare_state.copyJointGroupPositions(jmg, positions);
+			return positions;
+		});
 	} else
-		scene->getCurrentState().copyJointGroupPositions(jmg, compare_pose);
-
-	double min_solution_distance = props.get<double>("min_solution_distance");
+		scene->getCurrentState().copyJointGroupPositions(jmg, target.compare_pose);
+
+	// non-empty constraints are transformed w.r.t. the scene's fixed frames: depend on scene then too
+	const auto& constraints = constraints_.get();
+	const planning_scene::PlanningSceneConstPtr& constraints_scene =
+	    kinematic_constraints::isEmpty(constraints) ? planning_scene::PlanningSceneConstPtr() : scene;
+	target.constraints = constraints_cache_.get({ constraints_.property(), constraints_scene }, [&] {
+		auto constraint_set = std::make_shared<kinematic_constraints::KinematicConstraintSet>(robot_model);
+		constraint_set->add(constraints, scene->getTransforms());
+		return kinematic_constraints::KinematicConstraintSetConstPtr(constraint_set);
+	});
+
+	target.jmg = jmg;
+	target.ik_solutions_index.emplace(jmg);
+	target.link = link;
+	target.pose = target_pose;
+	target.ignore_collisions = ignore_collisions;
+	if (!ignore_collisions && collision_prefilter_.get())
+		target.collision_filter = collision_filter_cache_.get({ scene, jmg }, [&] {
+			return SphereCollisionFilterConstPtr(std::make_shared<SphereCollisionFilter>(scene, jmg));
+		});
+	target.min_solution_distance = min_solution_distance_.get();
+	target.max_ik_solutions = max_ik_solutions_.get();
+	target.timeout = unreachable ? std::min(timeout(), unreachable_timeout_) : timeout();
+
+	if (ik_cache_) {
+		// the fingerprint is expensive: compute it once per scene
+		const std::size_t fingerprint = scene_fingerprint_cache_.get(
+		    { scene, jmg }, [&] { return IKCache::sceneFingerprint(*scene, jmg); });
+		target.cache_key = ik_cache_->key(fingerprint, jmg, link, target_pose);
+		target.seeds = ik_cache_->lookup(*target.cache_key);
+		++(target.seeds.empty() ? ik_cache_misses_ : ik_cache_hits_);
+	}
 
-	kinematic_constraints::KinematicConstraintSet constraint_set(robot_model);
-	constraint_set.add(props.get<moveit_msgs::Constraints>("constraints"), scene->getTransforms());
+	// seed with solutions of nearby targets
+	const uint32_t warm_start_seeds = warm_start_seeds_.get();
+	const double warm_start_radius = warm_start_radius_.get();
+	if (warm_start_seeds > 0 && warm_start_radius > 0) {
+		if (!warm_start_index_ || warm_start_index_->resolution != warm_start_radius)
+			warm_start_index_ = std::make_unique<WarmStartIndex>(warm_start_radius);
+		warm_start_index_->nearest(jmg, link, target_pose, warm_start_seeds, target.seeds);
+	} else
+		warm_start_index_.reset();
+	return true;
+}
 
-	IKSolutions ik_solutions;
-	auto is_valid = [scene, ignore_collisions, min_solution_distance, &constraint_set = std::as_const(constraint_set),
-	                 &ik_solutions](moveit::core::RobotState* state, const moveit::core::JointModelGroup* jmg,
-	                                const double* joint_positions) {
-		for (const auto& sol : ik_solutions) {
-			if (jmg->distance(joint_positions, sol.joint_positions.data()) < min_solution_distance)
+void ComputeIK::sampleIK(IKTarget& target, const std::vector<const kinematics::KinematicsBase*>& solvers) {
+	IKSolutions& ik_solutions = target.ik_solutions;
+	std::mutex& ik_solutions_mutex = target.ik_solutions_mutex;
+	const uint32_t max_ik_solutions = target.max_ik_solutions;
+
+	auto is_valid = [&target, &ik_solutions, &ik_solutions_mutex](moveit::core::RobotState* state,
+	                                                              const moveit::core::JointModelGroup* jmg,
+	                                                              const double* joint_positions) {
+		IKSolution* solution;
+		{
+			std::lock_guard<std::mutex> lock(ik_solutions_mutex);
+			if (ik_solutions.size() >= target.max_ik_solutions)
+				return true;  // other threads found enough solutions already: stop searching
+			if (target.ik_solutions_index->withinDistance(joint_positions, target.min_solution_distance))
 				return false;  // too close to already found solution
+			target.ik_solutions_index->insert(joint_positions);
+			solution = &ik_solutions.emplace_back();
+			solution->joint_positions.assign(joint_positions, joint_positions + jmg->getVariableCount());
 		}
 		state->setJointGroupPositions(jmg, joint_positions);
 		state->update();
 
-		ik_solutions.emplace_back();
-		auto& solution{ ik_solutions.back() };
-		state->copyJointGroupPositions(jmg, solution.joint_positions);
-
 		// validate constraints
-		solution.satisfies_constraints = constraint_set.decide(*state).satisfied;
-
-		// check for collisions
-		collision_detection::CollisionRequest req;
-		collision_detection::CollisionResult res;
-		req.contacts = true;
-		req.max_contacts = 1;
-		req.group_name = jmg->getName();
-		scene->checkCollision(req, res, *state);
-		solution.collision_free = ignore_collisions || !res.collision;
-		if (!res.contacts.empty()) {
-			solution.contact = res.contacts.begin()->second.front();
+		solution->satisfies_constraints = target.constraints->decide(*state).satisfied;
+
+		// check for collisions, unless the prefilter already found the state collision-free
+		if (target.collision_filter && target.collision_filter->check(*state) == SphereCollisionFilter::FREE)
+			solution->collision_free = true;
+		else {
+			collision_detection::CollisionRequest req;
+			collision_detection::CollisionResult res;
+			req.contacts = true;
+			req.max_contacts = 1;
+			req.group_name = jmg->getName();
+			target.scene->checkCollision(req, res, *state);
+			solution->collision_free = target.ignore_collisions || !res.collision;
+			if (!res.contacts.empty()) {
+				solution->contact = res.contacts.begin()->second.front();
+			}
 		}
 
-		return solution.satisfies_constraints && solution.collision_free;
+		return solution->satisfies_constraints && solution->collision_free;
 	};
 
-	uint32_t max_ik_solutions = props.get<uint32_t>("max_ik_solutions");
-	bool tried_current_state_as_seed = false;
+	// given seeds are tried first (each one with a share of the timeout), then the current state, then random states
+	const std::vector<std::vector<double>>& seeds = target.seeds;
+	const double seed_timeout = target.timeout / (seeds.size() + 1);
+	std::atomic<size_t> next_seed{ 0 };
+	std::vector<double> current_positions;
+	if (!seeds.empty())
+		target.scene->getCurrentState().copyJointGroupPositions(target.jmg, current_positions);
+
+	// sample with the given solver instance (or the group's shared one if nullptr)
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(target.timeout);
+	auto sample = [&](const kinematics::KinematicsBase* solver, bool seed_from_current_state) {
+		// each thread uses its own RobotState copy
+		moveit::core::RobotState state{ target.scene->getCurrentState() };
+		bool tried_current_state_as_seed = !seed_from_current_state;
+		while (true) {
+			{
+				std::lock_guard<std::mutex> lock(ik_solutions_mutex);
+				if (ik_solutions.size() >= max_ik_solutions)
+					break;
+			}
+			double remaining_time = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+			if (remaining_time <= 0)
+				break;
+
+			const size_t seed = next_seed < seeds.size() ? next_seed++ : seeds.size();
+			const bool seeded = seed < seeds.size() && seeds[seed].size() == target.jmg->getVariableCount();
+			if (seeded) {
+				state.setJointGroupPositions(target.jmg, seeds[seed]);
+				state.update();
+				remaining_time = std::min(remaining_time, seed_timeout);
+			} else if (!tried_current_state_as_seed) {
+				if (!seeds.empty()) {  // restore current state
+					state.setJointGroupPositions(target.jmg, current_positions);
+					state.update();
+				}
+				tried_current_state_as_seed = true;
+			} else {
+				state.setToRandomPositions(target.jmg);
+				state.update();
+			}
+
+			bool succeeded =
+			    solver ? setFromIK(*solver, state, target.jmg, target.pose, target.link, remaining_time, is_valid) :
+			             state.setFromIK(target.jmg, target.pose, target.link->getName(), remaining_time, is_valid);
 
-	double remaining_time = timeout();
-	auto start_time = std::chrono::steady_clock::now();
-	while (ik_solutions.size() < max_ik_solutions && remaining_time > 0) {
-		if (tried_current_state_as_seed) {
-			sandbox_state.setToRandomPositions(jmg);
-			sandbox_state.update();
+			// TODO: magic constant should be a property instead ("current_seed_only", or equivalent)
+			// Yeah, you are right, these are two different semantic concepts:
+			// One could also have multiple IK solutions derived from the same seed
+			if (!succeeded && !seeded && max_ik_solutions == 1)
+				break;  // first and only attempt failed
 		}
-		tried_current_state_as_seed = true;
-
-		size_t previous = ik_solutions.size();
-		bool succeeded = sandbox_state.setFromIK(jmg, target_pose, link->getName(), remaining_time, is_valid);
-
-		auto now = std::chrono::steady_clock::now();
-		remaining_time -= std::chrono::duration<double>(now - start_time).count();
-		start_time = now;
-
-		// for all new solutions (successes and failures)
-		for (size_t i = previous; i != ik_solutions.size(); ++i) {
-			// create a new scene for each solution as they will have different robot states
-			planning_scene::PlanningScenePtr solution_scene = scene->diff();
-			SubTrajectory solution;
-			solution.setComment(s.comment());
-			std::copy(frame_markers.begin(), frame_markers.end(), std::back_inserter(solution.markers()));
-
-			if (ik_solutions[i].collision_free && ik_solutions[i].satisfies_constraints)
-				// compute cost as distance to compare_pose
-				solution.setCost(s.cost() + jmg->distance(ik_solutions[i].joint_positions.data(), compare_pose.data()));
-			else if (!ik_solutions[i].collision_free) {  // solution was in collision
-				std::stringstream ss;
-				ss << "Collision between '" << ik_solutions[i].contact.body_name_1 << "' and '"
-				   << ik_solutions[i].contact.body_name_2 << "'";
-				solution.markAsFailure(ss.str());
-			} else if (!ik_solutions[i].satisfies_constraints) {  // solution was violating constraints
-				solution.markAsFailure("Constraints violated");
-			}
-			// set scene's robot state
-			moveit::core::RobotState& solution_state = solution_scene->getCurrentStateNonConst();
-			solution_state.setJointGroupPositions(jmg, ik_solutions[i].joint_positions.data());
-			solution_state.update();
+	};
+
+	if (solvers.size() <= 1) {
+		sample(solvers.empty() ? nullptr : solvers.front(), true);
+		return;
+	}
 
-			InterfaceState state(solution_scene);
-			forwardProperties(*s.start(), state);
+	// parallel sampling: only the first thread starts from current state
+	std::vector<std::thread> threads;
+	threads.reserve(solvers.size() - 1);
+	for (size_t thread = 1; thread < solvers.size(); ++thread)
+		threads.emplace_back(sample, solvers[thread], false);
+	sample(solvers[0], true);
+	for (auto& thread : threads)
+		thread.join();
+}
 
-			// ik target link placement
-			std::copy(eef_markers.begin(), eef_markers.end(), std::back_inserter(solution.markers()));
+void ComputeIK::spawnSolutions(IKTarget& target, bool sort) {
+	const SolutionBase& s = *target.upstream;
+	const moveit::core::JointModelGroup* jmg = target.jmg;
+	const std::vector<double>& compare_pose = target.compare_pose;
 
-			spawn(std::move(state), std::move(solution));
+	auto spawn_solution = [&](const IKSolution& ik_solution) {
+		// create a new scene for each solution as they will have different robot states
+		planning_scene::PlanningScenePtr solution_scene = target.scene->diff();
+		SubTrajectory solution;
+		solution.setComment(s.comment());
+		std::copy(target.frame_markers.begin(), target.frame_markers.end(), std::back_inserter(solution.markers()));
+
+		if (ik_solution.collision_free && ik_solution.satisfies_constraints)
+			// compute cost as distance to compare_pose
+			solution.setCost(s.cost() + jmg->distance(ik_solution.joint_positions.data(), compare_pose.data()));
+		else if (!ik_solution.collision_free) {  // solution was in collision
+			std::stringstream ss;
+			ss << "Collision between '" << ik_solution.contact.body_name_1 << "' and '" << ik_solution.contact.body_name_2
+			   << "'";
+			solution.markAsFailure(ss.str());
+		} else if (!ik_solution.satisfies_constraints) {  // solution was violating constraints
+			solution.markAsFailure("Constraints violated");
 		}
+		// set scene's robot state
+		moveit::core::RobotState& solution_state = solution_scene->getCurrentStateNonConst();
+		solution_state.setJointGroupPositions(jmg, ik_solution.joint_positions.data());
+		solution_state.update();
+
+		InterfaceState state(solution_scene);
+		forwardProperties(*s.start(), state);
+
+		// ik target link placement
+		std::copy(target.eef_markers.begin(), target.eef_markers.end(), std::back_inserter(solution.markers()));
+
+		spawn(std::move(state), std::move(solution));
+	};
 
-		// TODO: magic constant should be a property instead ("current_seed_only", or equivalent)
-		// Yeah, you are right, these are two different semantic concepts:
-		// One could also have multiple IK solutions derived from the same seed
-		if (!succeeded && max_ik_solutions == 1)
-			break;  // first and only attempt failed
+	if (sort) {
+		// solutions sampled in parallel are spawned in a deterministic order: by distance to compare_pose
+		std::vector<std::pair<double, const IKSolution*>> ordered;
+		ordered.reserve(target.ik_solutions.size());
+		for (const auto& ik_solution : target.ik_solutions)
+			ordered.emplace_back(jmg->distance(ik_solution.joint_positions.data(), compare_pose.data()), &ik_solution);
+		std::sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) {
+			return a.first < b.first ||
+			       (a.first == b.first && a.second->joint_positions < b.second->joint_positions);
+		});
+		for (const auto& entry : ordered)
+			spawn_solution(*entry.second);
+	} else {
+		for (const auto& ik_solution : target.ik_solutions)
+			spawn_solution(ik_solution);
 	}
 
-	if (ik_solutions.empty()) {  // failed to find any solution
+	// remember valid solutions
+	IKCache::Solutions valid;
+	for (const auto& ik_solution : target.ik_solutions)
+		if (ik_solution.collision_free && ik_solution.satisfies_constraints)
+			valid.push_back(ik_solution.joint_positions);
+	if (warm_start_index_)
+		for (const auto& solution : valid)
+			warm_start_index_->insert(jmg, target.link, target.pose, solution);
+	if (target.cache_key && !valid.empty())
+		ik_cache_->insert(*target.cache_key, std::move(valid));
+
+	if (target.ik_solutions.empty()) {  // failed to find any solution
 		planning_scene::PlanningScenePtr scene = s.start()->scene()->diff();
 		SubTrajectory solution;
 
 		solution.markAsFailure();
 		solution.setComment(s.comment() + " no IK found");
-		std::copy(frame_markers.begin(), frame_markers.end(), std::back_inserter(solution.markers()));
+		std::copy(target.frame_markers.begin(), target.frame_markers.end(), std::back_inserter(solution.markers()));
 
 		// ik target link placement
 		std_msgs::ColorRGBA tint_color;
@@ -475,13 +913,21 @@ void ComputeIK::compute() {
 		tint_color.g = 0.0;
 		tint_color.b = 0.0;
 		tint_color.a = 0.5;
-		for (auto& marker : eef_markers)
+		for (auto& marker : target.eef_markers)
 			marker.color = tint_color;
-		std::copy(eef_markers.begin(), eef_markers.end(), std::back_inserter(solution.markers()));
+		std::copy(target.eef_markers.begin(), target.eef_markers.end(), std::back_inserter(solution.markers()));
 
 		spawn(InterfaceState(scene), std::move(solution));
 	}
 }
+
+void ComputeIK::statistics(std::map<std::string, double>& stats) const {
+	WrapperBase::statistics(stats);
+	if (ik_cache_) {
+		stats["ik_cache_hits"] = ik_cache_hits_;
+		stats["ik_cache_misses"] = ik_cache_misses_;
+	}
+}
 }  // namespace stages
 }  // namespace task_constructor
 }  // namespace moveit
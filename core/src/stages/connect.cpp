@@ -37,13 +37,20 @@
 */
 
 #include <moveit/task_constructor/stages/connect.h>
+#include <moveit/task_constructor/stage_p.h>
 #include <moveit/task_constructor/merge.h>
 #include <moveit/task_constructor/cost_terms.h>
+#include <moveit/task_constructor/trajectory_validation.h>
 #include <moveit/task_constructor/fmt_p.h>
 
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/trajectory_processing/time_optimal_trajectory_generation.h>
 
+#include <chrono>
+#include <functional>
+#include <map>
+#include <thread>
+
 using namespace trajectory_processing;
 
 namespace moveit {
@@ -62,18 +69,41 @@ Connect::Connect(const std::string& name, const GroupPlannerVector& planners) :
 	                                    "constraints to maintain during trajectory");
 	properties().declare<TimeParameterizationPtr>("merge_time_parameterization",
 	                                              std::make_shared<TimeOptimalTrajectoryGeneration>());
+	p.declare<uint32_t>("validation_threads", 1, "number of threads validating waypoints of merged trajectories");
+	p.declare<bool>("parallel_planning", false,
+	                "plan all groups concurrently from the start state, falling back to sequential planning on failure "
+	                "(groups sharing a planner that is not thread-safe are planned one after another)");
+}
+
+Stage::pointer Connect::cloneStage() const {
+	auto copy = std::make_unique<Connect>(name(), planner_);  // sharing the planners
+	copyConfigTo(*copy);
+	return copy;
 }
 
 void Connect::reset() {
 	Connecting::reset();
-	merged_jmg_.reset();
 	subsolutions_.clear();
 	states_.clear();
+	if (pimpl()->resetRunOnly())
+		return;  // keep initialization for the next run
+
+	merged_jmg_.reset();
+	unplanned_variables_mask_.resize(0);
+	unplanned_joints_.clear();
 }
 
 void Connect::init(const core::RobotModelConstPtr& robot_model) {
 	Connecting::init(robot_model);
 
+	auto& p = properties();
+	merge_mode_ = p.handle<MergeMode>("merge_mode");
+	max_distance_ = p.handle<double>("max_distance");
+	path_constraints_ = p.handle<moveit_msgs::Constraints>("path_constraints");
+	merge_time_parameterization_ = p.handle<TimeParameterizationPtr>("merge_time_parameterization");
+	validation_threads_ = p.handle<uint32_t>("validation_threads");
+	parallel_planning_ = p.handle<bool>("parallel_planning");
+
 	InitStageException errors;
 	if (planner_.empty())
 		errors.push_back(*this, "empty set of groups");
@@ -94,7 +124,7 @@ void Connect::init(const core::RobotModelConstPtr& robot_model) {
 
 	if (!errors && groups.size() >= 2 && !merged_jmg_) {  // enable merging?
 		try {
-			merged_jmg_.reset(task_constructor::merge(groups));
+			merged_jmg_ = mergedGroup(robot_model, groups);
 		} catch (const std::runtime_error& e) {
 			ROS_INFO_STREAM_NAMED("Connect", fmt::format("{}: {}. Disabling merging.", this->name(), e.what()));
 		}
@@ -102,6 +132,20 @@ void Connect::init(const core::RobotModelConstPtr& robot_model) {
 
 	if (errors)
 		throw errors;
+
+	// precompute mask of variables that we don't plan for: these need to match in compatible()
+	std::set<const moveit::core::JointModel*> planned_joints;
+	for (const moveit::core::JointModelGroup* jmg : groups)
+		planned_joints.insert(jmg->getJointModels().begin(), jmg->getJointModels().end());
+
+	unplanned_variables_mask_.setZero(robot_model->getVariableCount());
+	unplanned_joints_.clear();
+	for (const moveit::core::JointModel* jm : robot_model->getJointModels()) {
+		if (planned_joints.count(jm) || jm->getVariableCount() == 0)
+			continue;  // ignore joints we plan for (and fixed joints)
+		unplanned_variables_mask_.segment(jm->getFirstVariableIndex(), jm->getVariableCount()).setOnes();
+		unplanned_joints_.push_back(jm);
+	}
 }
 
 bool Connect::compatible(const InterfaceState& from_state, const InterfaceState& to_state) const {
@@ -111,36 +155,41 @@ bool Connect::compatible(const InterfaceState& from_state, const InterfaceState&
 	const moveit::core::RobotState& from = from_state.scene()->getCurrentState();
 	const moveit::core::RobotState& to = to_state.scene()->getCurrentState();
 
-	// compose set of joint names we plan for
-	std::set<std::string> planned_joint_names;
-	for (const GroupPlannerVector::value_type& pair : planner_) {
-		const moveit::core::JointModelGroup* jmg = from.getJointModelGroup(pair.first);
-		const auto& names = jmg->getJointModelNames();
-		planned_joint_names.insert(names.begin(), names.end());
-	}
 	// all active joints that we don't plan for should match
-	for (const moveit::core::JointModel* jm : from.getRobotModel()->getJointModels()) {
-		if (planned_joint_names.count(jm->getName()))
-			continue;  // ignore joints we plan for
-
-		const unsigned int num = jm->getVariableCount();
-		Eigen::Map<const Eigen::VectorXd> positions_from(from.getJointPositions(jm), num);
-		Eigen::Map<const Eigen::VectorXd> positions_to(to.getJointPositions(jm), num);
-		if (!(positions_from - positions_to).isZero(1e-4)) {
+	const Eigen::Index num = unplanned_variables_mask_.size();
+	assert(num == static_cast<Eigen::Index>(from.getVariableCount()));
+	Eigen::Map<const Eigen::ArrayXd> positions_from(from.getVariablePositions(), num);
+	Eigen::Map<const Eigen::ArrayXd> positions_to(to.getVariablePositions(), num);
+	if (num == 0 || ((positions_from - positions_to) * unplanned_variables_mask_).abs().maxCoeff() <= 1e-4)
+		return true;
+
+	// report the deviating joint
+	for (const moveit::core::JointModel* jm : unplanned_joints_) {
+		const unsigned int count = jm->getVariableCount();
+		Eigen::Map<const Eigen::VectorXd> joint_from(from.getJointPositions(jm), count);
+		Eigen::Map<const Eigen::VectorXd> joint_to(to.getJointPositions(jm), count);
+		if (!(joint_from - joint_to).isZero(1e-4)) {
 			ROS_INFO_STREAM_NAMED("Connect", fmt::format("Deviation in joint {}: [{}] != [{}]", jm->getName(),
-			                                             positions_from.transpose(), positions_to.transpose()));
-			return false;
+			                                             joint_from.transpose(), joint_to.transpose()));
+			break;
 		}
 	}
-	return true;
+	return false;
 }
 
 void Connect::compute(const InterfaceState& from, const InterfaceState& to) {
-	const auto& props = properties();
 	double timeout = this->timeout();
-	MergeMode mode = props.get<MergeMode>("merge_mode");
-	double max_distance = props.get<double>("max_distance");
-	const auto& path_constraints = props.get<moveit_msgs::Constraints>("path_constraints");
+	MergeMode mode = merge_mode_.get();
+	if (parallel_planning_.get() && mode != SEQUENTIAL && merged_jmg_) {
+		auto start_time = std::chrono::steady_clock::now();
+		if (computeParallel(from, to))
+			return;
+		// sequential planning only gets the remaining time
+		timeout -= std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	}
+
+	double max_distance = max_distance_.get();
+	const auto& path_constraints = path_constraints_.get();
 
 	const moveit::core::RobotState& final_goal_state = to.scene()->getCurrentState();
 	std::vector<robot_trajectory::RobotTrajectoryConstPtr> sub_trajectories;
@@ -163,7 +212,9 @@ void Connect::compute(const InterfaceState& from, const InterfaceState& to) {
 		intermediate_scenes.push_back(end);
 
 		robot_trajectory::RobotTrajectoryPtr trajectory;
-		auto result = pair.second->plan(start, end, jmg, timeout, trajectory, path_constraints);
+		solvers::PlannerInterface::Result result{ false, "timeout" };
+		if (timeout > 0.0)
+			result = pair.second->plan(start, end, jmg, timeout, trajectory, path_constraints);
 		success = bool(result);
 		sub_trajectories.push_back(trajectory);  // include failed trajectory
 
@@ -192,6 +243,79 @@ void Connect::compute(const InterfaceState& from, const InterfaceState& to) {
 	connect(from, to, solution);
 }
 
+bool Connect::computeParallel(const InterfaceState& from, const InterfaceState& to) {
+	const double timeout = this->timeout();
+	const double max_distance = max_distance_.get();
+	const auto& path_constraints = path_constraints_.get();
+	const planning_scene::PlanningSceneConstPtr& start = from.scene();
+	const moveit::core::RobotState& final_goal_state = to.scene()->getCurrentState();
+
+	// each group's goal scene only differs from the start scene in the group's joints
+	const size_t num = planner_.size();
+	std::vector<const moveit::core::JointModelGroup*> groups;
+	std::vector<planning_scene::PlanningScenePtr> goals;
+	std::vector<double> positions;
+	for (const GroupPlannerVector::value_type& pair : planner_) {
+		const moveit::core::JointModelGroup* jmg = final_goal_state.getJointModelGroup(pair.first);
+		planning_scene::PlanningScenePtr end = start->diff();
+		final_goal_state.copyJointGroupPositions(jmg, positions);
+		moveit::core::RobotState& goal_state = end->getCurrentStateNonConst();
+		goal_state.setJointGroupPositions(jmg, positions);
+		goal_state.update();
+		groups.push_back(jmg);
+		goals.push_back(end);
+	}
+
+	// a planner instance that is not thread-safe must not be called concurrently: plan all its groups on one thread
+	std::vector<std::vector<size_t>> jobs;  // group indices per thread
+	std::map<const solvers::PlannerInterface*, size_t> planner_jobs;
+	for (size_t i = 0; i < num; ++i) {
+		const solvers::PlannerInterface* planner = planner_[i].second.get();
+		if (planner->isThreadSafe()) {
+			jobs.push_back({ i });
+			continue;
+		}
+		auto it = planner_jobs.emplace(planner, jobs.size()).first;
+		if (it->second == jobs.size())
+			jobs.emplace_back();
+		jobs[it->second].push_back(i);
+	}
+
+	std::vector<robot_trajectory::RobotTrajectoryPtr> trajectories(num);
+	std::vector<solvers::PlannerInterface::Result> results(num);
+	auto plan = [&](const std::vector<size_t>& job) {
+		for (size_t i : job)
+			results[i] = planner_[i].second->plan(start, goals[i], groups[i], timeout, trajectories[i], path_constraints);
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(jobs.size() - 1);
+	for (size_t j = 1; j < jobs.size(); ++j)
+		threads.emplace_back(plan, std::cref(jobs[j]));
+	plan(jobs[0]);
+	for (auto& thread : threads)
+		thread.join();
+
+	std::vector<robot_trajectory::RobotTrajectoryConstPtr> sub_trajectories;
+	for (size_t i = 0; i < num; ++i) {
+		if (!results[i] ||
+		    trajectories[i]->getLastWayPoint().distance(goals[i]->getCurrentState(), groups[i]) > max_distance) {
+			ROS_DEBUG_STREAM_NAMED("Connect", fmt::format("{}: parallel planning failed for group {}: {}", name(),
+			                                              groups[i]->getName(), results[i].message));
+			return false;
+		}
+		sub_trajectories.push_back(trajectories[i]);
+	}
+
+	// merge and validate the combined motion w.r.t. the common start scene
+	SubTrajectoryPtr solution = merge(sub_trajectories, { start }, start->getCurrentState());
+	if (!solution) {
+		ROS_DEBUG_STREAM_NAMED("Connect", fmt::format("{}: merged parallel motion is invalid", name()));
+		return false;
+	}
+	connect(from, to, solution);
+	return true;
+}
+
 SolutionSequencePtr
 Connect::makeSequential(const std::vector<robot_trajectory::RobotTrajectoryConstPtr>& sub_trajectories,
                         const std::vector<planning_scene::PlanningSceneConstPtr>& intermediate_scenes,
@@ -236,16 +360,17 @@ SubTrajectoryPtr Connect::merge(const std::vector<robot_trajectory::RobotTraject
 	if (sub_trajectories.size() == 1)
 		return std::make_shared<SubTrajectory>(sub_trajectories[0]);
 
-	auto jmg = merged_jmg_.get();
+	const moveit::core::JointModelGroup* jmg = merged_jmg_.get();
 	assert(jmg);
-	auto timing = properties().get<TimeParameterizationPtr>("merge_time_parameterization");
+	const auto& timing = merge_time_parameterization_.get();
 	robot_trajectory::RobotTrajectoryPtr trajectory = task_constructor::merge(sub_trajectories, state, jmg, *timing);
 	if (!trajectory)
 		return SubTrajectoryPtr();
 
-	// check merged trajectory for collisions
-	if (!intermediate_scenes.front()->isPathValid(*trajectory,
-	                                              properties().get<moveit_msgs::Constraints>("path_constraints")))
+	// check merged trajectory for collisions, stopping at the first invalid waypoint
+	PathValidationOptions options;
+	options.num_threads = validation_threads_.get();
+	if (!isPathValid(*intermediate_scenes.front(), *trajectory, path_constraints_.get(), options))
 		return SubTrajectoryPtr();
 
 	return std::make_shared<SubTrajectory>(trajectory);
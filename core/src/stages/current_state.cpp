@@ -60,6 +60,17 @@ CurrentState::CurrentState(const std::string& name) : Generator(name) {
 	timeout.setValue(DEFAULT_TIMEOUT.count());
 }
 
+Stage::pointer CurrentState::cloneStage() const {
+	auto copy = std::make_unique<CurrentState>(name());
+	copyConfigTo(*copy);
+	return copy;
+}
+
+void CurrentState::reset() {
+	Generator::reset();
+	scene_.reset();  // fetch the scene again in the next run
+}
+
 void CurrentState::init(const moveit::core::RobotModelConstPtr& robot_model) {
 	Generator::init(robot_model);
 	robot_model_ = robot_model;
@@ -64,6 +64,12 @@ FixCollisionObjects::FixCollisionObjects(const std::string& name) : PropagatingE
 	p.declare<geometry_msgs::Vector3>("direction", "direction vector to use for corrections");
 }
 
+Stage::pointer FixCollisionObjects::cloneStage() const {
+	auto copy = std::make_unique<FixCollisionObjects>(name());
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void FixCollisionObjects::computeForward(const InterfaceState& from) {
 	planning_scene::PlanningScenePtr to = from.scene()->diff();
 	sendForward(from, InterfaceState(to), fixCollisions(*to));
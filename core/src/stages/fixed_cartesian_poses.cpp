@@ -57,6 +57,12 @@ FixedCartesianPoses::FixedCartesianPoses(const std::string& name) : MonitoringGe
 	p.declare<PosesList>("poses", PosesList(), "target poses to spawn");
 }
 
+Stage::pointer FixedCartesianPoses::cloneStage() const {
+	auto copy = std::make_unique<FixedCartesianPoses>(name());
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void FixedCartesianPoses::addPose(const geometry_msgs::PoseStamped& pose) {
 	moveit::task_constructor::Property& poses = properties().property("poses");
 	if (!poses.defined())
@@ -49,6 +49,12 @@ FixedState::FixedState(const std::string& name, planning_scene::PlanningScenePtr
 	setCostTerm(std::make_unique<cost::Constant>(0.0));
 }
 
+Stage::pointer FixedState::cloneStage() const {
+	auto copy = std::make_unique<FixedState>(name(), scene_);  // sharing the scene
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void FixedState::setState(const planning_scene::PlanningScenePtr& scene) {
 	scene_ = scene;
 }
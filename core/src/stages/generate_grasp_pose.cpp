@@ -60,6 +60,12 @@ GenerateGraspPose::GenerateGraspPose(const std::string& name) : GeneratePose(nam
 	p.declare<boost::any>("grasp", "grasp posture");
 }
 
+Stage::pointer GenerateGraspPose::cloneStage() const {
+	auto copy = std::make_unique<GenerateGraspPose>(name());
+	copyConfigTo(*copy);
+	return copy;
+}
+
 static void applyPreGrasp(moveit::core::RobotState& state, const moveit::core::JointModelGroup* jmg,
                           const Property& diff_property) {
 	try {
@@ -57,6 +57,12 @@ GeneratePlacePose::GeneratePlacePose(const std::string& name) : GeneratePose(nam
 	p.declare<bool>("allow_z_flip", false, "allow placing objects upside down");
 }
 
+Stage::pointer GeneratePlacePose::cloneStage() const {
+	auto copy = std::make_unique<GeneratePlacePose>(name());
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void GeneratePlacePose::onNewSolution(const SolutionBase& s) {
 	planning_scene::PlanningSceneConstPtr scene = s.end()->scene();
 
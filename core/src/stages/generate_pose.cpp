@@ -53,6 +53,12 @@ GeneratePose::GeneratePose(const std::string& name) : MonitoringGenerator(name)
 	p.declare<geometry_msgs::PoseStamped>("pose", "target pose to pass on in spawned states");
 }
 
+Stage::pointer GeneratePose::cloneStage() const {
+	auto copy = std::make_unique<GeneratePose>(name());
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void GeneratePose::reset() {
 	upstream_solutions_.clear();
 	MonitoringGenerator::reset();
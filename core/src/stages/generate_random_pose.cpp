@@ -48,8 +48,11 @@
 
 namespace {
 // TODO(henningkayser): support user-defined random number engines
-std::random_device RANDOM_DEVICE;
-std::mt19937 ENGINE(RANDOM_DEVICE());
+// one engine per thread, as clones of a stage share their samplers, but may be planned in parallel
+std::mt19937& engine() {
+	thread_local std::mt19937 engine(std::random_device{}());
+	return engine;
+}
 }  // namespace
 
 namespace moveit {
@@ -63,21 +66,24 @@ GenerateRandomPose::GenerateRandomPose(const std::string& name) : GeneratePose(n
 	p.property("timeout").setDefaultValue(1.0 /* seconds */);
 }
 
+Stage::pointer GenerateRandomPose::cloneStage() const {
+	auto copy = std::make_unique<GenerateRandomPose>(name());
+	copyConfigTo(*copy);
+	copy->pose_dimension_samplers_ = pose_dimension_samplers_;  // stateless for the supported distributions
+	return copy;
+}
+
 template <>
 GenerateRandomPose::PoseDimensionSampler
 GenerateRandomPose::getPoseDimensionSampler<std::normal_distribution>(double stddev) {
-	return [stddev](double mean) {
-		static std::normal_distribution<double> dist(mean, stddev);
-		return dist(ENGINE);
-	};
+	return [stddev](double mean) { return std::normal_distribution<double>(mean, stddev)(engine()); };
 }
 
 template <>
 GenerateRandomPose::PoseDimensionSampler
 GenerateRandomPose::getPoseDimensionSampler<std::uniform_real_distribution>(double range) {
 	return [range](double mean) {
-		static std::uniform_real_distribution<double> dist(mean - 0.5 * range, mean + 0.5 * range);
-		return dist(ENGINE);
+		return std::uniform_real_distribution<double>(mean - 0.5 * range, mean + 0.5 * range)(engine());
 	};
 }
 
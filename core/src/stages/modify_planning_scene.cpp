@@ -51,6 +51,16 @@ ModifyPlanningScene::ModifyPlanningScene(const std::string& name) : PropagatingE
 	setCostTerm(std::make_unique<cost::Constant>(0.0));
 }
 
+Stage::pointer ModifyPlanningScene::cloneStage() const {
+	auto copy = std::make_unique<ModifyPlanningScene>(name());
+	copyConfigTo(*copy);
+	copy->attach_objects_ = attach_objects_;
+	copy->collision_objects_ = collision_objects_;
+	copy->collision_matrix_edits_ = collision_matrix_edits_;
+	copy->callback_ = callback_;
+	return copy;
+}
+
 void ModifyPlanningScene::attachObjects(const Names& objects, const std::string& attach_link, bool attach) {
 	auto it_inserted = attach_objects_.insert(std::make_pair(attach_link, std::make_pair(Names(), attach)));
 	Names& o = it_inserted.first->second.first;
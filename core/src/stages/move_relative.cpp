@@ -67,6 +67,12 @@ MoveRelative::MoveRelative(const std::string& name, const solvers::PlannerInterf
 	                                    "constraints to maintain during trajectory");
 }
 
+Stage::pointer MoveRelative::cloneStage() const {
+	auto copy = std::make_unique<MoveRelative>(name(), planner_);  // sharing the planner
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void MoveRelative::setIKFrame(const Eigen::Isometry3d& pose, const std::string& link) {
 	geometry_msgs::PoseStamped pose_msg;
 	pose_msg.header.frame_id = link;
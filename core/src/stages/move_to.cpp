@@ -69,6 +69,12 @@ MoveTo::MoveTo(const std::string& name, const solvers::PlannerInterfacePtr& plan
 	                                    "constraints to maintain during trajectory");
 }
 
+Stage::pointer MoveTo::cloneStage() const {
+	auto copy = std::make_unique<MoveTo>(name(), planner_);  // sharing the planner
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void MoveTo::setIKFrame(const Eigen::Isometry3d& pose, const std::string& link) {
 	geometry_msgs::PoseStamped pose_msg;
 	pose_msg.header.frame_id = link;
@@ -92,6 +98,12 @@ void MoveTo::setGoal(const std::map<std::string, double>& joints) {
 void MoveTo::init(const moveit::core::RobotModelConstPtr& robot_model) {
 	PropagatingEitherWay::init(robot_model);
 	planner_->init(robot_model);
+
+	auto& p = properties();
+	group_ = p.handle<std::string>("group");
+	goal_ = p.handle<boost::any>("goal");
+	ik_frame_ = p.handle<geometry_msgs::PoseStamped>("ik_frame");
+	path_constraints_ = p.handle<moveit_msgs::Constraints>("path_constraints");
 }
 
 bool MoveTo::getJointStateGoal(const boost::any& goal, const moveit::core::JointModelGroup* jmg,
@@ -180,21 +192,20 @@ bool MoveTo::compute(const InterfaceState& state, planning_scene::PlanningSceneP
 	const moveit::core::RobotModelConstPtr& robot_model = scene->getRobotModel();
 	assert(robot_model);
 
-	const auto& props = properties();
 	double timeout = this->timeout();
-	const std::string& group = props.get<std::string>("group");
+	const std::string& group = group_.get();
 	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(group);
 	if (!jmg) {
 		solution.markAsFailure("invalid joint model group: " + group);
 		return false;
 	}
-	boost::any goal = props.get("goal");
+	const boost::any& goal = goal_.property().value();
 	if (goal.empty()) {
 		solution.markAsFailure("undefined goal");
 		return false;
 	}
 
-	const auto& path_constraints = props.get<moveit_msgs::Constraints>("path_constraints");
+	const auto& path_constraints = path_constraints_.get();
 	robot_trajectory::RobotTrajectoryPtr robot_trajectory;
 	bool success = false;
 	std::string comment = "";
@@ -215,7 +226,7 @@ bool MoveTo::compute(const InterfaceState& state, planning_scene::PlanningSceneP
 		Eigen::Isometry3d ik_pose_world;
 		std::string error_msg;
 
-		if (!utils::getRobotTipForFrame(props.property("ik_frame"), *scene, jmg, error_msg, link, ik_pose_world)) {
+		if (!utils::getRobotTipForFrame(ik_frame_.property(), *scene, jmg, error_msg, link, ik_pose_world)) {
 			solution.markAsFailure(error_msg);
 			return false;
 		}
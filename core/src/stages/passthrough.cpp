@@ -41,6 +41,13 @@ namespace stages {
 
 PassThrough::PassThrough(const std::string& name, Stage::pointer&& child) : WrapperBase(name, std::move(child)) {}
 
+Stage::pointer PassThrough::cloneStage() const {
+	auto copy = std::make_unique<PassThrough>(name());
+	copyConfigTo(*copy);
+	cloneChildrenTo(*copy);
+	return copy;
+}
+
 void PassThrough::onNewSolution(const SolutionBase& s) {
 	this->liftSolution(s);
 }
@@ -65,6 +65,26 @@ PickPlaceBase::PickPlaceBase(Stage::pointer&& grasp_stage, const std::string& na
 	}
 }
 
+void PickPlaceBase::copyPickPlaceConfigTo(PickPlaceBase& other) const {
+	copyConfigTo(other);
+	other.cartesian_solver_->properties() = cartesian_solver_->properties();
+	// the remaining children are created internally and only differ by their properties
+	other.approach_stage_->properties() = approach_stage_->properties();
+	other.lift_stage_->properties() = lift_stage_->properties();
+}
+
+Stage::pointer Pick::cloneStage() const {
+	auto copy = std::make_unique<Pick>(cloneGraspStage(), name());
+	copyPickPlaceConfigTo(*copy);
+	return copy;
+}
+
+Stage::pointer Place::cloneStage() const {
+	auto copy = std::make_unique<Place>(cloneGraspStage(), name());
+	copyPickPlaceConfigTo(*copy);
+	return copy;
+}
+
 void PickPlaceBase::init(const moveit::core::RobotModelConstPtr& robot_model) {
 	// inherit properties from parent
 	PropertyMap* p = &properties();
@@ -55,6 +55,13 @@ PredicateFilter::PredicateFilter(const std::string& name, Stage::pointer&& child
 	p.declare<bool>("ignore_filter", false, "ignore predicate and forward all solutions");
 }
 
+Stage::pointer PredicateFilter::cloneStage() const {
+	auto copy = std::make_unique<PredicateFilter>(name());
+	copyConfigTo(*copy);
+	cloneChildrenTo(*copy);
+	return copy;
+}
+
 void PredicateFilter::init(const moveit::core::RobotModelConstPtr& robot_model) {
 	InitStageException errors;
 
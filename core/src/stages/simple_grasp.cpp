@@ -138,6 +138,13 @@ void SimpleGraspBase::setup(std::unique_ptr<Stage>&& generator, bool forward) {
 	}
 }
 
+void SimpleGraspBase::copySimpleGraspConfigTo(SimpleGraspBase& other) const {
+	copyConfigTo(other);
+	// the other children's initializers refer to their container, so only the IK stage is cloned
+	if (const auto* ik = dynamic_cast<const ComputeIK*>((*this)[0]))
+		other.insert(ik->cloneStage(), 0);
+}
+
 void SimpleGraspBase::init(const moveit::core::RobotModelConstPtr& robot_model) {
 	model_ = robot_model;
 	SerialContainer::init(robot_model);
@@ -154,9 +161,21 @@ SimpleGrasp::SimpleGrasp(std::unique_ptr<Stage>&& generator, const std::string&
 	setup(std::move(generator), true);
 }
 
+Stage::pointer SimpleGrasp::cloneStage() const {
+	auto copy = std::make_unique<SimpleGrasp>(Stage::pointer(), name());
+	copySimpleGraspConfigTo(*copy);
+	return copy;
+}
+
 SimpleUnGrasp::SimpleUnGrasp(std::unique_ptr<Stage>&& generator, const std::string& name) : SimpleGraspBase(name) {
 	setup(std::move(generator), false);
 }
+
+Stage::pointer SimpleUnGrasp::cloneStage() const {
+	auto copy = std::make_unique<SimpleUnGrasp>(Stage::pointer(), name());
+	copySimpleGraspConfigTo(*copy);
+	return copy;
+}
 }  // namespace stages
 }  // namespace task_constructor
 }  // namespace moveit
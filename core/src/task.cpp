@@ -38,6 +38,9 @@
 #include <moveit/task_constructor/container_p.h>
 #include <moveit/task_constructor/task_p.h>
 #include <moveit/task_constructor/introspection.h>
+#include <moveit/task_constructor/ik_cache.h>
+#include <moveit/task_constructor/solution_store.h>
+#include <moveit/task_constructor/trajectory_validation.h>
 #include <moveit_task_constructor_msgs/ExecuteTaskSolutionAction.h>
 
 #include <ros/ros.h>
@@ -45,10 +48,17 @@
 
 #include <moveit/robot_model_loader/robot_model_loader.h>
 #include <moveit/planning_pipeline/planning_pipeline.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_state/conversions.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
 
 #include <scope_guard/scope_guard.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <functional>
+#include <map>
+#include <typeinfo>
+#include <unordered_map>
 
 namespace {
 std::string rosNormalizeName(const std::string& name) {
@@ -73,8 +83,128 @@ std::string rosNormalizeName(const std::string& name) {
 namespace moveit {
 namespace task_constructor {
 
+namespace {
+// all stages in depth-first order: their index identifies solution creators in a SolutionStore
+std::vector<Stage*> stageList(const ContainerBase& root) {
+	std::vector<Stage*> stages;
+	root.traverseRecursively([&stages](const Stage& stage, unsigned int /*depth*/) {
+		stages.push_back(const_cast<Stage*>(&stage));
+		return true;
+	});
+	return stages;
+}
+
+// collect the sub trajectories of solution in execution order, returns false for unknown solution types
+bool flatten(const SolutionBase& solution, std::vector<const SubTrajectory*>& result) {
+	if (const auto* sequence = dynamic_cast<const SolutionSequence*>(&solution)) {
+		for (const SolutionBase* s : sequence->solutions())
+			if (!flatten(*s, result))
+				return false;
+		return true;
+	}
+	if (const auto* wrapped = dynamic_cast<const WrappedSolution*>(&solution))
+		return flatten(*wrapped->wrapped(), result);
+	if (const auto* sub = dynamic_cast<const SubTrajectory*>(&solution)) {
+		result.push_back(sub);
+		return true;
+	}
+	return false;
+}
+
+// serialize solution as a flat list of sub trajectories, identifying their creators by their index in stage_ids
+bool toFlatMsg(const SolutionBase& solution, const std::unordered_map<const Stage*, uint32_t>& stage_ids,
+               moveit_task_constructor_msgs::Solution& msg) {
+	std::vector<const SubTrajectory*> subs;
+	if (!flatten(solution, subs))
+		return false;
+
+	solution.toMsg(msg);
+	if (msg.sub_trajectory.size() != subs.size())
+		return false;
+	for (std::size_t i = 0; i < subs.size(); ++i) {
+		auto it = stage_ids.find(subs[i]->creator());
+		if (it == stage_ids.end())
+			return false;
+		msg.sub_trajectory[i].info.stage_id = it->second;
+	}
+	// sub solutions are not restored: only keep cost and comment of the overall solution
+	msg.sub_solution.clear();
+	msg.sub_solution.emplace_back();
+	solution.fillInfo(msg.sub_solution.front().info);
+	return true;
+}
+
+// solution restored from a message, owning its sub trajectories and their interface states
+class RestoredSolution : public SolutionSequence
+{
+public:
+	/** rebuild from msg, validating all trajectories in the scene evolving from start
+	 *
+	 * Returns the end scene or nullptr if a sub trajectory is invalid. In that case, invalid_stage is its creator.
+	 */
+	planning_scene::PlanningSceneConstPtr restore(const moveit_task_constructor_msgs::Solution& msg,
+	                                              const planning_scene::PlanningSceneConstPtr& start,
+	                                              const std::vector<Stage*>& stages, const Stage*& invalid_stage) {
+		planning_scene::PlanningSceneConstPtr scene = start;
+		states_.emplace_back(scene);
+		invalid_stage = nullptr;
+		for (const auto& sub : msg.sub_trajectory) {
+			invalid_stage = sub.info.stage_id < stages.size() ? stages[sub.info.stage_id] : nullptr;
+			if (!invalid_stage)
+				return nullptr;
+
+			auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(scene->getRobotModel(), nullptr);
+			trajectory->setRobotTrajectoryMsg(scene->getCurrentState(), sub.trajectory);
+			// trajectories need to continue from the current state and be valid in the current scene
+			if (!trajectory->empty() && (trajectory->getFirstWayPoint().distance(scene->getCurrentState()) > 1e-3 ||
+			                             !isPathValid(*scene, *trajectory)))
+				return nullptr;
+
+			// rebase the sub trajectory's changes onto the current scene: a full scene would override start
+			auto next = scene->diff();
+			if (sub.scene_diff.is_diff)
+				next->setPlanningSceneDiffMsg(sub.scene_diff);
+			else {  // scene created from scratch (e.g. by a generator): only keep its robot's joint state
+				moveit_msgs::RobotState robot_state = sub.scene_diff.robot_state;
+				robot_state.attached_collision_objects.clear();
+				robot_state.is_diff = true;
+				moveit::core::robotStateMsgToRobotState(robot_state, next->getCurrentStateNonConst());
+			}
+
+			trajectories_.emplace_back(trajectory->empty() ? nullptr : trajectory, sub.info.cost, sub.info.comment);
+			SubTrajectory& t = trajectories_.back();
+			t.setCreator(stages[sub.info.stage_id]);
+			t.setStartState(states_.back());
+			states_.emplace_back(next);
+			t.setEndState(states_.back());
+			push_back(t);
+			scene = next;
+		}
+		invalid_stage = nullptr;
+		if (!msg.sub_solution.empty()) {
+			setCost(msg.sub_solution.front().info.cost);
+			setComment(msg.sub_solution.front().info.comment);
+		}
+		return scene;
+	}
+
+private:
+	std::list<InterfaceState> states_;
+	std::list<SubTrajectory> trajectories_;
+};
+}  // namespace
+
 TaskPrivate::TaskPrivate(Task* me, const std::string& ns)
-  : WrapperBasePrivate(me, std::string()), ns_(rosNormalizeName(ns)), preempt_requested_(false) {}
+  : WrapperBasePrivate(me, std::string())
+  , ns_(rosNormalizeName(ns))
+  , preempt_requested_(false)
+  , reset_run_only_(false)
+  , replanning_(false)
+  , initialized_(false)
+  , init_fingerprint_(0) {
+	setResetRunOnlyMember(&reset_run_only_);
+	setReplanningMember(&replanning_);
+}
 
 TaskPrivate& TaskPrivate::operator=(TaskPrivate&& other) {
 	this->WrapperBasePrivate::operator=(std::move(other));
@@ -82,6 +212,9 @@ TaskPrivate& TaskPrivate::operator=(TaskPrivate&& other) {
 	robot_model_ = std::move(other.robot_model_);
 	robot_model_loader_ = std::move(other.robot_model_loader_);
 	task_cbs_ = std::move(other.task_cbs_);
+	solution_store_ = std::move(other.solution_store_);
+	// stages refer to members of other: require re-initialization
+	initialized_ = false;
 	// Ensure same introspection status, but keep the existing introspection instance,
 	// which stores this task pointer and includes it in its task_id_
 	static_cast<Task*>(me_)->enableIntrospection(static_cast<bool>(other.introspection_));
@@ -92,6 +225,64 @@ const ContainerBase* TaskPrivate::stages() const {
 	return children().empty() ? nullptr : static_cast<ContainerBase*>(children().front().get());
 }
 
+uint64_t TaskPrivate::solutionKey(const planning_scene::PlanningScene& start_scene) const {
+	std::size_t seed = static_cast<const Task*>(me())->fingerprint();
+	boost::hash_combine(seed, IKCache::sceneFingerprint(start_scene, nullptr));
+	return seed;
+}
+
+void TaskPrivate::storeSolutions() {
+	std::unordered_map<const Stage*, uint32_t> stage_ids;
+	for (const Stage* stage : stageList(*stages()))
+		stage_ids.emplace(stage, stage_ids.size());
+
+	// solutions are ordered by cost, group them by start scene
+	std::map<uint64_t, std::vector<moveit_task_constructor_msgs::Solution>> solutions;
+	for (const SolutionBaseConstPtr& solution : stages()->solutions()) {
+		auto& msgs = solutions[solutionKey(*solution->start()->scene())];
+		if (msgs.size() >= solution_store_->maxSolutions())
+			continue;
+		msgs.emplace_back();
+		if (!toFlatMsg(*solution, stage_ids, msgs.back()))
+			msgs.pop_back();
+	}
+	for (const auto& [key, msgs] : solutions)
+		solution_store_->store(key, msgs);
+}
+
+std::size_t TaskPrivate::restoreSolutions(const planning_scene::PlanningSceneConstPtr& start_scene) {
+	const uint64_t key = solutionKey(*start_scene);
+	std::vector<moveit_task_constructor_msgs::Solution> msgs = solution_store_->load(key);
+	if (msgs.empty())
+		return 0;
+
+	const std::size_t num_stored = msgs.size();
+	spawnSolutions(start_scene, msgs);
+	if (msgs.size() != num_stored)  // drop solutions that became invalid
+		solution_store_->store(key, msgs);
+	return msgs.size();
+}
+
+void TaskPrivate::spawnSolutions(const planning_scene::PlanningSceneConstPtr& start_scene,
+                                 std::vector<moveit_task_constructor_msgs::Solution>& msgs) {
+	ContainerBase* root = static_cast<Task*>(me())->stages();
+	const std::vector<Stage*> stages = stageList(*root);
+	auto valid_end = msgs.begin();
+	for (auto& msg : msgs) {
+		auto solution = std::make_shared<RestoredSolution>();
+		const Stage* invalid_stage;
+		planning_scene::PlanningSceneConstPtr end = solution->restore(msg, start_scene, stages, invalid_stage);
+		if (!end) {
+			if (invalid_stage)
+				ROS_DEBUG_STREAM_NAMED("Task", root->name() << ": solution invalidated by " << invalid_stage->name());
+			continue;
+		}
+		root->pimpl()->spawn(InterfaceState(start_scene), InterfaceState(end), solution);
+		*valid_end++ = std::move(msg);
+	}
+	msgs.erase(valid_end, msgs.end());
+}
+
 Task::Task(const std::string& ns, bool introspection, ContainerBase::pointer&& container)
   : WrapperBase(new TaskPrivate(this, ns), std::move(container)) {
 	setPruning(false);
@@ -115,6 +306,33 @@ Task& Task::operator=(Task&& other) {  // NOLINT(performance-noexcept-move-const
 	return *this;
 }
 
+Task Task::clone() const {
+	auto impl = pimpl();
+	Task copy(impl->ns_, false, ContainerBase::pointer(static_cast<ContainerBase*>(stages()->cloneStage().release())));
+	copyConfigTo(copy);
+	auto copy_impl = copy.pimpl();
+	copy_impl->robot_model_loader_ = impl->robot_model_loader_;
+	copy_impl->robot_model_ = impl->robot_model_;
+	copy_impl->solution_store_ = impl->solution_store_;
+
+	// redirect monitoring generators to the copies of their monitored stages
+	const std::vector<Stage*> originals = stageList(*stages());
+	const std::vector<Stage*> copied_stages = stageList(*copy.stages());
+	assert(originals.size() == copied_stages.size());
+	std::unordered_map<const Stage*, Stage*> copies;
+	for (std::size_t i = 0; i < originals.size(); ++i)
+		copies.emplace(originals[i], copied_stages[i]);
+	for (Stage* stage : copied_stages) {
+		auto* monitoring = dynamic_cast<MonitoringGenerator*>(stage);
+		if (!monitoring)
+			continue;
+		auto it = copies.find(monitoring->pimpl()->monitored_);
+		if (it != copies.end())
+			monitoring->setMonitoredStage(it->second);
+	}
+	return copy;
+}
+
 Task::~Task() {
 	auto impl = pimpl();
 	impl->introspection_.reset();  // stop introspection
@@ -130,8 +348,10 @@ void Task::setRobotModel(const core::RobotModelConstPtr& robot_model) {
 		return;
 	}
 	auto impl = pimpl();
-	if (impl->robot_model_ && impl->robot_model_ != robot_model)
+	if (impl->robot_model_ && impl->robot_model_ != robot_model) {
+		impl->initialized_ = false;
 		reset();  // solutions, scenes, etc become invalid
+	}
 	impl->robot_model_ = robot_model;
 }
 
@@ -152,12 +372,14 @@ void Task::insert(Stage::pointer&& stage, int before) {
 }
 
 void Task::clear() {
+	pimpl()->initialized_ = false;
 	reset();
 	stages()->clear();
 }
 
 void Task::enableIntrospection(bool enable) {
 	auto impl = pimpl();
+	impl->initialized_ = false;  // stages need to receive the new introspection instance
 	if (enable && !impl->introspection_)
 		impl->introspection_.reset(new Introspection(impl));
 	else if (!enable && impl->introspection_) {
@@ -195,11 +417,25 @@ void Task::reset() {
 	if (impl->introspection_)
 		impl->introspection_->reset();
 
+	// once initialized, only reset per-run state: init() checks whether re-initialization is required
+	impl->reset_run_only_ = impl->initialized_;
 	WrapperBase::reset();
+	impl->reset_run_only_ = false;
 }
 
 void Task::init() {
 	auto impl = pimpl();
+	// skip initialization if the stage tree and its configuration didn't change
+	if (impl->initialized_ && impl->init_fingerprint_ == fingerprint()) {
+		if (impl->introspection_)  // reset() published an empty task description
+			impl->introspection_->publishTaskDescription();
+		return;
+	}
+	if (impl->initialized_) {  // configuration changed: fully reset the initialized stage tree
+		impl->initialized_ = false;
+		reset();
+	}
+
 	if (!impl->robot_model_)
 		loadRobotModel();
 
@@ -213,12 +449,14 @@ void Task::init() {
 	// task expects its wrapped child to push to both ends, this triggers interface resolution
 	stages()->pimpl()->resolveInterface(InterfaceFlags({ GENERATE }));
 
-	// provide introspection instance and preempt_requested to all stages
+	// provide introspection instance, preempt_requested, reset_run_only, and replanning to all stages
 	auto* introspection = impl->introspection_.get();
 	impl->traverseStages(
 	    [introspection, impl](Stage& stage, int /*depth*/) {
 		    stage.pimpl()->setIntrospection(introspection);
 		    stage.pimpl()->setPreemptRequestedMember(&impl->preempt_requested_);
+		    stage.pimpl()->setResetRunOnlyMember(&impl->reset_run_only_);
+		    stage.pimpl()->setReplanningMember(&impl->replanning_);
 		    return true;
 	    },
 	    1, UINT_MAX);
@@ -226,6 +464,9 @@ void Task::init() {
 	// first time publish task
 	if (introspection)
 		introspection->publishTaskDescription();
+
+	impl->init_fingerprint_ = fingerprint();
+	impl->initialized_ = true;
 }
 
 bool Task::canCompute() const {
@@ -244,8 +485,49 @@ moveit::core::MoveItErrorCode Task::plan(size_t max_solutions) {
 	// ensure the preempt request is resetted once this method exits
 	auto guard = sg::make_scope_guard([this]() noexcept { this->resetPreemptRequest(); });
 
+	init();
+	return run(max_solutions);
+}
+
+moveit::core::MoveItErrorCode Task::plan(const planning_scene::PlanningSceneConstPtr& start_scene,
+                                         size_t max_solutions) {
+	auto guard = sg::make_scope_guard([this]() noexcept { this->resetPreemptRequest(); });
+
 	auto impl = pimpl();
+	if (!impl->solution_store_)
+		throw std::runtime_error("Task::plan(start_scene) requires a solution store");
 	init();
+	if (impl->restoreSolutions(start_scene) > 0) {
+		if (impl->introspection_)
+			impl->introspection_->publishTaskState();
+		return moveit::core::MoveItErrorCode::SUCCESS;
+	}
+	return run(max_solutions);
+}
+
+moveit::core::MoveItErrorCode Task::replan(const planning_scene::PlanningSceneConstPtr& new_start_scene,
+                                           size_t max_solutions) {
+	auto guard = sg::make_scope_guard([this]() noexcept { this->resetPreemptRequest(); });
+
+	auto impl = pimpl();
+	const auto& children = stages()->pimpl()->children();
+	auto* generator = children.empty() ? nullptr : dynamic_cast<Generator*>(children.front().get());
+	if (!generator)
+		throw std::runtime_error("Task::replan() requires a generator as first stage");
+
+	// keep the results of the last run: stages replay those computed from unchanged inputs
+	impl->replanning_ = true;
+	reset();
+	impl->replanning_ = false;
+	init();  // a modified configuration resets the task fully
+
+	generator->pimpl()->substitute(new_start_scene);
+	auto substitute_guard = sg::make_scope_guard([generator]() noexcept { generator->pimpl()->substitute(nullptr); });
+	return run(max_solutions);
+}
+
+moveit::core::MoveItErrorCode Task::run(size_t max_solutions) {
+	auto impl = pimpl();
 
 	// Print state and return success if there are solutions otherwise the input error_code
 	const auto success_or = [this](const int32_t error_code) -> int32_t {
@@ -255,20 +537,27 @@ moveit::core::MoveItErrorCode Task::plan(size_t max_solutions) {
 		explainFailure();
 		return error_code;
 	};
+	int32_t error_code = moveit::core::MoveItErrorCode::PLANNING_FAILED;
 	const double available_time = timeout();
 	const auto start_time = std::chrono::steady_clock::now();
 	while (canCompute() && (max_solutions == 0 || numSolutions() < max_solutions)) {
-		if (impl->preempt_requested_)
-			return success_or(moveit::core::MoveItErrorCode::PREEMPTED);
-		if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() >= available_time)
-			return success_or(moveit::core::MoveItErrorCode::TIMED_OUT);
+		if (impl->preempt_requested_) {
+			error_code = moveit::core::MoveItErrorCode::PREEMPTED;
+			break;
+		}
+		if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() >= available_time) {
+			error_code = moveit::core::MoveItErrorCode::TIMED_OUT;
+			break;
+		}
 		compute();
 		for (const auto& cb : impl->task_cbs_)
 			cb(*this);
 		if (impl->introspection_)
 			impl->introspection_->publishTaskState();
 	};
-	return success_or(moveit::core::MoveItErrorCode::PLANNING_FAILED);
+	if (impl->solution_store_ && numSolutions() > 0)
+		impl->storeSolutions();
+	return success_or(error_code);
 }
 
 void Task::preempt() {
@@ -299,6 +588,38 @@ void Task::publishAllSolutions(bool wait) {
 	pimpl()->introspection_->publishAllSolutions(wait);
 }
 
+void Task::setSolutionStore(const SolutionStorePtr& store) {
+	pimpl()->solution_store_ = store;
+}
+
+const SolutionStorePtr& Task::solutionStore() const {
+	return pimpl()->solution_store_;
+}
+
+std::size_t Task::fingerprint() const {
+	std::size_t seed = 0;
+	if (const auto& robot_model = getRobotModel()) {
+		boost::hash_combine(seed, robot_model->getName());
+		for (const std::string& name : robot_model->getVariableNames()) {
+			const moveit::core::VariableBounds& bounds = robot_model->getVariableBounds(name);
+			boost::hash_combine(seed, name);
+			boost::hash_combine(seed, bounds.min_position_);
+			boost::hash_combine(seed, bounds.max_position_);
+		}
+	}
+	traverseRecursively([&seed](const Stage& stage, unsigned int depth) {
+		boost::hash_combine(seed, depth);
+		boost::hash_combine(seed, std::string(typeid(stage).name()));
+		boost::hash_combine(seed, stage.name());
+		for (const auto& pair : stage.properties()) {
+			boost::hash_combine(seed, pair.first);
+			boost::hash_combine(seed, pair.second.serialize());
+		}
+		return true;
+	});
+	return seed;
+}
+
 void Task::onNewSolution(const SolutionBase& s) {
 	// no need to call WrapperBase::onNewSolution!
 	auto impl = pimpl();
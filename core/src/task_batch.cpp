@@ -0,0 +1,102 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Parallel planning of multiple tasks, e.g. clones of a task for different targets
+ */
+
+#include <moveit/task_constructor/task_batch.h>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace moveit {
+namespace task_constructor {
+
+TaskBatch::TaskBatch(std::size_t num_threads)
+  : num_threads_(num_threads ? num_threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::size_t TaskBatch::add(Task&& task) {
+	tasks_.push_back(std::make_unique<Task>(std::move(task)));
+	return tasks_.size() - 1;
+}
+
+std::vector<moveit::core::MoveItErrorCode> TaskBatch::plan(std::size_t max_solutions) {
+	preempt_requested_ = false;
+	// initialize sequentially, as loading robot models or planner plugins isn't thread-safe:
+	// plan() then finds the tasks initialized already
+	for (auto& task : tasks_) {
+		task->resetPreemptRequest();
+		task->reset();
+		task->init();
+	}
+
+	// workers fetch the next task from a shared counter
+	const std::size_t n = tasks_.size();
+	std::vector<moveit::core::MoveItErrorCode> results(
+	    n, moveit::core::MoveItErrorCode(moveit::core::MoveItErrorCode::PREEMPTED));
+	std::vector<std::exception_ptr> errors(n);
+	std::atomic<std::size_t> next{ 0 };
+	auto work = [&] {
+		for (std::size_t i = next++; i < n && !preempt_requested_; i = next++) {
+			try {
+				results[i] = tasks_[i]->plan(max_solutions);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+	};
+
+	const std::size_t num_workers = std::max<std::size_t>(1, std::min(num_threads_, n));
+	std::vector<std::thread> threads;
+	threads.reserve(num_workers - 1);
+	for (std::size_t i = 1; i < num_workers; ++i)
+		threads.emplace_back(work);
+	work();
+	for (auto& thread : threads)
+		thread.join();
+
+	for (const auto& error : errors)
+		if (error)
+			std::rethrow_exception(error);
+	return results;
+}
+
+void TaskBatch::preempt() {
+	preempt_requested_ = true;
+	for (auto& task : tasks_)
+		task->preempt();
+}
+}  // namespace task_constructor
+}  // namespace moveit
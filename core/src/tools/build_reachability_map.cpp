@@ -0,0 +1,81 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Build a reachability map for a group's link offline, to be used with ComputeIK::setReachabilityMap()
+ */
+
+#include <moveit/task_constructor/reachability_map.h>
+#include <moveit/robot_model_loader/robot_model_loader.h>
+
+#include <ros/ros.h>
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char** argv) {
+	ros::init(argc, argv, "build_reachability_map", ros::init_options::AnonymousName);
+	if (argc < 4) {
+		std::cerr << "usage: " << argv[0] << " <group> <link> <output file> [resolution = 0.05] [samples = 1000000]"
+		          << std::endl;
+		return 1;
+	}
+	const std::string group = argv[1];
+	const std::string link = argv[2];
+	const std::string file = argv[3];
+	const double resolution = argc > 4 ? std::stod(argv[4]) : 0.05;
+	const std::size_t samples = argc > 5 ? std::stoul(argv[5]) : 1000000;
+
+	robot_model_loader::RobotModelLoader loader("robot_description", false);
+	const moveit::core::RobotModelPtr& robot_model = loader.getModel();
+	if (!robot_model) {
+		std::cerr << "failed to load robot model from robot_description" << std::endl;
+		return 1;
+	}
+
+	try {
+		auto start = std::chrono::steady_clock::now();
+		auto map = moveit::task_constructor::ReachabilityMap::build(robot_model, group, link, resolution, samples);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		map->save(file);
+
+		const auto& size = map->size();
+		std::cout << "sampled " << samples << " poses of '" << link << "' in " << elapsed.count() << "s\n"
+		          << "grid: " << size[0] << " x " << size[1] << " x " << size[2] << " voxels of " << resolution
+		          << "m, occupancy: " << map->occupancy() << "\n"
+		          << "saved to " << file << std::endl;
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,377 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Persistent, memory-mapped cache of planned trajectories
+ */
+
+#include <moveit/task_constructor/trajectory_cache.h>
+#include <moveit/task_constructor/ik_cache.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <ros/serialization.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace moveit {
+namespace task_constructor {
+
+namespace {
+constexpr char MAGIC[8] = { 'M', 'T', 'C', 'T', 'R', 'A', 'J', 'C' };
+constexpr uint32_t VERSION = 2;
+constexpr std::size_t INITIAL_SIZE = 1 << 20;
+
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t used;  // end of the last entry
+};
+
+/* Each entry is followed by the key (padded to 8 bytes) and, for each waypoint,
+ * its duration from the previous waypoint and the positions, velocities, and accelerations of the group. */
+struct EntryHeader
+{
+	uint64_t size;  // of the whole entry
+	uint32_t key_size;
+	uint32_t num_waypoints;
+	uint32_t num_variables;
+	uint32_t valid;
+};
+
+constexpr std::size_t padded(std::size_t size) {
+	return (size + 7) & ~std::size_t(7);
+}
+
+// helper to assemble keys from strings and quantized values
+class KeyWriter
+{
+public:
+	explicit KeyWriter(double resolution) : resolution_(resolution) {}
+
+	KeyWriter& operator<<(const std::string& value) {
+		*this << static_cast<uint64_t>(value.size());
+		key_.append(value);
+		return *this;
+	}
+	KeyWriter& operator<<(uint64_t value) {
+		key_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		return *this;
+	}
+	KeyWriter& quantized(double value) { return *this << static_cast<uint64_t>(std::llround(value / resolution_)); }
+
+	KeyWriter& header(const planning_scene::PlanningScene& from, const moveit::core::JointModelGroup* jmg,
+	                  const moveit_msgs::Constraints& path_constraints, const std::string& planner_config) {
+		*this << jmg->getName() << static_cast<uint64_t>(IKCache::sceneFingerprint(from, jmg)) << planner_config;
+
+		// path constraints are stored verbatim
+		const uint32_t size = ros::serialization::serializationLength(path_constraints);
+		std::vector<uint8_t> buffer(size);
+		ros::serialization::OStream stream(buffer.data(), size);
+		ros::serialization::serialize(stream, path_constraints);
+		*this << std::string(buffer.begin(), buffer.end());
+
+		std::vector<double> positions;
+		from.getCurrentState().copyJointGroupPositions(jmg, positions);
+		for (double position : positions)
+			quantized(position);
+		return *this;
+	}
+
+	TrajectoryCache::Key key() { return std::move(key_); }
+
+private:
+	double resolution_;
+	std::string key_;
+};
+}  // namespace
+
+TrajectoryCache::TrajectoryCache(const std::string& file, std::size_t capacity, double resolution)
+  : file_(file), capacity_(std::max(capacity, sizeof(FileHeader))), resolution_(resolution) {
+	fd_ = ::open(file.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd_ < 0)
+		throw std::runtime_error("failed to open trajectory cache: " + file);
+	struct stat info;
+	if (::fstat(fd_, &info) != 0) {
+		::close(fd_);
+		throw std::runtime_error("failed to open trajectory cache: " + file);
+	}
+
+	const std::size_t file_size = info.st_size;
+	try {
+		if (file_size == 0) {  // new file
+			map(std::min(INITIAL_SIZE, capacity_));
+			FileHeader& header = *static_cast<FileHeader*>(mapping_);
+			std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+			header.version = VERSION;
+			header.used = sizeof(FileHeader);
+		} else {
+			if (file_size < sizeof(FileHeader))
+				throw std::runtime_error("invalid trajectory cache: " + file);
+			map(file_size);
+		}
+
+		const FileHeader& header = *static_cast<const FileHeader*>(mapping_);
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+			throw std::runtime_error("incompatible trajectory cache: " + file);
+		if (header.used > mapping_size_)
+			throw std::runtime_error("truncated trajectory cache: " + file);
+
+		// index valid entries, later ones replacing earlier ones of the same key
+		for (std::size_t offset = sizeof(FileHeader); offset < header.used;) {
+			const EntryHeader& e = *reinterpret_cast<const EntryHeader*>(entry(offset));
+			if (e.size < sizeof(EntryHeader) || offset + e.size > header.used)
+				throw std::runtime_error("corrupted trajectory cache: " + file);
+			if (e.valid)
+				index_[Key(entry(offset) + sizeof(EntryHeader), e.key_size)] = offset;
+			offset += e.size;
+		}
+	} catch (...) {
+		if (mapping_)
+			::munmap(mapping_, mapping_size_);
+		::close(fd_);
+		throw;
+	}
+	statistics_.entries = index_.size();
+}
+
+TrajectoryCache::~TrajectoryCache() {
+	if (mapping_)
+		::munmap(mapping_, mapping_size_);
+	if (fd_ >= 0)
+		::close(fd_);
+}
+
+void TrajectoryCache::map(std::size_t size) {
+	if (::ftruncate(fd_, size) != 0)
+		throw std::runtime_error("failed to resize trajectory cache: " + file_);
+	if (mapping_)
+		::munmap(mapping_, mapping_size_);
+	mapping_ = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+	if (mapping_ == MAP_FAILED) {
+		mapping_ = nullptr;
+		mapping_size_ = 0;
+		throw std::runtime_error("failed to map trajectory cache: " + file_);
+	}
+	mapping_size_ = size;
+}
+
+TrajectoryCache::Key TrajectoryCache::key(const planning_scene::PlanningScene& from,
+                                          const planning_scene::PlanningScene& to,
+                                          const moveit::core::JointModelGroup* jmg,
+                                          const moveit_msgs::Constraints& path_constraints,
+                                          const std::string& planner_config) const {
+	KeyWriter writer(resolution_);
+	writer.header(from, jmg, path_constraints, planner_config) << uint64_t(0);  // joint goal
+	std::vector<double> positions;
+	to.getCurrentState().copyJointGroupPositions(jmg, positions);
+	for (double position : positions)
+		writer.quantized(position);
+	return writer.key();
+}
+
+TrajectoryCache::Key TrajectoryCache::key(const planning_scene::PlanningScene& from,
+                                          const moveit::core::LinkModel& link, const Eigen::Isometry3d& target,
+                                          const moveit::core::JointModelGroup* jmg,
+                                          const moveit_msgs::Constraints& path_constraints,
+                                          const std::string& planner_config) const {
+	KeyWriter writer(resolution_);
+	writer.header(from, jmg, path_constraints, planner_config) << uint64_t(1) << link.getName();  // pose goal
+	Eigen::Quaterniond q(target.linear());
+	if (q.w() < 0)  // q and -q represent the same orientation
+		q.coeffs() *= -1.0;
+	for (double value : { target.translation().x(), target.translation().y(), target.translation().z(), q.x(), q.y(),
+	                      q.z(), q.w() })
+		writer.quantized(value);
+	return writer.key();
+}
+
+bool TrajectoryCache::lookup(const Key& key, const moveit::core::RobotState& base_state,
+                             const moveit::core::JointModelGroup* jmg, robot_trajectory::RobotTrajectory& trajectory) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = index_.find(key);
+	const EntryHeader* e = it == index_.end() ? nullptr : reinterpret_cast<const EntryHeader*>(entry(it->second));
+	if (!e || e->num_variables != jmg->getVariableCount()) {
+		++statistics_.misses;
+		return false;
+	}
+	++statistics_.hits;
+
+	const std::size_t n = e->num_variables;
+	const double* data =
+	    reinterpret_cast<const double*>(reinterpret_cast<const char*>(e) + sizeof(EntryHeader) + padded(e->key_size));
+	trajectory.clear();
+	moveit::core::RobotState state(base_state);
+	for (std::size_t i = 0; i < e->num_waypoints; ++i, data += 1 + 3 * n) {
+		state.setJointGroupPositions(jmg, data + 1);
+		state.setJointGroupVelocities(jmg, data + 1 + n);
+		state.setJointGroupAccelerations(jmg, data + 1 + 2 * n);
+		state.update();
+		trajectory.addSuffixWayPoint(state, data[0]);
+	}
+	return true;
+}
+
+void TrajectoryCache::insert(const Key& key, const robot_trajectory::RobotTrajectory& trajectory) {
+	const moveit::core::JointModelGroup* jmg = trajectory.getGroup();
+	if (!jmg)
+		throw std::runtime_error("TrajectoryCache: trajectory has no group");
+	const std::size_t n = jmg->getVariableCount();
+	const std::size_t num_waypoints = trajectory.getWayPointCount();
+	const std::size_t size =
+	    sizeof(EntryHeader) + padded(key.size()) + num_waypoints * (1 + 3 * n) * sizeof(double);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (sizeof(FileHeader) + size > capacity_) {
+		++statistics_.dropped;
+		return;
+	}
+	if (static_cast<const FileHeader*>(mapping_)->used + size > capacity_)
+		compact(size);
+	const std::size_t offset = static_cast<const FileHeader*>(mapping_)->used;
+	if (offset + size > mapping_size_)  // grow geometrically
+		map(std::min(capacity_, std::max(offset + size, 2 * mapping_size_)));
+
+	EntryHeader& e = *reinterpret_cast<EntryHeader*>(entry(offset));
+	e.size = size;
+	e.key_size = key.size();
+	e.num_waypoints = num_waypoints;
+	e.num_variables = n;
+	e.valid = 1;
+	std::memcpy(entry(offset) + sizeof(EntryHeader), key.data(), key.size());
+
+	double* data = reinterpret_cast<double*>(entry(offset) + sizeof(EntryHeader) + padded(key.size()));
+	for (std::size_t i = 0; i < num_waypoints; ++i, data += 1 + 3 * n) {
+		const moveit::core::RobotState& state = trajectory.getWayPoint(i);
+		data[0] = trajectory.getWayPointDurationFromPrevious(i);
+		state.copyJointGroupPositions(jmg, data + 1);
+		// velocities and accelerations are undefined unless set
+		if (state.hasVelocities())
+			state.copyJointGroupVelocities(jmg, data + 1 + n);
+		else
+			std::fill(data + 1 + n, data + 1 + 2 * n, 0.0);
+		if (state.hasAccelerations())
+			state.copyJointGroupAccelerations(jmg, data + 1 + 2 * n);
+		else
+			std::fill(data + 1 + 2 * n, data + 1 + 3 * n, 0.0);
+	}
+	static_cast<FileHeader*>(mapping_)->used = offset + size;
+
+	auto [it, inserted] = index_.emplace(key, offset);
+	if (!inserted) {  // replace previous entry
+		reinterpret_cast<EntryHeader*>(entry(it->second))->valid = 0;
+		it->second = offset;
+	}
+	++statistics_.inserted;
+	statistics_.entries = index_.size();
+}
+
+void TrajectoryCache::compact(std::size_t size) {
+	FileHeader& header = *static_cast<FileHeader*>(mapping_);
+
+	// evict the oldest entries, i.e. those at the front of the file
+	std::size_t required = sizeof(FileHeader) + size;
+	for (std::size_t offset = sizeof(FileHeader); offset < header.used;) {
+		const EntryHeader& e = *reinterpret_cast<const EntryHeader*>(entry(offset));
+		if (e.valid)
+			required += e.size;
+		offset += e.size;
+	}
+	for (std::size_t offset = sizeof(FileHeader); required > capacity_;) {
+		EntryHeader& e = *reinterpret_cast<EntryHeader*>(entry(offset));
+		if (e.valid) {
+			e.valid = 0;
+			index_.erase(Key(entry(offset) + sizeof(EntryHeader), e.key_size));
+			required -= e.size;
+			++statistics_.evicted;
+		}
+		offset += e.size;
+	}
+
+	// close the gaps of invalid entries, keeping the order of the remaining ones
+	std::size_t end = sizeof(FileHeader);
+	for (std::size_t offset = sizeof(FileHeader); offset < header.used;) {
+		const EntryHeader& e = *reinterpret_cast<const EntryHeader*>(entry(offset));
+		const std::size_t entry_size = e.size;
+		if (e.valid) {
+			if (end != offset) {
+				std::memmove(entry(end), entry(offset), entry_size);  // e might be overwritten now
+				const EntryHeader& moved = *reinterpret_cast<const EntryHeader*>(entry(end));
+				index_[Key(entry(end) + sizeof(EntryHeader), moved.key_size)] = end;
+			}
+			end += entry_size;
+		}
+		offset += entry_size;
+	}
+	header.used = end;
+	statistics_.entries = index_.size();
+}
+
+void TrajectoryCache::invalidate(const Key& key) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = index_.find(key);
+	if (it == index_.end())
+		return;
+	reinterpret_cast<EntryHeader*>(entry(it->second))->valid = 0;
+	index_.erase(it);
+	++statistics_.rejected;
+	statistics_.entries = index_.size();
+}
+
+void TrajectoryCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	static_cast<FileHeader*>(mapping_)->used = sizeof(FileHeader);
+	index_.clear();
+	statistics_ = Statistics();
+}
+
+TrajectoryCache::Statistics TrajectoryCache::statistics() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	Statistics result = statistics_;
+	result.size = static_cast<const FileHeader*>(mapping_)->used;
+	result.capacity = capacity_;
+	return result;
+}
+}  // namespace task_constructor
+}  // namespace moveit
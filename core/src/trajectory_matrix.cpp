@@ -0,0 +1,217 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Contiguous waypoint-by-variable storage of trajectory positions
+ */
+
+#include <moveit/task_constructor/trajectory_matrix.h>
+#include <moveit/robot_model/revolute_joint_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace moveit {
+namespace task_constructor {
+
+namespace {
+constexpr double TWO_PI = 2.0 * M_PI;
+
+using RowArray = Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+bool isContinuous(const moveit::core::JointModel* jm) {
+	return jm->getType() == moveit::core::JointModel::REVOLUTE &&
+	       static_cast<const moveit::core::RevoluteJointModel*>(jm)->isContinuous();
+}
+
+/* Weighted joint distances as computed by JointModel::distance(), evaluated for many waypoints at once.
+ * Single-variable joints are reduced to a matrix-vector product of absolute differences with per-column
+ * weights (taking the shorter arc for continuous joints). Multi-dof joints use JointModel::distance(). */
+class DistanceKernel
+{
+	Eigen::VectorXd linear_;
+	Eigen::VectorXd wrapped_;
+	bool has_wrapped_ = false;
+	TrajectoryMatrix::JointWeights other_;
+
+public:
+	DistanceKernel(const TrajectoryMatrix::JointWeights& weights, Eigen::Index variables)
+	  : linear_(Eigen::VectorXd::Zero(variables)), wrapped_(Eigen::VectorXd::Zero(variables)) {
+		for (const auto& [jm, weight] : weights) {
+			if (jm->getVariableCount() != 1 || (jm->getType() != moveit::core::JointModel::REVOLUTE &&
+			                                    jm->getType() != moveit::core::JointModel::PRISMATIC)) {
+				other_.emplace_back(jm, weight);
+				continue;
+			}
+			const int index = jm->getFirstVariableIndex();
+			if (isContinuous(jm)) {
+				wrapped_[index] += weight;
+				has_wrapped_ = true;
+			} else
+				linear_[index] += weight;
+		}
+	}
+
+	/// distances between corresponding rows of a and b, or between all rows of a and the single row of b
+	Eigen::VectorXd operator()(const Eigen::Ref<const TrajectoryMatrix::Matrix>& a,
+	                           const Eigen::Ref<const TrajectoryMatrix::Matrix>& b) const {
+		const bool broadcast = b.rows() == 1;
+		RowArray diff = broadcast ? RowArray((a.rowwise() - b.row(0)).array().abs()) : RowArray((a - b).array().abs());
+
+		Eigen::VectorXd result = diff.matrix() * linear_;
+		if (has_wrapped_) {
+			diff -= TWO_PI * (diff / TWO_PI).floor();
+			result.noalias() += diff.min(TWO_PI - diff).matrix() * wrapped_;
+		}
+		for (const auto& [jm, weight] : other_) {
+			const int index = jm->getFirstVariableIndex();
+			for (Eigen::Index i = 0; i < a.rows(); ++i)
+				result[i] += weight * jm->distance(a.row(i).data() + index, b.row(broadcast ? 0 : i).data() + index);
+		}
+		return result;
+	}
+};
+}  // namespace
+
+TrajectoryMatrix::TrajectoryMatrix(const moveit::core::RobotState& state, std::size_t waypoints)
+  : TrajectoryMatrix(state.getRobotModel()) {
+	positions_ = Eigen::Map<const Eigen::RowVectorXd>(state.getVariablePositions(), state.getVariableCount())
+	                 .replicate(static_cast<Eigen::Index>(waypoints), 1);
+}
+
+TrajectoryMatrix::TrajectoryMatrix(const robot_trajectory::RobotTrajectory& trajectory)
+  : TrajectoryMatrix(trajectory.getRobotModel()) {
+	const Eigen::Index variables = robot_model_->getVariableCount();
+	positions_.resize(trajectory.getWayPointCount(), variables);
+	for (Eigen::Index i = 0; i < positions_.rows(); ++i)
+		positions_.row(i) =
+		    Eigen::Map<const Eigen::RowVectorXd>(trajectory.getWayPoint(i).getVariablePositions(), variables);
+}
+
+TrajectoryMatrix TrajectoryMatrix::interpolate(const moveit::core::RobotState& from, const moveit::core::RobotState& to,
+                                               const std::vector<double>& fractions) {
+	TrajectoryMatrix result(from.getRobotModel());
+	const moveit::core::RobotModel& robot_model = *result.robot_model_;
+	const Eigen::Index variables = robot_model.getVariableCount();
+	Eigen::Map<const Eigen::RowVectorXd> start(from.getVariablePositions(), variables);
+	Eigen::Map<const Eigen::RowVectorXd> goal(to.getVariablePositions(), variables);
+	Eigen::Map<const Eigen::VectorXd> t(fractions.data(), fractions.size());
+
+	// continuous joints move along the shorter arc and wrap around at +/- pi
+	Eigen::RowVectorXd diff = goal - start;
+	std::vector<Eigen::Index> wrapped;
+	for (const moveit::core::JointModel* jm : robot_model.getActiveJointModels()) {
+		const int index = jm->getFirstVariableIndex();
+		if (isContinuous(jm) && std::fabs(diff[index]) > M_PI) {
+			diff[index] -= std::copysign(TWO_PI, diff[index]);
+			wrapped.push_back(index);
+		}
+	}
+
+	// linear interpolation of all variables at once
+	Matrix& positions = result.positions_;
+	positions = (t * diff).rowwise() + start;
+	for (Eigen::Index index : wrapped) {
+		Eigen::ArrayXd column = positions.col(index);
+		positions.col(index) =
+		    (column > M_PI).select(column - TWO_PI, (column < -M_PI).select(column + TWO_PI, column)).matrix();
+	}
+
+	// joints interpolating non-linearly, e.g. planar or floating joints
+	for (const moveit::core::JointModel* jm : robot_model.getActiveJointModels()) {
+		if (jm->getType() == moveit::core::JointModel::REVOLUTE || jm->getType() == moveit::core::JointModel::PRISMATIC)
+			continue;
+		const int index = jm->getFirstVariableIndex();
+		for (Eigen::Index i = 0; i < positions.rows(); ++i)
+			jm->interpolate(start.data() + index, goal.data() + index, fractions[i], positions.row(i).data() + index);
+	}
+
+	// mimic joints follow their source joints
+	for (const moveit::core::JointModel* jm : robot_model.getMimicJointModels()) {
+		const Eigen::Index index = jm->getFirstVariableIndex();
+		const Eigen::Index source = jm->getMimic()->getFirstVariableIndex();
+		positions.col(index) = (jm->getMimicFactor() * positions.col(source).array() + jm->getMimicOffset()).matrix();
+	}
+	return result;
+}
+
+void TrajectoryMatrix::assignGroupPositions(const robot_trajectory::RobotTrajectory& trajectory) {
+	const std::size_t count = trajectory.getWayPointCount();
+	if (count == 0)
+		return;
+
+	const std::vector<int>& indices = trajectory.getGroup()->getVariableIndexList();
+	for (Eigen::Index i = 0; i < positions_.rows(); ++i) {
+		const double* source = trajectory.getWayPoint(std::min<std::size_t>(i, count - 1)).getVariablePositions();
+		double* target = positions_.row(i).data();
+		for (int index : indices)
+			target[index] = source[index];
+	}
+}
+
+robot_trajectory::RobotTrajectoryPtr
+TrajectoryMatrix::toRobotTrajectory(const moveit::core::RobotState& base_state,
+                                    const moveit::core::JointModelGroup* group) const {
+	auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, group);
+	for (Eigen::Index i = 0; i < positions_.rows(); ++i) {
+		auto state = std::make_shared<moveit::core::RobotState>(base_state);
+		state->setVariablePositions(positions_.row(i).data());
+		state->update();
+		trajectory->addSuffixWayPoint(state, 0.0);
+	}
+	return trajectory;
+}
+
+TrajectoryMatrix::JointWeights TrajectoryMatrix::distanceFactors(const moveit::core::RobotModel& robot_model) {
+	JointWeights weights;
+	weights.reserve(robot_model.getActiveJointModels().size());
+	for (const moveit::core::JointModel* jm : robot_model.getActiveJointModels())
+		weights.emplace_back(jm, jm->getDistanceFactor());
+	return weights;
+}
+
+Eigen::VectorXd TrajectoryMatrix::segmentLengths(const JointWeights& weights) const {
+	const Eigen::Index n = positions_.rows();
+	if (n < 2)
+		return Eigen::VectorXd();
+	return DistanceKernel(weights, positions_.cols())(positions_.topRows(n - 1), positions_.bottomRows(n - 1));
+}
+
+Eigen::VectorXd TrajectoryMatrix::distances(const double* reference, const JointWeights& weights) const {
+	const Eigen::Map<const Matrix> reference_row(reference, 1, positions_.cols());
+	return DistanceKernel(weights, positions_.cols())(positions_, reference_row);
+}
+}  // namespace task_constructor
+}  // namespace moveit
@@ -0,0 +1,139 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, Hamburg University
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Hamburg University nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Validation of trajectory waypoints with early exit, bisection ordering and threading
+ */
+
+#include <moveit/task_constructor/trajectory_validation.h>
+#include <moveit/kinematic_constraints/kinematic_constraint.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <numeric>
+#include <thread>
+
+namespace moveit {
+namespace task_constructor {
+
+std::vector<std::size_t> bisectionOrder(std::size_t n) {
+	std::vector<std::size_t> order;
+	order.reserve(n);
+	if (n == 0)
+		return order;
+	order.push_back(0);
+	if (n == 1)
+		return order;
+	order.push_back(n - 1);
+
+	// breadth-first traversal of open index intervals (lower, upper): largest intervals come first
+	std::deque<std::pair<std::size_t, std::size_t>> intervals;
+	if (n > 2)
+		intervals.emplace_back(0, n - 1);
+	while (!intervals.empty()) {
+		auto [lower, upper] = intervals.front();
+		intervals.pop_front();
+		std::size_t mid = lower + (upper - lower) / 2;
+		order.push_back(mid);
+		if (mid - lower > 1)
+			intervals.emplace_back(lower, mid);
+		if (upper - mid > 1)
+			intervals.emplace_back(mid, upper);
+	}
+	return order;
+}
+
+bool isPathValid(const planning_scene::PlanningScene& scene, const robot_trajectory::RobotTrajectory& trajectory,
+                 const moveit_msgs::Constraints& path_constraints, const PathValidationOptions& options,
+                 std::vector<std::size_t>* invalid_index) {
+	if (invalid_index)
+		invalid_index->clear();
+
+	const std::size_t n = trajectory.getWayPointCount();
+	if (n == 0)
+		return true;
+
+	kinematic_constraints::KinematicConstraintSet constraints(scene.getRobotModel());
+	constraints.add(path_constraints, scene.getTransforms());
+
+	// same checks as PlanningScene::isPathValid()
+	auto is_valid = [&](std::size_t index) {
+		const moveit::core::RobotState& state = trajectory.getWayPoint(index);
+		return !scene.isStateColliding(state, options.group) && scene.isStateFeasible(state) &&
+		       (constraints.empty() || constraints.decide(state).satisfied);
+	};
+
+	// early exit, unless all invalid waypoints are requested
+	const bool find_all = invalid_index && options.find_all;
+	std::vector<std::size_t> order;
+	if (find_all || options.order == PathValidationOptions::SEQUENTIAL) {
+		order.resize(n);
+		std::iota(order.begin(), order.end(), 0);
+	} else
+		order = bisectionOrder(n);
+
+	// workers fetch the next waypoint from a shared counter,
+	// stopping as soon as any invalid waypoint was found unless all of them are requested
+	std::atomic<std::size_t> next{ 0 };
+	std::atomic<bool> failed{ false };
+	std::vector<char> valid(invalid_index ? n : 0, 1);
+	auto work = [&] {
+		for (std::size_t i = next++; i < n && (find_all || !failed); i = next++) {
+			if (is_valid(order[i]))
+				continue;
+			failed = true;
+			if (invalid_index)
+				valid[order[i]] = 0;
+		}
+	};
+
+	const std::size_t num_workers = std::min<std::size_t>(std::max(1u, options.num_threads), n);
+	std::vector<std::thread> threads;
+	threads.reserve(num_workers - 1);
+	for (std::size_t i = 1; i < num_workers; ++i)
+		threads.emplace_back(work);
+	work();
+	for (auto& thread : threads)
+		thread.join();
+
+	if (invalid_index)
+		for (std::size_t i = 0; i < n; ++i)
+			if (!valid[i])
+				invalid_index->push_back(i);
+	return !failed;
+}
+}  // namespace task_constructor
+}  // namespace moveit
@@ -0,0 +1,77 @@
+#include "models.h"
+
+#include <moveit/task_constructor/sphere_collision_filter.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/robot_model.h>
+#include <geometric_shapes/shapes.h>
+
+#include <ros/ros.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace moveit::task_constructor;
+
+/* Benchmark of collision checks per second with and without SphereCollisionFilter
+ *
+ * Uses the robot model from robot_description, e.g. the UR5, PR2, or PA10 models of the pick_* tests:
+ *   roslaunch <robot>_moveit_config demo.launch
+ *   rosrun moveit_task_constructor_core benchmark_collision_filter <group> [num objects = 10]
+ */
+
+int main(int argc, char** argv) {
+	ros::init(argc, argv, "benchmark_collision_filter", ros::init_options::AnonymousName);
+	if (argc < 2) {
+		std::cerr << "usage: " << argv[0] << " <group> [num objects]" << std::endl;
+		return 1;
+	}
+	auto robot_model = loadModel();
+	if (!robot_model)
+		return 1;
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(argv[1]);
+	if (!jmg) {
+		std::cerr << "unknown group: " << argv[1] << std::endl;
+		return 1;
+	}
+	const size_t num_objects = argc > 2 ? std::stoul(argv[2]) : 10;
+
+	// random boxes within reach of the robot
+	auto scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<double> position(-1.0, 1.0);
+	for (size_t i = 0; i < num_objects; ++i)
+		scene->getWorldNonConst()->addToObject(
+		    "box" + std::to_string(i), std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+		    Eigen::Isometry3d(Eigen::Translation3d(position(rng), position(rng), std::abs(position(rng)))));
+
+	constexpr size_t STATES = 10000;
+	std::vector<moveit::core::RobotState> states(STATES, scene->getCurrentState());
+	for (auto& state : states) {
+		state.setToRandomPositions(jmg);
+		state.update();
+	}
+
+	auto measure = [&](const char* label, const auto& is_colliding) {
+		size_t colliding = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (const auto& state : states)
+			colliding += is_colliding(state);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << label << ": " << STATES / elapsed.count() << " checks/s (" << colliding << " colliding)"
+		          << std::endl;
+	};
+
+	measure("full check", [&](const moveit::core::RobotState& state) {
+		return scene->isStateColliding(state, jmg->getName());
+	});
+
+	SphereCollisionFilter filter(scene, jmg);
+	measure("with prefilter", [&](const moveit::core::RobotState& state) { return filter.isStateColliding(state); });
+
+	size_t decided = 0;
+	for (const auto& state : states)
+		decided += filter.check(state) != SphereCollisionFilter::UNKNOWN;
+	std::cout << "prefilter decided " << 100.0 * decided / STATES << "% of states" << std::endl;
+	return 0;
+}
@@ -0,0 +1,39 @@
+#include <moveit/task_constructor/properties.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace moveit::task_constructor;
+
+/* Micro benchmark comparing property access by name with access via pre-resolved PropertyHandles */
+
+namespace {
+constexpr size_t ITERATIONS = 1000000;
+
+template <typename F>
+void measure(const char* label, const F& f) {
+	double sum = 0.0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < ITERATIONS; ++i)
+		sum += f();
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << label << ": " << elapsed.count() / ITERATIONS << " ns/access (checksum " << sum << ")" << std::endl;
+}
+}  // namespace
+
+int main() {
+	// populate a map similar in size to a typical stage's property map
+	PropertyMap props;
+	for (const char* name : { "timeout", "marker_ns", "forwarded_properties", "trajectory_execution_info", "eef",
+	                          "group", "default_pose", "max_ik_solutions", "ignore_collisions", "constraints",
+	                          "ik_frame", "target_pose" })
+		props.declare<std::string>(name, name);
+	props.declare<double>("min_solution_distance", 0.1);
+
+	measure("PropertyMap::get<T>(name)", [&props]() { return props.get<double>("min_solution_distance"); });
+
+	const auto handle = props.handle<double>("min_solution_distance");
+	measure("PropertyHandle<T>::get()", [&handle]() { return handle.get(); });
+
+	return 0;
+}
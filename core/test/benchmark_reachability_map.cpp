@@ -0,0 +1,42 @@
+#include "models.h"
+
+#include <moveit/task_constructor/reachability_map.h>
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace moveit::task_constructor;
+
+/* Micro benchmark of building and querying a ReachabilityMap for the test robot model */
+
+int main() {
+	auto robot_model = getModel();
+	const std::string group = "group";
+	const std::string link = "link2";
+
+	for (size_t samples : { 10000, 100000, 1000000 }) {
+		auto start = std::chrono::steady_clock::now();
+		auto map = ReachabilityMap::build(robot_model, group, link, 0.02, samples);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << "build (" << samples << " samples): " << elapsed.count() << " s, occupancy " << map->occupancy()
+		          << std::endl;
+
+		// query random target poses within a box around the workspace
+		constexpr size_t QUERIES = 1000000;
+		std::vector<Eigen::Isometry3d> targets(QUERIES);
+		for (auto& target : targets)
+			target = Eigen::Translation3d(Eigen::Vector3d::Random() * 2.0) * Eigen::Quaterniond::UnitRandom();
+
+		size_t reachable = 0;
+		start = std::chrono::steady_clock::now();
+		for (const auto& target : targets)
+			reachable += map->reachable(target);
+		std::chrono::duration<double, std::nano> query = std::chrono::steady_clock::now() - start;
+		std::cout << "  query: " << query.count() / QUERIES << " ns/pose, rejected "
+		          << 100.0 * (QUERIES - reachable) / QUERIES << "% of random targets" << std::endl;
+	}
+	return 0;
+}
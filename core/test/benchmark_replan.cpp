@@ -0,0 +1,62 @@
+#include "models.h"
+#include "stage_mockups.h"
+
+#include <moveit/task_constructor/container.h>
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+
+using namespace moveit::task_constructor;
+
+/* Micro benchmark of the plan-to-plan overhead of a no-op task:
+ * reset() + plan() reusing the initialized stage tree vs. a full re-initialization for each plan()
+ */
+
+namespace {
+constexpr size_t ITERATIONS = 10000;
+
+// generator followed by serial and parallel containers of propagators, all producing empty trajectories
+void build(Task& t) {
+	resetMockupIds();
+	t.setRobotModel(getModel());
+	t.add(std::make_unique<GeneratorMockup>(PredefinedCosts::constant(0.0)));
+	for (int i = 0; i < 3; ++i) {
+		auto serial = std::make_unique<SerialContainer>("serial " + std::to_string(i));
+		for (int j = 0; j < 5; ++j)
+			serial->add(std::make_unique<ForwardMockup>());
+		t.add(std::move(serial));
+
+		auto alternatives = std::make_unique<Alternatives>("alternatives " + std::to_string(i));
+		for (int j = 0; j < 3; ++j)
+			alternatives->add(std::make_unique<ForwardMockup>());
+		t.add(std::move(alternatives));
+	}
+}
+
+template <typename F>
+void measure(const char* label, Task& t, const F& prepare) {
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < ITERATIONS; ++i) {
+		t.reset();
+		prepare(i);
+		if (!t.plan(1)) {
+			std::cerr << label << ": planning failed" << std::endl;
+			return;
+		}
+	}
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << label << ": " << elapsed.count() / ITERATIONS << " us/plan" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+	testing::InitGoogleTest(&argc, argv);  // PredefinedCosts reports via gtest
+
+	Task t("", false);
+	build(t);
+	measure("reset() + plan(), cached initialization", t, [](size_t /*i*/) {});
+	// modifying a property of the task forces a full re-initialization
+	measure("reset() + plan(), full initialization", t, [&t](size_t i) { t.setTimeout(1e6 + i); });
+	return 0;
+}
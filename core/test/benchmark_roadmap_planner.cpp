@@ -0,0 +1,97 @@
+#include "models.h"
+
+#include <moveit/task_constructor/solvers/pipeline_planner.h>
+#include <moveit/task_constructor/solvers/roadmap_planner.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <geometric_shapes/shapes.h>
+
+#include <ros/ros.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+using namespace moveit::task_constructor;
+
+/* Benchmark of RoadmapPlanner vs. PipelinePlanner on many Connect-like queries in a static scene
+ *
+ * Uses the robot model and planning pipeline of a running MoveIt config, e.g.:
+ *   roslaunch <robot>_moveit_config demo.launch
+ *   rosrun moveit_task_constructor_core benchmark_roadmap_planner <group> [num queries = 100] [roadmap file]
+ * If a roadmap file is given, roadmaps are loaded from it (if it exists) and saved to it afterwards.
+ */
+
+int main(int argc, char** argv) {
+	ros::init(argc, argv, "benchmark_roadmap_planner", ros::init_options::AnonymousName);
+	ros::AsyncSpinner spinner(1);
+	spinner.start();
+	if (argc < 2) {
+		std::cerr << "usage: " << argv[0] << " <group> [num queries] [roadmap file]" << std::endl;
+		return 1;
+	}
+	auto robot_model = loadModel();
+	if (!robot_model)
+		return 1;
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(argv[1]);
+	if (!jmg) {
+		std::cerr << "unknown group: " << argv[1] << std::endl;
+		return 1;
+	}
+	const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 100;
+	const std::string roadmap_file = argc > 3 ? argv[3] : "";
+
+	// random boxes within reach of the robot
+	auto scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<double> position(-1.0, 1.0);
+	for (size_t i = 0; i < 10; ++i)
+		scene->getWorldNonConst()->addToObject(
+		    "box" + std::to_string(i), std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+		    Eigen::Isometry3d(Eigen::Translation3d(position(rng), position(rng), std::abs(position(rng)))));
+
+	// collision-free start and goal scenes, chained like the states of consecutive Connect stages
+	std::vector<planning_scene::PlanningSceneConstPtr> scenes;
+	while (scenes.size() <= num_queries) {
+		auto next = scene->diff();
+		next->getCurrentStateNonConst().setToRandomPositions(jmg);
+		next->getCurrentStateNonConst().update();
+		if (!next->isStateColliding(next->getCurrentState(), jmg->getName()))
+			scenes.push_back(next);
+	}
+
+	auto measure = [&](const char* label, solvers::PlannerInterface& planner) {
+		planner.init(robot_model);
+		size_t solved = 0;
+		double length = 0.0;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < num_queries; ++i) {
+			robot_trajectory::RobotTrajectoryPtr trajectory;
+			if (planner.plan(scenes[i], scenes[i + 1], jmg, 5.0, trajectory)) {
+				++solved;
+				for (size_t j = 1; j < trajectory->getWayPointCount(); ++j)
+					length += trajectory->getWayPoint(j - 1).distance(trajectory->getWayPoint(j), jmg);
+			}
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << label << ": " << solved << "/" << num_queries << " solved, "
+		          << 1000.0 * elapsed.count() / num_queries << " ms/query, mean path length "
+		          << (solved ? length / solved : 0.0) << std::endl;
+	};
+
+	solvers::PipelinePlanner pipeline;
+	measure("PipelinePlanner", pipeline);
+
+	solvers::RoadmapPlanner roadmap;
+	if (!roadmap_file.empty() && std::ifstream(roadmap_file))
+		roadmap.load(roadmap_file, robot_model);
+	measure("RoadmapPlanner", roadmap);
+	// second pass over the same queries, reusing the roadmap built during the first one
+	measure("RoadmapPlanner (warm)", roadmap);
+	std::cout << "roadmap: " << roadmap.numNodes() << " nodes" << std::endl;
+	if (!roadmap_file.empty())
+		roadmap.save(roadmap_file);
+	return 0;
+}
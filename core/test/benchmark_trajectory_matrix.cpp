@@ -0,0 +1,134 @@
+#include "models.h"
+
+#include <moveit/task_constructor/merge.h>
+#include <moveit/task_constructor/trajectory_matrix.h>
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/trajectory_processing/time_parameterization.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace moveit::task_constructor;
+
+/* Micro benchmark comparing merging of sub trajectories and path length computation
+ * on RobotStates (the former implementation) with the contiguous TrajectoryMatrix.
+ * Reports run time and heap allocations per merged trajectory. */
+
+namespace {
+std::atomic<size_t> allocations{ 0 };
+}  // namespace
+
+// count all heap allocations of this process
+void* operator new(std::size_t size) {
+	++allocations;
+	if (void* p = std::malloc(size))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+	std::free(p);
+}
+
+namespace {
+constexpr size_t ITERATIONS = 1000;
+constexpr size_t WAYPOINTS = 100;
+
+// merging only, no timing
+struct NoTiming : public trajectory_processing::TimeParameterization
+{
+	bool computeTimeStamps(robot_trajectory::RobotTrajectory& /*trajectory*/, double /*max_velocity_scaling_factor*/,
+	                       double /*max_acceleration_scaling_factor*/) const override {
+		return true;
+	}
+};
+
+// former implementation of merge(): a RobotState per waypoint, group positions copied via std::vector
+robot_trajectory::RobotTrajectoryPtr
+mergeStates(const std::vector<robot_trajectory::RobotTrajectoryConstPtr>& sub_trajectories,
+            const moveit::core::RobotState& base_state, const moveit::core::JointModelGroup* merged_group) {
+	auto merged_traj = std::make_shared<robot_trajectory::RobotTrajectory>(base_state.getRobotModel(), merged_group);
+	std::vector<double> values;
+	auto merged_state = std::make_shared<moveit::core::RobotState>(base_state);
+	while (true) {
+		bool finished = true;
+		size_t index = merged_traj->getWayPointCount();
+		for (const auto& sub : sub_trajectories) {
+			if (index >= sub->getWayPointCount())
+				continue;
+			finished = false;
+			sub->getWayPoint(index).copyJointGroupPositions(sub->getGroup(), values);
+			merged_state->setJointGroupPositions(sub->getGroup(), values);
+		}
+		if (finished)
+			break;
+		merged_state->update();
+		merged_traj->addSuffixWayPoint(merged_state, 0.0);
+		merged_state = std::make_shared<moveit::core::RobotState>(*merged_state);
+	}
+	return merged_traj;
+}
+
+template <typename F>
+void measure(const char* label, const F& f) {
+	double sum = 0.0;
+	size_t allocations_before = allocations;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < ITERATIONS; ++i)
+		sum += f();
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << label << ": " << elapsed.count() / ITERATIONS << " us, "
+	          << static_cast<double>(allocations - allocations_before) / ITERATIONS
+	          << " allocations per trajectory (checksum " << sum << ")" << std::endl;
+}
+}  // namespace
+
+int main() {
+	auto robot_model = getModel();
+	moveit::core::RobotState base_state(robot_model);
+	base_state.setToDefaultValues();
+	base_state.update();
+
+	// two sub trajectories of different lengths for disjoint groups
+	std::vector<robot_trajectory::RobotTrajectoryConstPtr> sub_trajectories;
+	for (const char* group : { "group", "eef_group" }) {
+		const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(group);
+		auto sub = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, jmg);
+		moveit::core::RobotState state(base_state);
+		for (size_t i = 0; i < WAYPOINTS - 20 * sub_trajectories.size(); ++i) {
+			state.setToRandomPositions(jmg);
+			state.update();
+			sub->addSuffixWayPoint(state, 0.1);
+		}
+		sub_trajectories.push_back(sub);
+	}
+
+	NoTiming timing;
+	const moveit::core::JointModelGroup* merged_group = nullptr;
+	auto merged = merge(sub_trajectories, base_state, merged_group, timing);
+
+	measure("merge via RobotState", [&] {
+		return mergeStates(sub_trajectories, base_state, merged_group)->getWayPointCount();
+	});
+	measure("merge via TrajectoryMatrix", [&] {
+		return merge(sub_trajectories, base_state, merged_group, timing)->getWayPointCount();
+	});
+
+	measure("path length via RobotState", [&] {
+		double length = 0.0;
+		for (size_t i = 1; i < merged->getWayPointCount(); ++i)
+			length += merged->getWayPoint(i - 1).distance(merged->getWayPoint(i));
+		return length;
+	});
+	const auto weights = TrajectoryMatrix::distanceFactors(*robot_model);
+	measure("path length via TrajectoryMatrix", [&] { return TrajectoryMatrix(*merged).segmentLengths(weights).sum(); });
+
+	return 0;
+}
@@ -62,6 +62,12 @@ GeneratorMockup::GeneratorMockup(PredefinedCosts&& costs, std::size_t solutions_
   , costs_{ std::move(costs) }
   , solutions_per_compute_{ solutions_per_compute } {}
 
+Stage::pointer GeneratorMockup::cloneStage() const {
+	auto copy = std::make_unique<GeneratorMockup>(PredefinedCosts{ costs_ }, solutions_per_compute_);
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void GeneratorMockup::init(const moveit::core::RobotModelConstPtr& robot_model) {
 	ps_.reset(new planning_scene::PlanningScene(robot_model));
 	Generator::init(robot_model);
@@ -83,6 +89,12 @@ void GeneratorMockup::compute() {
 MonitoringGeneratorMockup::MonitoringGeneratorMockup(Stage* monitored, PredefinedCosts&& costs)
   : MonitoringGenerator{ "MON" + std::to_string(++id_), monitored }, costs_{ std::move(costs) } {}
 
+Stage::pointer MonitoringGeneratorMockup::cloneStage() const {
+	auto copy = std::make_unique<MonitoringGeneratorMockup>(nullptr, PredefinedCosts{ costs_ });
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void MonitoringGeneratorMockup::onNewSolution(const SolutionBase& s) {
 	++runs_;
 
@@ -92,6 +104,12 @@ void MonitoringGeneratorMockup::onNewSolution(const SolutionBase& s) {
 ConnectMockup::ConnectMockup(PredefinedCosts&& costs)
   : Connecting{ "CON" + std::to_string(++id_) }, costs_{ std::move(costs) } {}
 
+Stage::pointer ConnectMockup::cloneStage() const {
+	auto copy = std::make_unique<ConnectMockup>(PredefinedCosts{ costs_ });
+	copyConfigTo(*copy);
+	return copy;
+}
+
 void ConnectMockup::compute(const InterfaceState& from, const InterfaceState& to) {
 	++runs_;
 
@@ -130,6 +148,12 @@ ForwardMockup::ForwardMockup(PredefinedCosts&& costs, std::size_t solutions_per_
 	setName("FWD" + std::to_string(++id_));
 }
 
+Stage::pointer ForwardMockup::cloneStage() const {
+	auto copy = std::make_unique<ForwardMockup>(PredefinedCosts{ costs_ }, solutions_per_compute_);
+	copyConfigTo(*copy);
+	return copy;
+}
+
 BackwardMockup::BackwardMockup(PredefinedCosts&& costs, std::size_t solutions_per_compute)
   : PropagatorMockup{ std::move(costs), solutions_per_compute } {
 	restrictDirection(BACKWARD);
@@ -62,6 +62,7 @@ struct GeneratorMockup : public Generator
 	GeneratorMockup(std::initializer_list<double> costs, std::size_t solutions_per_compute = 1)
 	  : GeneratorMockup{ PredefinedCosts{ std::list<double>{ costs }, true }, solutions_per_compute } {}
 
+	Stage::pointer cloneStage() const override;
 	void init(const moveit::core::RobotModelConstPtr& robot_model) override;
 	bool canCompute() const override;
 	void compute() override;
@@ -79,6 +80,8 @@ struct MonitoringGeneratorMockup : public MonitoringGenerator
 	MonitoringGeneratorMockup(Stage* monitored, std::initializer_list<double> costs)
 	  : MonitoringGeneratorMockup{ monitored, PredefinedCosts{ std::list<double>{ costs }, true } } {}
 
+	Stage::pointer cloneStage() const override;
+
 	bool canCompute() const override { return false; }
 	void compute() override {}
 	void onNewSolution(const SolutionBase& s) override;
@@ -96,6 +99,8 @@ struct ConnectMockup : public Connecting
 	ConnectMockup(std::initializer_list<double> costs)
 	  : ConnectMockup{ PredefinedCosts{ std::list<double>{ costs }, true } } {}
 
+	Stage::pointer cloneStage() const override;
+
 	using Connecting::compatible;  // make this accessible for testing
 
 	void compute(const InterfaceState& from, const InterfaceState& to) override;
@@ -126,6 +131,8 @@ struct ForwardMockup : public PropagatorMockup
 	ForwardMockup(PredefinedCosts&& costs = PredefinedCosts::constant(0.0), std::size_t solutions_per_compute = 1);
 	ForwardMockup(std::initializer_list<double> costs)
 	  : ForwardMockup{ PredefinedCosts{ std::list<double>{ costs }, true } } {}
+
+	Stage::pointer cloneStage() const override;
 };
 
 struct BackwardMockup : public PropagatorMockup
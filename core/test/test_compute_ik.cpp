@@ -0,0 +1,226 @@
+#include "models.h"
+
+#include <moveit/task_constructor/task.h>
+#include <moveit/task_constructor/stages/compute_ik.h>
+#include <moveit/kinematics_base/kinematics_base.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/robot_model.h>
+#include <geometry_msgs/PoseStamped.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <set>
+
+using namespace moveit::task_constructor;
+
+// IK solver ignoring the target pose: a solution is the seed rounded to multiples of RESOLUTION
+class RoundingSolver : public kinematics::KinematicsBase
+{
+	std::vector<std::string> joints_;
+	std::vector<std::string> links_;
+
+	bool search(const std::vector<double>& seed, std::vector<double>& solution, const IKCallbackFn& callback,
+	            moveit_msgs::MoveItErrorCodes& error_code) const {
+		solution.resize(seed.size());
+		for (size_t i = 0; i < seed.size(); ++i)
+			solution[i] = std::round(seed[i] / RESOLUTION) * RESOLUTION;
+		error_code.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+		if (callback)
+			callback(geometry_msgs::Pose(), solution, error_code);
+		return error_code.val == moveit_msgs::MoveItErrorCodes::SUCCESS;
+	}
+
+public:
+	static constexpr double RESOLUTION = 0.5;
+	static std::atomic<unsigned int> instances;
+
+	RoundingSolver(const moveit::core::JointModelGroup* jmg)
+	  : joints_(jmg->getActiveJointModelNames()), links_(jmg->getLinkModelNames()) {
+		const moveit::core::RobotModel& robot_model = jmg->getParentModel();
+		storeValues(robot_model, jmg->getName(), robot_model.getModelFrame(), { links_.back() }, 0.1);
+		++instances;
+	}
+
+	bool getPositionIK(const geometry_msgs::Pose& /*ik_pose*/, const std::vector<double>& seed,
+	                   std::vector<double>& solution, moveit_msgs::MoveItErrorCodes& error_code,
+	                   const kinematics::KinematicsQueryOptions& /*options*/) const override {
+		return search(seed, solution, IKCallbackFn(), error_code);
+	}
+	bool searchPositionIK(const geometry_msgs::Pose& /*ik_pose*/, const std::vector<double>& seed, double /*timeout*/,
+	                      std::vector<double>& solution, moveit_msgs::MoveItErrorCodes& error_code,
+	                      const kinematics::KinematicsQueryOptions& /*options*/) const override {
+		return search(seed, solution, IKCallbackFn(), error_code);
+	}
+	bool searchPositionIK(const geometry_msgs::Pose& /*ik_pose*/, const std::vector<double>& seed, double /*timeout*/,
+	                      const std::vector<double>& /*consistency_limits*/, std::vector<double>& solution,
+	                      moveit_msgs::MoveItErrorCodes& error_code,
+	                      const kinematics::KinematicsQueryOptions& /*options*/) const override {
+		return search(seed, solution, IKCallbackFn(), error_code);
+	}
+	bool searchPositionIK(const geometry_msgs::Pose& /*ik_pose*/, const std::vector<double>& seed, double /*timeout*/,
+	                      std::vector<double>& solution, const IKCallbackFn& solution_callback,
+	                      moveit_msgs::MoveItErrorCodes& error_code,
+	                      const kinematics::KinematicsQueryOptions& /*options*/) const override {
+		return search(seed, solution, solution_callback, error_code);
+	}
+	bool searchPositionIK(const geometry_msgs::Pose& /*ik_pose*/, const std::vector<double>& seed, double /*timeout*/,
+	                      const std::vector<double>& /*consistency_limits*/, std::vector<double>& solution,
+	                      const IKCallbackFn& solution_callback, moveit_msgs::MoveItErrorCodes& error_code,
+	                      const kinematics::KinematicsQueryOptions& /*options*/) const override {
+		return search(seed, solution, solution_callback, error_code);
+	}
+
+	bool getPositionFK(const std::vector<std::string>& /*link_names*/, const std::vector<double>& /*joint_angles*/,
+	                   std::vector<geometry_msgs::Pose>& /*poses*/) const override {
+		return false;
+	}
+
+	const std::vector<std::string>& getJointNames() const override { return joints_; }
+	const std::vector<std::string>& getLinkNames() const override { return links_; }
+};
+std::atomic<unsigned int> RoundingSolver::instances{ 0 };
+
+// generator spawning IK targets at x, with the group's start positions as given
+struct TargetGenerator : public Generator
+{
+	struct Target
+	{
+		std::vector<double> positions;
+		double x;
+	};
+	std::deque<Target> targets;
+	std::size_t targets_per_compute = 1;
+	planning_scene::PlanningScenePtr scene;
+
+	TargetGenerator() : Generator("targets") {}
+
+	void init(const moveit::core::RobotModelConstPtr& robot_model) override {
+		Generator::init(robot_model);
+		scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	}
+	bool canCompute() const override { return !targets.empty(); }
+	void compute() override {
+		for (std::size_t i = 0; i < targets_per_compute && !targets.empty(); ++i) {
+			const Target& target = targets.front();
+			planning_scene::PlanningScenePtr target_scene = scene->diff();
+			target_scene->getCurrentStateNonConst().setJointGroupPositions("group", target.positions);
+			target_scene->getCurrentStateNonConst().update();
+
+			geometry_msgs::PoseStamped pose;
+			pose.header.frame_id = scene->getPlanningFrame();
+			pose.pose.position.x = target.x;
+			pose.pose.orientation.w = 1.0;
+
+			InterfaceState state(target_scene);
+			state.properties().set("target_pose", pose);
+			spawn(std::move(state), 0.0);
+			targets.pop_front();
+		}
+	}
+};
+
+struct ComputeIKTest : public testing::Test
+{
+	Task t;
+	stages::ComputeIK* ik;
+	TargetGenerator* generator;
+	// group positions and costs of spawned solutions, in spawning order
+	std::vector<std::vector<double>> solutions;
+	std::vector<double> costs;
+
+	ComputeIKTest() {
+		RoundingSolver::instances = 0;
+		moveit::core::RobotModelPtr robot_model = getModel();
+		robot_model->getJointModelGroup("group")->setSolverAllocators([](const moveit::core::JointModelGroup* jmg) {
+			return kinematics::KinematicsBasePtr(std::make_shared<RoundingSolver>(jmg));
+		});
+		t.setRobotModel(robot_model);
+
+		auto targets = std::make_unique<TargetGenerator>();
+		generator = targets.get();
+		auto stage = std::make_unique<stages::ComputeIK>("ik", std::move(targets));
+		ik = stage.get();
+		ik->setEndEffector("eef");
+		ik->properties().configureInitFrom(Stage::INTERFACE, { "target_pose" });
+		ik->addSolutionCallback([this](const SolutionBase& s) {
+			if (s.isFailure())
+				return;
+			solutions.emplace_back();
+			s.end()->scene()->getCurrentState().copyJointGroupPositions("group", solutions.back());
+			costs.push_back(s.cost());
+		});
+		t.add(std::move(stage));
+	}
+};
+
+using Positions = std::vector<std::vector<double>>;
+
+TEST_F(ComputeIKTest, parallelSolutions) {
+	generator->targets = { { { 0.0, 0.0 }, 0.5 } };
+	ik->setMaxIKSolutions(4);
+	ik->setNumThreads(3);
+
+	t.init();
+	t.compute();
+	EXPECT_EQ(solutions.size(), 4u);
+	// solutions found concurrently are spawned by their distance to the start state, i.e. their cost
+	EXPECT_TRUE(std::is_sorted(costs.begin(), costs.end()));
+	EXPECT_EQ(std::set<std::vector<double>>(solutions.begin(), solutions.end()).size(), 4u);
+	// the group's solver and three separate instances
+	EXPECT_EQ(RoundingSolver::instances.load(), 4u);
+}
+
+TEST_F(ComputeIKTest, keepSolversOnReset) {
+	ik->setMaxIKSolutions(2);
+	ik->setNumThreads(3);
+
+	generator->targets = { { { 0.0, 0.0 }, 0.5 } };
+	EXPECT_TRUE(t.plan());
+	EXPECT_EQ(RoundingSolver::instances.load(), 4u);
+
+	t.reset();
+	generator->targets = { { { 0.0, 0.0 }, 0.5 } };
+	EXPECT_TRUE(t.plan());
+	EXPECT_EQ(RoundingSolver::instances.load(), 4u);
+}
+
+TEST_F(ComputeIKTest, batch) {
+	generator->targets = { { { 0.0, 0.0 }, 0.5 }, { { 1.0, 1.0 }, 0.5 }, { { 2.0, 2.0 }, 0.5 } };
+	generator->targets_per_compute = 3;
+	ik->setBatchSize(2);
+	ik->setNumThreads(2);
+
+	t.init();
+	// a batch of targets is processed per compute(), spawning solutions in the order of targets
+	t.compute();
+	EXPECT_EQ(solutions, (Positions{ { 0.0, 0.0 }, { 1.0, 1.0 } }));
+	t.compute();
+	EXPECT_EQ(solutions, (Positions{ { 0.0, 0.0 }, { 1.0, 1.0 }, { 2.0, 2.0 } }));
+}
+
+TEST_F(ComputeIKTest, warmStart) {
+	// the second target is close to the first one, but starts from another state
+	generator->targets = { { { 1.0, 1.0 }, 0.5 }, { { 0.0, 0.0 }, 0.51 } };
+	generator->targets_per_compute = 2;
+	ik->setWarmStartSeeds(1);
+
+	t.init();
+	t.compute();
+	t.compute();
+	// the first target's solution was tried as seed first
+	EXPECT_EQ(solutions, (Positions{ { 1.0, 1.0 }, { 1.0, 1.0 } }));
+}
+
+TEST_F(ComputeIKTest, coldStart) {
+	generator->targets = { { { 1.0, 1.0 }, 0.5 }, { { 0.0, 0.0 }, 0.51 } };
+	generator->targets_per_compute = 2;
+
+	t.init();
+	t.compute();
+	t.compute();
+	// without warm start, the start state is used as seed
+	EXPECT_EQ(solutions, (Positions{ { 1.0, 1.0 }, { 0.0, 0.0 } }));
+}
@@ -3,13 +3,17 @@
 #include <moveit/task_constructor/task_p.h>
 #include <moveit/task_constructor/stages/fixed_state.h>
 #include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/utils/robot_model_test_utils.h>
 
 #include "stage_mockups.h"
 #include "models.h"
 #include "gtest_value_printers.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <initializer_list>
+#include <deque>
 #include <chrono>
 #include <thread>
 
@@ -717,3 +721,185 @@ TEST_F(TaskTestBase, preempt) {
 	EXPECT_EQ(fwd2->runs_, 0u);
 	EXPECT_TRUE(t.plan(1));  // make sure the preempt request has been resetted on the previous call to plan()
 }
+
+// GeneratorMockup counting its initializations
+struct InitCountingGeneratorMockup : public GeneratorMockup
+{
+	using GeneratorMockup::GeneratorMockup;
+	unsigned int inits_ = 0;
+	void init(const moveit::core::RobotModelConstPtr& robot_model) override {
+		++inits_;
+		GeneratorMockup::init(robot_model);
+	}
+};
+
+TEST_F(TaskTestBase, reinit) {
+	auto gen = add(t, new InitCountingGeneratorMockup(PredefinedCosts::constant(0.0)));
+	add(t, new ForwardMockup());
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(gen->inits_, 1u);
+
+	// reset() only clears the per-run state, keeping the initialized stage tree
+	t.reset();
+	EXPECT_EQ(t.numSolutions(), 0u);
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(gen->inits_, 1u);
+	EXPECT_EQ(t.numSolutions(), 1u);
+
+	// a modified configuration requires re-initialization
+	t.reset();
+	t.setTimeout(10.0);
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(gen->inits_, 2u);
+	EXPECT_EQ(t.numSolutions(), 1u);
+
+	// ... as does a modified stage tree
+	t.reset();
+	add(t, new ForwardMockup());
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(gen->inits_, 3u);
+	EXPECT_EQ(t.numSolutions(), 1u);
+}
+
+// one-shot generator, like CurrentState, which can compute again only after reset()
+struct OneShotGeneratorMockup : public InitCountingGeneratorMockup
+{
+	bool spawned_ = false;
+	bool canCompute() const override { return !spawned_; }
+	void compute() override {
+		spawned_ = true;
+		spawn(InterfaceState(ps_), 0.0);
+	}
+	void reset() override {
+		spawned_ = false;
+		InitCountingGeneratorMockup::reset();
+	}
+};
+
+TEST_F(TaskTestBase, reinitOneShot) {
+	auto gen = add(t, new OneShotGeneratorMockup());
+	add(t, new ForwardMockup());
+	for (int run = 0; run < 3; ++run) {
+		t.reset();
+		EXPECT_TRUE(t.plan());
+		EXPECT_EQ(t.numSolutions(), 1u);
+	}
+	EXPECT_EQ(gen->inits_, 1u);
+}
+
+// generator passing a different property value to the next stage in each run
+struct PropertyGeneratorMockup : public InitCountingGeneratorMockup
+{
+	using InitCountingGeneratorMockup::InitCountingGeneratorMockup;
+	int value_ = 0;
+	void compute() override {
+		++runs_;
+		InterfaceState state(ps_);
+		state.properties().set("value", ++value_);
+		spawn(std::move(state), costs_.cost());
+	}
+};
+
+// ForwardMockup also performing the stage's reset (of its properties)
+struct ResettingForwardMockup : public ForwardMockup
+{
+	void reset() override {
+		ForwardMockup::reset();
+		PropagatingEitherWay::reset();
+	}
+};
+
+TEST_F(TaskTestBase, reinitInterfaceProperties) {
+	auto gen = add(t, new PropertyGeneratorMockup(PredefinedCosts::constant(0.0)));
+	auto fwd = add(t, new ResettingForwardMockup());
+	fwd->properties().declare<int>("value").configureInitFrom(Stage::INTERFACE, "value");
+
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(fwd->properties().get<int>("value"), 1);
+
+	// values initialized from the interface don't change the configuration
+	t.reset();
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(gen->inits_, 1u);
+	EXPECT_EQ(fwd->properties().get<int>("value"), 2);
+}
+
+// Merger::mergeAnyCombination() with child solutions on three disjoint groups
+struct MergerTest : public testing::Test
+{
+	moveit::core::RobotModelPtr robot_model;
+	planning_scene::PlanningScenePtr scene;
+	Merger merger;
+	ForwardMockup a, b, c;  // children, only used as creators of solutions
+	std::deque<SubTrajectory> storage;
+	std::map<const Stage*, std::vector<const SubTrajectory*>> all_solutions;
+
+	MergerTest() {
+		resetMockupIds();
+		moveit::core::RobotModelBuilder builder("robot", "base");
+		builder.addChain("base->a->b->c", "continuous");
+		builder.addGroupChain("base", "a", "a");
+		builder.addGroupChain("a", "b", "b");
+		builder.addGroupChain("b", "c", "c");
+		robot_model = builder.build();
+		scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	}
+
+	// add solutions with given costs for a child, planning for the equally named group
+	void add(ForwardMockup& child, const std::string& group, std::initializer_list<double> costs) {
+		const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(group);
+		for (double cost : costs) {
+			auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, jmg);
+			moveit::core::RobotState state(scene->getCurrentState());
+			trajectory->addSuffixWayPoint(state, 0.0);
+			state.setJointGroupPositions(jmg, std::vector<double>(jmg->getVariableCount(), cost / 1000.));
+			trajectory->addSuffixWayPoint(state, 0.0);
+
+			storage.emplace_back(trajectory, cost);
+			storage.back().setCreator(&child);
+			all_solutions[&child].push_back(&storage.back());
+		}
+	}
+
+	// merge all combinations with the latest solution of current, returning the costs in spawning order
+	std::vector<double> merge(const Stage& current) {
+		std::vector<double> costs;
+		auto spawner = [&costs](SubTrajectory&& t) {
+			EXPECT_FALSE(t.isFailure()) << t.comment();
+			costs.push_back(t.cost());
+		};
+		merger.pimpl()->mergeAnyCombination(all_solutions, *all_solutions.at(&current).back(), scene, spawner);
+		return costs;
+	}
+};
+
+// all combination sums are unique: each combination needs to be merged exactly once
+TEST_F(MergerTest, costOrder) {
+	add(a, "a", { 4, 1, 2 });
+	add(b, "b", { 20, 10, 40 });
+	add(c, "c", { 200, 100 });  // only the latest solution (100) is combined with the others
+
+	EXPECT_EQ(merge(c), (std::vector<double>{ 111, 112, 114, 121, 122, 124, 141, 142, 144 }));
+}
+
+TEST_F(MergerTest, maxMerges) {
+	add(a, "a", { 4, 1, 2 });
+	add(b, "b", { 20, 10, 40 });
+	add(c, "c", { 100 });
+
+	merger.setProperty("max_merges", 4u);
+	EXPECT_EQ(merge(c), (std::vector<double>{ 111, 112, 114, 121 }));
+}
+
+TEST_F(MergerTest, parallel) {
+	add(a, "a", { 4, 1, 2, 8 });
+	add(b, "b", { 20, 10, 40 });
+	add(c, "c", { 100 });
+
+	const std::vector<double> sequential = merge(c);
+	EXPECT_EQ(sequential.size(), 12u);
+	EXPECT_TRUE(std::is_sorted(sequential.begin(), sequential.end()));
+
+	merger.setProperty("num_threads", 4u);
+	EXPECT_EQ(merge(c), sequential);
+}
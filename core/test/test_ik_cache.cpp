@@ -0,0 +1,76 @@
+#include "models.h"
+
+#include <moveit/task_constructor/ik_cache.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/robot_model.h>
+#include <geometric_shapes/shapes.h>
+
+#include <gtest/gtest.h>
+
+using namespace moveit::task_constructor;
+
+struct IKCacheTest : public testing::Test
+{
+	moveit::core::RobotModelPtr robot_model = getModel();
+	planning_scene::PlanningScenePtr scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup("group");
+	const moveit::core::LinkModel* link = robot_model->getLinkModel("link2");
+	Eigen::Isometry3d pose = Eigen::Translation3d(0.1, 0.2, 0.3) * Eigen::AngleAxisd(0.5, Eigen::Vector3d::UnitZ());
+};
+
+TEST_F(IKCacheTest, key) {
+	IKCache cache(0.01, 0.01);
+	auto key = cache.key(*scene, jmg, link, pose);
+
+	// small deviations map onto the same key
+	EXPECT_EQ(key, cache.key(*scene, jmg, link, Eigen::Translation3d(0.001, 0, 0) * pose));
+	EXPECT_FALSE(key == cache.key(*scene, jmg, link, Eigen::Translation3d(0.1, 0, 0) * pose));
+	EXPECT_FALSE(key == cache.key(*scene, jmg, link, pose * Eigen::AngleAxisd(0.5, Eigen::Vector3d::UnitX())));
+	EXPECT_FALSE(key == cache.key(*scene, jmg, robot_model->getLinkModel("tip"), pose));
+	// a precomputed fingerprint yields the same key
+	EXPECT_EQ(key, cache.key(IKCache::sceneFingerprint(*scene, jmg), jmg, link, pose));
+
+	// scene changes: collision objects, allowed collisions, and joints outside the group
+	auto diff = scene->diff();
+	diff->getWorldNonConst()->addToObject("box", std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+	                                      Eigen::Isometry3d::Identity());
+	EXPECT_FALSE(key == cache.key(*diff, jmg, link, pose));
+
+	diff = scene->diff();
+	diff->getAllowedCollisionMatrixNonConst().setEntry("link1", "tip", true);
+	EXPECT_FALSE(key == cache.key(*diff, jmg, link, pose));
+
+	diff = scene->diff();
+	diff->getCurrentStateNonConst().setVariablePosition(robot_model->getVariableCount() - 1, 1.0);
+	EXPECT_FALSE(key == cache.key(*diff, jmg, link, pose));
+
+	// joints of the group are ignored
+	diff = scene->diff();
+	diff->getCurrentStateNonConst().setJointGroupPositions(jmg, std::vector<double>(jmg->getVariableCount(), 1.0));
+	EXPECT_EQ(key, cache.key(*diff, jmg, link, pose));
+}
+
+TEST_F(IKCacheTest, lookup) {
+	IKCache cache(0.01, 0.01, 2);
+	auto key = cache.key(*scene, jmg, link, pose);
+	EXPECT_TRUE(cache.lookup(key).empty());
+
+	cache.insert(key, { { 1.0, 2.0 } });
+	ASSERT_EQ(cache.lookup(key), IKCache::Solutions({ { 1.0, 2.0 } }));
+
+	// the least recently used entry is dropped
+	auto key2 = cache.key(*scene, jmg, link, Eigen::Translation3d(1, 0, 0) * pose);
+	auto key3 = cache.key(*scene, jmg, link, Eigen::Translation3d(2, 0, 0) * pose);
+	cache.insert(key2, { { 2.0, 3.0 } });
+	cache.lookup(key);
+	cache.insert(key3, { { 3.0, 4.0 } });
+	EXPECT_EQ(cache.size(), 2u);
+	EXPECT_FALSE(cache.lookup(key).empty());
+	EXPECT_TRUE(cache.lookup(key2).empty());
+	EXPECT_FALSE(cache.lookup(key3).empty());
+
+	cache.clear();
+	EXPECT_EQ(cache.size(), 0u);
+	EXPECT_TRUE(cache.lookup(key).empty());
+}
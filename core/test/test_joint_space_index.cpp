@@ -0,0 +1,86 @@
+#include "models.h"
+
+#include <moveit/task_constructor/joint_space_index.h>
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace moveit::task_constructor;
+
+// compare index queries against brute-force search
+void compareWithBruteForce(const moveit::core::JointModelGroup* jmg, double radius) {
+	JointSpaceIndex index(jmg);
+	std::vector<std::vector<double>> configurations;
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<double> uniform(-M_PI, M_PI);
+
+	for (size_t n = 0; n < 500; ++n) {
+		std::vector<double> q(jmg->getVariableCount());
+		for (double& value : q)
+			value = uniform(rng);
+
+		double best_distance = std::numeric_limits<double>::infinity();
+		size_t best = configurations.size();
+		std::vector<double> distances;
+		for (size_t i = 0; i < configurations.size(); ++i) {
+			double d = jmg->distance(q.data(), configurations[i].data());
+			distances.push_back(d);
+			if (d < best_distance) {
+				best_distance = d;
+				best = i;
+			}
+		}
+		std::sort(distances.begin(), distances.end());
+
+		auto k_nearest = index.nearestK(q, 5);
+		ASSERT_EQ(k_nearest.size(), std::min<size_t>(5, configurations.size()));
+		for (size_t i = 0; i < k_nearest.size(); ++i) {
+			EXPECT_EQ(k_nearest[i].first, distances[i]);
+			EXPECT_EQ(jmg->distance(q.data(), configurations[k_nearest[i].second].data()), distances[i]);
+		}
+
+		double distance;
+		EXPECT_EQ(index.nearest(q, &distance), best);
+		EXPECT_EQ(distance, best_distance);
+		EXPECT_EQ(index.withinDistance(q, radius), best_distance < radius);
+
+		configurations.push_back(q);
+		EXPECT_EQ(index.insert(q), n);
+	}
+	EXPECT_EQ(index.size(), configurations.size());
+	EXPECT_EQ(std::vector<double>(index[7], index[7] + jmg->getVariableCount()), configurations[7]);
+}
+
+TEST(JointSpaceIndex, continuous) {
+	auto robot_model = getModel();
+	compareWithBruteForce(robot_model->getJointModelGroup("group"), 0.5);
+}
+
+TEST(JointSpaceIndex, revolute) {
+	moveit::core::RobotModelBuilder builder("robot", "base");
+	builder.addChain("base->a->b->c->d->e->f->tip", "revolute");
+	builder.addGroupChain("base", "tip", "arm");
+	auto robot_model = builder.build();
+	compareWithBruteForce(robot_model->getJointModelGroup("arm"), 3.0);
+}
+
+TEST(JointSpaceIndex, empty) {
+	auto robot_model = getModel();
+	JointSpaceIndex index(robot_model->getJointModelGroup("group"));
+	std::vector<double> q(2, 0.0);
+	EXPECT_FALSE(index.withinDistance(q, 1.0));
+	EXPECT_EQ(index.nearest(q), 0u);
+	EXPECT_TRUE(index.nearestK(q, 3).empty());
+
+	index.insert(q);
+	EXPECT_TRUE(index.withinDistance(q, 1e-6));
+	EXPECT_FALSE(index.withinDistance(q, 0.0));
+	index.clear();
+	EXPECT_TRUE(index.empty());
+}
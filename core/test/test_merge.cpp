@@ -0,0 +1,39 @@
+#include "models.h"
+
+#include <moveit/task_constructor/merge.h>
+#include <moveit/robot_model/robot_model.h>
+
+#include <gtest/gtest.h>
+
+using namespace moveit::task_constructor;
+
+TEST(MergedGroup, shared) {
+	auto robot_model = getModel();
+	const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("group");
+	const moveit::core::JointModelGroup* eef_group = robot_model->getJointModelGroup("eef_group");
+
+	auto merged = mergedGroup(robot_model, { group, eef_group });
+	ASSERT_TRUE(merged);
+	EXPECT_EQ(merged->getName(), "eef_group+group");
+	EXPECT_EQ(merged->getVariableCount(), group->getVariableCount() + eef_group->getVariableCount());
+
+	// the same instance is returned independently of the groups' order
+	EXPECT_EQ(mergedGroup(robot_model, { eef_group, group }), merged);
+
+	// other robot models have their own merged groups
+	auto other_model = getModel();
+	auto other = mergedGroup(other_model, { other_model->getJointModelGroup("group"),
+	                                        other_model->getJointModelGroup("eef_group") });
+	EXPECT_NE(other, merged);
+	EXPECT_EQ(&other->getParentModel(), other_model.get());
+
+	EXPECT_THROW(mergedGroup(other_model, { group, eef_group }), std::runtime_error);
+}
+
+TEST(MergedGroup, overlapping) {
+	auto robot_model = getModel();
+	const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("group");
+	EXPECT_THROW(mergedGroup(robot_model, { group, group }), std::runtime_error);
+	// failures are not cached
+	EXPECT_THROW(mergedGroup(robot_model, { group, group }), std::runtime_error);
+}
@@ -0,0 +1,129 @@
+#include "models.h"
+
+#include <moveit/task_constructor/solvers/pipeline_planner.h>
+#include <moveit/task_constructor/cost_terms.h>
+#include <moveit/task_constructor/storage.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+using namespace moveit::task_constructor;
+using namespace moveit::task_constructor::solvers;
+
+using IntPool = InstancePool<int>;
+
+// pool of ints, counting the instances created by its factory
+struct InstancePoolTest : public testing::Test
+{
+	std::atomic<unsigned int> created{ 0 };
+	bool fail = false;  // let the factory throw
+
+	std::shared_ptr<IntPool> pool(size_t max_size) {
+		return std::make_shared<IntPool>(
+		    [this] {
+			    if (fail)
+				    throw std::runtime_error("factory failed");
+			    return std::make_shared<int>(++created);
+		    },
+		    max_size);
+	}
+};
+
+TEST_F(InstancePoolTest, checkoutCheckin) {
+	auto p = pool(2);
+	auto a = p->checkout();
+	auto b = p->checkout();
+	EXPECT_NE(a, b);
+	EXPECT_EQ(p->size(), 2u);
+
+	// a released instance is reused
+	int* instance = a.get();
+	a.reset();
+	auto c = p->checkout();
+	EXPECT_EQ(c.get(), instance);
+	EXPECT_EQ(created.load(), 2u);
+	EXPECT_EQ(p->size(), 2u);
+}
+
+TEST_F(InstancePoolTest, blockAtMaxSize) {
+	auto p = pool(1);
+	auto a = p->checkout();
+	int* instance = a.get();
+
+	std::atomic<int*> waiting{ nullptr };
+	std::thread thread([&] { waiting = p->checkout().get(); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_EQ(waiting.load(), nullptr) << "checkout() should block while all instances are in use";
+
+	a.reset();
+	thread.join();
+	EXPECT_EQ(waiting.load(), instance);
+	EXPECT_EQ(created.load(), 1u);
+}
+
+TEST_F(InstancePoolTest, reserve) {
+	auto p = pool(1);
+	auto a = p->checkout();
+	p->reserve(2);
+	EXPECT_EQ(p->maxSize(), 2u);
+	auto b = p->checkout();  // doesn't block
+	EXPECT_NE(a, b);
+	EXPECT_EQ(created.load(), 2u);
+
+	// a pool of a single, given instance cannot grow
+	auto single = std::make_shared<IntPool>(std::make_shared<int>(0));
+	single->reserve(2);
+	EXPECT_EQ(single->maxSize(), 1u);
+	EXPECT_EQ(single->size(), 1u);
+}
+
+TEST_F(InstancePoolTest, factoryFailure) {
+	auto p = pool(1);
+	fail = true;
+	EXPECT_THROW(p->checkout(), std::runtime_error);
+	EXPECT_EQ(p->size(), 0u);
+
+	// the slot of the failed instance is available again
+	fail = false;
+	auto a = p->checkout();
+	EXPECT_EQ(*a, 1);
+	EXPECT_EQ(p->size(), 1u);
+}
+
+TEST(PipelinePlanner, planCheapest) {
+	auto robot_model = getModel();
+	// attempt i yields a trajectory with waypoints[i] waypoints or fails for 0
+	const std::vector<size_t> waypoints{ 0, 4, 2, 3, 2 };
+	std::atomic<size_t> attempts{ 0 };
+	auto attempt = [&](size_t i, robot_trajectory::RobotTrajectoryPtr& trajectory) {
+		++attempts;
+		if (waypoints[i] == 0)
+			return false;
+		trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, "group");
+		moveit::core::RobotState state(robot_model);
+		state.setToDefaultValues();
+		for (size_t w = 0; w < waypoints[i]; ++w)
+			trajectory->addSuffixWayPoint(state, 0.0);
+		return true;
+	};
+	cost::LambdaCostTerm cost_term(
+	    [](const SubTrajectory& s) { return static_cast<double>(s.trajectory()->getWayPointCount()); });
+
+	robot_trajectory::RobotTrajectoryPtr result;
+	std::optional<size_t> best = planCheapest(waypoints.size(), attempt, cost_term, result);
+	EXPECT_EQ(attempts.load(), waypoints.size());
+	ASSERT_TRUE(best);
+	EXPECT_EQ(*best, 2u);  // first of the cheapest attempts
+	ASSERT_TRUE(result);
+	EXPECT_EQ(result->getWayPointCount(), 2u);
+
+	// all attempts failing
+	auto failing = [](size_t /*i*/, robot_trajectory::RobotTrajectoryPtr& /*trajectory*/) { return false; };
+	EXPECT_FALSE(planCheapest(3, failing, cost_term, result));
+}
@@ -1,4 +1,5 @@
 #include <moveit/task_constructor/properties.h>
+#include <geometry_msgs/PoseStamped.h>
 
 #include <gtest/gtest.h>
 #include <initializer_list>
@@ -107,6 +108,159 @@ TEST(Property, serialize) {
 	EXPECT_EQ(props.property("map").serialize(), "");
 }
 
+TEST(Property, copyOnWrite) {
+	PropertyMap props;
+	props.set("int", 1);
+	props.set("string", std::string("foo"));
+
+	PropertyMap copy(props);
+	const PropertyMap& const_copy = copy;
+	const PropertyMap& const_props = props;
+	// copies share their properties until modification
+	EXPECT_EQ(&const_copy.property("int"), &const_props.property("int"));
+
+	copy.set("int", 2);
+	EXPECT_EQ(copy.get<int>("int"), 2);
+	EXPECT_EQ(props.get<int>("int"), 1);
+	EXPECT_EQ(copy.get<std::string>("string"), "foo");
+	EXPECT_NE(&const_copy.property("string"), &const_props.property("string"));
+
+	// once references escaped, copies are deep
+	Property& p = props.property("int");
+	PropertyMap deep(props);
+	p.setValue(3);
+	EXPECT_EQ(props.get<int>("int"), 3);
+	EXPECT_EQ(deep.get<int>("int"), 1);
+}
+
+TEST(Property, handle) {
+	PropertyMap props;
+	props.declare<double>("double", 1.0);
+	props.declare<int>("int");
+	props.declare<boost::any>("any");
+
+	auto d = props.handle<double>("double");
+	EXPECT_EQ(d.name(), "double");
+	EXPECT_EQ(d.get(), 1.0);
+	// handles observe value changes
+	props.set("double", 2.0);
+	EXPECT_EQ(d.get(), 2.0);
+
+	auto i = props.handle<int>("int");
+	EXPECT_THROW(i.get(), Property::undefined);
+	EXPECT_EQ(i.get(42), 42);
+
+	auto a = props.handle<int>("any");
+	props.set("any", std::string("foo"));
+	EXPECT_THROW(a.get(), boost::bad_any_cast);
+	props.set("any", 3);
+	EXPECT_EQ(a.get(), 3);
+	EXPECT_EQ(boost::any_cast<int>(props.handle<boost::any>("any").get()), 3);
+
+	EXPECT_THROW(props.handle<double>("unknown"), Property::undeclared);
+	EXPECT_THROW(props.handle<int>("double"), Property::type_error);
+}
+
+TEST(Property, handleAssignment) {
+	PropertyMap props;
+	props.declare<double>("double", 1.0);
+	PropertyMap other;
+	other.declare<double>("double", 2.0);
+
+	{
+		auto d = props.handle<double>("double");
+		// replacing the properties would invalidate the handle
+		EXPECT_THROW(props = other, Property::error);
+		EXPECT_THROW(props = PropertyMap(other), Property::error);
+		EXPECT_EQ(d.get(), 1.0);
+
+		// moving the map keeps the handle valid
+		PropertyMap moved;
+		moved = std::move(props);
+		moved.set("double", 3.0);
+		EXPECT_EQ(d.get(), 3.0);
+		EXPECT_THROW(moved = other, Property::error);
+	}
+	// without outstanding handles, assignment is fine
+	props = other;
+	EXPECT_EQ(props.get<double>("double"), 2.0);
+}
+
+TEST(Property, version) {
+	PropertyMap props;
+	props.declare<double>("double1");
+	props.declare<double>("double2");
+	const Property& p1 = props.property("double1");
+	const Property& p2 = props.property("double2");
+	EXPECT_NE(p1.version(), p2.version());
+
+	auto v1 = p1.version();
+	props.setCurrent("double1", 1.0);
+	EXPECT_NE(p1.version(), v1);
+	v1 = p1.version();
+	props.reset();
+	EXPECT_NE(p1.version(), v1);
+
+	// resetting an undefined property doesn't change it
+	auto v2 = p2.version();
+	props.reset();
+	EXPECT_EQ(p2.version(), v2);
+
+	// assigning an equal value doesn't change the version either
+	props.setCurrent("double1", 1.0);
+	v1 = p1.version();
+	props.setCurrent("double1", 1.0);
+	EXPECT_EQ(p1.version(), v1);
+	props.property("double1").setDefaultValue(2.0);  // hidden by current value
+	EXPECT_EQ(p1.version(), v1);
+	props.setCurrent("double1", 2.0);
+	EXPECT_NE(p1.version(), v1);
+	v1 = p1.version();
+	props.reset();  // restores default, which is equal to the current value
+	EXPECT_EQ(p1.version(), v1);
+
+	// messages are compared by value too
+	geometry_msgs::PoseStamped pose;
+	props.declare<geometry_msgs::PoseStamped>("pose");
+	props.setCurrent("pose", pose);
+	const auto v3 = props.property("pose").version();
+	props.setCurrent("pose", pose);
+	EXPECT_EQ(props.property("pose").version(), v3);
+	pose.pose.position.x = 1.0;
+	props.setCurrent("pose", pose);
+	EXPECT_NE(props.property("pose").version(), v3);
+}
+
+TEST(Property, cache) {
+	PropertyMap props;
+	props.declare<double>("double", 1.0);
+	const Property& p = props.property("double");
+	int other = 0;
+
+	PropertyCache<double> cache;
+	int computed = 0;
+	auto compute = [&]() {
+		++computed;
+		return 2 * props.get<double>("double");
+	};
+	EXPECT_EQ(cache.get({ p, &other }, compute), 2.0);
+	EXPECT_EQ(cache.get({ p, &other }, compute), 2.0);
+	EXPECT_EQ(computed, 1);
+
+	props.set("double", 2.0);
+	EXPECT_EQ(cache.get({ p, &other }, compute), 4.0);
+	EXPECT_EQ(computed, 2);
+
+	// other dependencies are compared by identity
+	int another = 0;
+	EXPECT_EQ(cache.get({ p, &another }, compute), 4.0);
+	EXPECT_EQ(computed, 3);
+
+	cache.reset();
+	EXPECT_EQ(cache.get({ p, &another }, compute), 4.0);
+	EXPECT_EQ(computed, 4);
+}
+
 class InitFromTest : public ::testing::Test
 {
 protected:
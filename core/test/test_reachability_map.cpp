@@ -0,0 +1,65 @@
+#include "models.h"
+
+#include <moveit/task_constructor/reachability_map.h>
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+
+#include <gtest/gtest.h>
+#include <cstdio>
+
+using namespace moveit::task_constructor;
+
+TEST(ReachabilityMap, build) {
+	auto robot_model = getModel();
+	auto map = ReachabilityMap::build(robot_model, "group", "link2", 0.05, 10000);
+	EXPECT_EQ(map->group(), "group");
+	EXPECT_EQ(map->link(), "link2");
+	EXPECT_GT(map->occupancy(), 0.0);
+
+	// poses reached by forward kinematics are reachable
+	moveit::core::RobotState state(robot_model);
+	state.setToDefaultValues();
+	const auto* jmg = robot_model->getJointModelGroup("group");
+	for (size_t i = 0; i < 100; ++i) {
+		state.setToRandomPositions(jmg);
+		state.update();
+		EXPECT_TRUE(map->reachable(state, state.getGlobalLinkTransform("link2")));
+	}
+
+	// poses far away are not
+	Eigen::Isometry3d far = state.getGlobalLinkTransform("link2");
+	far.translation() += Eigen::Vector3d(100, 0, 0);
+	EXPECT_FALSE(map->reachable(state, far));
+
+	EXPECT_THROW(ReachabilityMap::build(robot_model, "unknown", "link2", 0.05, 10), std::runtime_error);
+	EXPECT_THROW(ReachabilityMap::build(robot_model, "group", "unknown", 0.05, 10), std::runtime_error);
+}
+
+TEST(ReachabilityMap, saveLoad) {
+	auto robot_model = getModel();
+	auto map = ReachabilityMap::build(robot_model, "group", "link2", 0.05, 10000);
+
+	const std::string file = testing::TempDir() + "reachability_map.bin";
+	map->save(file);
+	auto loaded = ReachabilityMap::load(file);
+	EXPECT_EQ(loaded->group(), map->group());
+	EXPECT_EQ(loaded->link(), map->link());
+	EXPECT_EQ(loaded->baseLink(), map->baseLink());
+	EXPECT_EQ(loaded->size(), map->size());
+	EXPECT_EQ(loaded->samples(), map->samples());
+	EXPECT_EQ(loaded->occupancy(), map->occupancy());
+
+	moveit::core::RobotState state(robot_model);
+	state.setToDefaultValues();
+	for (size_t i = 0; i < 100; ++i) {
+		state.setToRandomPositions();
+		state.update();
+		Eigen::Isometry3d pose = state.getGlobalLinkTransform("link2");
+		pose.translation() += Eigen::Vector3d::Random() * 0.5;
+		EXPECT_EQ(loaded->reachable(state, pose), map->reachable(state, pose));
+	}
+	std::remove(file.c_str());
+
+	EXPECT_THROW(ReachabilityMap::load(file), std::runtime_error);
+}
@@ -0,0 +1,137 @@
+#include <moveit/task_constructor/solvers/roadmap_planner.h>
+#include <moveit/task_constructor/trajectory_validation.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+
+using namespace moveit::task_constructor;
+
+// single link rotating about the x-axis, carrying a sphere at distance 0.5
+moveit::core::RobotModelPtr sphereModel() {
+	geometry_msgs::Pose origin;
+	origin.orientation.w = 1.0;
+
+	moveit::core::RobotModelBuilder builder("robot", "base");
+	builder.addChain("base->a", "continuous", { origin });
+	geometry_msgs::Pose sphere = origin;
+	sphere.position.y = 0.5;
+	builder.addCollisionSphere("a", 0.1, sphere);
+	builder.addGroupChain("base", "a", "arm");
+	return builder.build();
+}
+
+struct RoadmapPlannerTest : public testing::Test
+{
+	moveit::core::RobotModelPtr robot_model = sphereModel();
+	planning_scene::PlanningScenePtr scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup("arm");
+	solvers::RoadmapPlanner planner;
+
+	RoadmapPlannerTest() {
+		planner.init(robot_model);
+		planner.setTimeParameterization(nullptr);
+		planner.setTimeout(5.0);
+	}
+
+	void addBall(double angle) {
+		scene->getWorldNonConst()->addToObject(
+		    "ball_" + std::to_string(angle), std::make_shared<shapes::Sphere>(0.1),
+		    Eigen::Isometry3d(Eigen::Translation3d(0.0, 0.5 * std::cos(angle), 0.5 * std::sin(angle))));
+	}
+	planning_scene::PlanningScenePtr at(double angle) {
+		auto result = scene->diff();
+		result->getCurrentStateNonConst().setVariablePosition(0, angle);
+		result->getCurrentStateNonConst().update();
+		return result;
+	}
+	solvers::PlannerInterface::Result plan(double from, double to, robot_trajectory::RobotTrajectoryPtr& trajectory) {
+		return planner.plan(at(from), at(to), jmg, 5.0, trajectory);
+	}
+};
+
+TEST_F(RoadmapPlannerTest, avoidsObstacle) {
+	addBall(M_PI / 2);  // blocks the direct connection from 0 to 2.5
+	robot_trajectory::RobotTrajectoryPtr trajectory;
+	ASSERT_TRUE(plan(0.0, 2.5, trajectory));
+
+	ASSERT_GE(trajectory->getWayPointCount(), 2u);
+	EXPECT_DOUBLE_EQ(trajectory->getFirstWayPoint().getVariablePosition(0), 0.0);
+	EXPECT_DOUBLE_EQ(trajectory->getLastWayPoint().getVariablePosition(0), 2.5);
+	EXPECT_TRUE(isPathValid(*scene, *trajectory));
+	for (std::size_t i = 1; i < trajectory->getWayPointCount(); ++i)
+		EXPECT_LE(trajectory->getWayPoint(i - 1).distance(trajectory->getWayPoint(i)), 0.1 + 1e-9);
+}
+
+TEST_F(RoadmapPlannerTest, reusesRoadmap) {
+	robot_trajectory::RobotTrajectoryPtr trajectory;
+	ASSERT_TRUE(plan(0.0, 1.0, trajectory));
+	ASSERT_TRUE(plan(1.0, -1.0, trajectory));
+	EXPECT_EQ(planner.numRoadmaps(), 1u);
+
+	addBall(M_PI / 2);  // changes the scene fingerprint
+	ASSERT_TRUE(plan(0.0, 2.5, trajectory));
+	EXPECT_EQ(planner.numRoadmaps(), 2u);
+}
+
+TEST_F(RoadmapPlannerTest, evictsLeastRecentlyUsed) {
+	planner.setMaxRoadmaps(2);
+	robot_trajectory::RobotTrajectoryPtr trajectory;
+	ASSERT_TRUE(plan(0.0, 1.0, trajectory));  // 2 nodes
+	const auto empty_scene = at(0.0);
+
+	addBall(M_PI / 2);
+	ASSERT_TRUE(plan(0.0, -1.0, trajectory));  // 2 nodes
+	ASSERT_TRUE(planner.plan(empty_scene, at(-1.0), jmg, 5.0, trajectory));  // 3rd node of the first roadmap
+	addBall(-M_PI / 2);
+	ASSERT_TRUE(plan(0.0, 1.0, trajectory));  // 2 nodes
+
+	// the roadmap of the single ball was dropped, not the older, but more recently used first one
+	EXPECT_EQ(planner.numRoadmaps(), 2u);
+	EXPECT_EQ(planner.numNodes(), 5u);
+}
+
+TEST_F(RoadmapPlannerTest, resizedObstacle) {
+	// a small ball beside the direct connection from 0 to 2.5
+	const Eigen::Isometry3d pose(Eigen::Translation3d(0.0, 0.0, 0.75));
+	scene->getWorldNonConst()->addToObject("ball", std::make_shared<shapes::Sphere>(0.05), pose);
+	robot_trajectory::RobotTrajectoryPtr trajectory;
+	ASSERT_TRUE(plan(0.0, 2.5, trajectory));
+	EXPECT_TRUE(isPathValid(*scene, *trajectory));
+
+	// growing the ball blocks the direct connection, which must not be reused
+	scene->getWorldNonConst()->removeObject("ball");
+	scene->getWorldNonConst()->addToObject("ball", std::make_shared<shapes::Sphere>(0.3), pose);
+	ASSERT_TRUE(plan(0.0, 2.5, trajectory));
+	EXPECT_TRUE(isPathValid(*scene, *trajectory));
+	EXPECT_EQ(planner.numRoadmaps(), 2u);
+}
+
+TEST_F(RoadmapPlannerTest, invalidEndpoints) {
+	addBall(M_PI / 2);
+	robot_trajectory::RobotTrajectoryPtr trajectory;
+	EXPECT_FALSE(plan(M_PI / 2, 0.0, trajectory));
+	EXPECT_FALSE(plan(0.0, M_PI / 2, trajectory));
+}
+
+TEST_F(RoadmapPlannerTest, saveAndLoad) {
+	addBall(M_PI / 2);
+	robot_trajectory::RobotTrajectoryPtr trajectory;
+	ASSERT_TRUE(plan(0.0, 2.5, trajectory));
+
+	const std::string file = testing::TempDir() + "roadmaps.bin";
+	planner.save(file);
+
+	solvers::RoadmapPlanner loaded;
+	loaded.load(file, robot_model);
+	EXPECT_EQ(loaded.numRoadmaps(), planner.numRoadmaps());
+	EXPECT_EQ(loaded.numNodes(), planner.numNodes());
+	std::remove(file.c_str());
+
+	EXPECT_THROW(loaded.load(file, robot_model), std::runtime_error);
+}
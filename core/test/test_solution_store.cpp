@@ -0,0 +1,195 @@
+#include "models.h"
+#include "stage_mockups.h"
+
+#include <moveit/task_constructor/solution_store.h>
+#include <moveit/task_constructor/container.h>
+#include <moveit/task_constructor/stages/modify_planning_scene.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <geometric_shapes/shapes.h>
+
+#include <gtest/gtest.h>
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace moveit::task_constructor;
+
+// forward stage producing a trajectory starting at the current state, thus depending on the start state
+struct MoveMockup : public ForwardMockup
+{
+	void reset() override {
+		ForwardMockup::reset();
+		PropagatingEitherWay::reset();  // mockups don't reset their stage
+	}
+	void computeForward(const InterfaceState& from) override {
+		++runs_;
+		auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(from.scene()->getRobotModel(), nullptr);
+		trajectory->addSuffixWayPoint(from.scene()->getCurrentState(), 0.0);
+		sendForward(from, InterfaceState{ from.scene()->diff() }, SubTrajectory{ trajectory, 1.0 });
+	}
+};
+
+struct SolutionStoreTest : public testing::Test
+{
+	const std::string directory = testing::TempDir() + "solution_store";
+	SolutionStorePtr store;
+
+	SolutionStoreTest() {
+		clear();
+		store = std::make_shared<SolutionStore>(directory, 2);
+	}
+	~SolutionStoreTest() override { clear(); }
+
+	void clear() {
+		if (DIR* dir = ::opendir(directory.c_str())) {
+			while (const dirent* entry = ::readdir(dir))
+				::unlink((directory + "/" + entry->d_name).c_str());
+			::closedir(dir);
+		}
+		::rmdir(directory.c_str());
+	}
+
+	static moveit_task_constructor_msgs::Solution solution(double cost) {
+		moveit_task_constructor_msgs::Solution msg;
+		msg.sub_trajectory.emplace_back();
+		msg.sub_trajectory.back().info.cost = cost;
+		return msg;
+	}
+
+	// generator followed by a forward propagator, both producing empty trajectories
+	static void build(Task& t, GeneratorMockup*& generator) {
+		resetMockupIds();
+		t.setRobotModel(getModel());
+		generator = new GeneratorMockup({ 1.0 });
+		t.add(Stage::pointer(generator));
+		t.add(Stage::pointer(new ForwardMockup({ 2.0 })));
+	}
+};
+
+TEST_F(SolutionStoreTest, roundtrip) {
+	EXPECT_TRUE(store->load(42).empty());
+	EXPECT_EQ(store->misses(), 1u);
+
+	store->store(42, { solution(1.0), solution(2.0), solution(3.0) });
+	auto loaded = store->load(42);
+	ASSERT_EQ(loaded.size(), 2u);  // limited to max_solutions
+	EXPECT_EQ(loaded[0].sub_trajectory.front().info.cost, 1.0);
+	EXPECT_EQ(loaded[1].sub_trajectory.front().info.cost, 2.0);
+	EXPECT_EQ(store->hits(), 1u);
+
+	// persistent across instances
+	SolutionStore other(directory, 2);
+	EXPECT_EQ(other.load(42).size(), 2u);
+
+	store->erase(42);
+	EXPECT_TRUE(store->load(42).empty());
+	store->store(7, {});
+	EXPECT_TRUE(store->load(7).empty());
+}
+
+TEST_F(SolutionStoreTest, fingerprint) {
+	Task a, b;
+	GeneratorMockup* generator;
+	build(a, generator);
+	build(b, generator);
+	EXPECT_EQ(a.fingerprint(), b.fingerprint());
+
+	b[1]->setTimeout(1.0);
+	EXPECT_NE(a.fingerprint(), b.fingerprint());
+}
+
+TEST_F(SolutionStoreTest, memoize) {
+	auto scene = std::make_shared<planning_scene::PlanningScene>(getModel());
+	GeneratorMockup* generator;
+
+	Task t;
+	build(t, generator);
+	t.setSolutionStore(store);
+	EXPECT_TRUE(t.plan(scene));
+	EXPECT_EQ(generator->runs_, 1u);
+	ASSERT_EQ(t.numSolutions(), 1u);
+	EXPECT_EQ(t.solutions().front()->cost(), 3.0);
+
+	// an identical task restores the solution without planning
+	Task restored;
+	build(restored, generator);
+	restored.setSolutionStore(store);
+	EXPECT_TRUE(restored.plan(scene));
+	EXPECT_EQ(generator->runs_, 0u);
+	ASSERT_EQ(restored.numSolutions(), 1u);
+	EXPECT_EQ(restored.solutions().front()->cost(), 3.0);
+
+	// a modified task needs to plan again
+	Task modified;
+	build(modified, generator);
+	modified[1]->setTimeout(1.0);
+	modified.setSolutionStore(store);
+	EXPECT_TRUE(modified.plan(scene));
+	EXPECT_EQ(generator->runs_, 1u);
+}
+
+TEST_F(SolutionStoreTest, replan) {
+	Task t;
+	resetMockupIds();
+	t.setRobotModel(getModel());
+	auto* generator = new GeneratorMockup(PredefinedCosts::constant(0.0));
+	auto* move = new MoveMockup();
+	t.add(Stage::pointer(generator));
+	t.add(Stage::pointer(move));
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(move->runs_, 1u);
+	EXPECT_EQ(t.numSolutions(), 1u);
+
+	// the generator is substituted by the new start scene, the unchanged move is replayed
+	auto scene = std::make_shared<planning_scene::PlanningScene>(getModel());
+	for (int i = 0; i < 2; ++i) {
+		EXPECT_TRUE(t.replan(scene, 1));
+		EXPECT_EQ(generator->runs_, 0u);
+		EXPECT_EQ(move->runs_, 0u);
+		ASSERT_EQ(t.numSolutions(), 1u);
+		EXPECT_EQ(t.solutions().front()->start()->scene(), scene);
+	}
+
+	// a different start state requires to compute the move again
+	auto moved = scene->diff();
+	moved->getCurrentStateNonConst().setVariablePositions(std::vector<double>(getModel()->getVariableCount(), 0.5));
+	EXPECT_TRUE(t.replan(moved, 1));
+	EXPECT_EQ(move->runs_, 1u);
+	EXPECT_EQ(t.numSolutions(), 1u);
+
+	// after replanning, the generator computes as usual again
+	t.reset();
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(generator->runs_, 1u);
+}
+
+TEST_F(SolutionStoreTest, replanAttachesMovedObject) {
+	auto scene_with_box = [](double x) {
+		auto scene = std::make_shared<planning_scene::PlanningScene>(getModel());
+		scene->getWorldNonConst()->addToObject("box", std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+		                                       Eigen::Isometry3d(Eigen::Translation3d(x, 0.0, 0.0)));
+		return scene;
+	};
+	auto attached_x = [](const Task& t) {
+		const auto* body = t.solutions().front()->end()->scene()->getCurrentState().getAttachedBody("box");
+		return body ? body->getGlobalCollisionBodyTransforms().front().translation().x() : 0.0;
+	};
+
+	Task t;
+	resetMockupIds();
+	t.setRobotModel(getModel());
+	t.add(Stage::pointer(new GeneratorMockup(PredefinedCosts::constant(0.0))));
+	auto attach = std::make_unique<stages::ModifyPlanningScene>("attach");
+	attach->attachObject("box", "tip");
+	t.add(std::move(attach));
+
+	EXPECT_TRUE(t.replan(scene_with_box(1.0), 1));
+	ASSERT_EQ(t.numSolutions(), 1u);
+	EXPECT_DOUBLE_EQ(attached_x(t), 1.0);
+
+	// the attached object was moved: its previous attachment must not be replayed
+	EXPECT_TRUE(t.replan(scene_with_box(2.0), 1));
+	ASSERT_EQ(t.numSolutions(), 1u);
+	EXPECT_DOUBLE_EQ(attached_x(t), 2.0);
+}
@@ -0,0 +1,121 @@
+#include <moveit/task_constructor/sphere_collision_filter.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+
+#include <gtest/gtest.h>
+
+using namespace moveit::task_constructor;
+
+// two-link arm with spheres: link "a" rotates about the x-axis, carrying a sphere at distance 0.5
+moveit::core::RobotModelPtr sphereModel() {
+	geometry_msgs::Pose origin;
+	origin.orientation.w = 1.0;
+	geometry_msgs::Pose offset = origin;
+	offset.position.x = 1.0;
+
+	moveit::core::RobotModelBuilder builder("robot", "base");
+	builder.addChain("base->a", "continuous", { offset });
+	builder.addCollisionSphere("base", 0.1, origin);
+	geometry_msgs::Pose sphere = origin;
+	sphere.position.y = 0.5;
+	builder.addCollisionSphere("a", 0.1, sphere);
+	builder.addGroupChain("base", "a", "arm");
+	return builder.build();
+}
+
+struct SphereCollisionFilterTest : public testing::Test
+{
+	moveit::core::RobotModelPtr robot_model = sphereModel();
+	planning_scene::PlanningScenePtr scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup("arm");
+
+	void addObject(const std::string& name, const shapes::ShapeConstPtr& shape, const Eigen::Vector3d& position) {
+		scene->getWorldNonConst()->addToObject(name, shape, Eigen::Isometry3d(Eigen::Translation3d(position)));
+	}
+	moveit::core::RobotState state(double angle) {
+		moveit::core::RobotState state(scene->getCurrentState());
+		state.setJointGroupPositions(jmg, &angle);
+		state.update();
+		return state;
+	}
+};
+
+TEST_F(SphereCollisionFilterTest, exactSpheres) {
+	addObject("ball", std::make_shared<shapes::Sphere>(0.1), Eigen::Vector3d(1.0, 0.5, 0.0));
+	SphereCollisionFilter filter(scene, jmg);
+	EXPECT_EQ(filter.numRobotSpheres(), 2u);
+	EXPECT_EQ(filter.numWorldSpheres(), 1u);
+
+	EXPECT_EQ(filter.check(state(0.0)), SphereCollisionFilter::COLLIDING);
+	EXPECT_EQ(filter.check(state(M_PI)), SphereCollisionFilter::FREE);
+}
+
+TEST_F(SphereCollisionFilterTest, boxes) {
+	addObject("box", std::make_shared<shapes::Box>(0.1, 0.1, 0.1), Eigen::Vector3d(1.0, 0.5, 0.0));
+	SphereCollisionFilter filter(scene, jmg);
+
+	// overlap of box's bounding sphere cannot be decided
+	EXPECT_EQ(filter.check(state(0.0)), SphereCollisionFilter::UNKNOWN);
+	EXPECT_EQ(filter.check(state(M_PI)), SphereCollisionFilter::FREE);
+	EXPECT_TRUE(filter.isStateColliding(state(0.0)));
+	EXPECT_FALSE(filter.isStateColliding(state(M_PI)));
+}
+
+TEST_F(SphereCollisionFilterTest, allowedCollisions) {
+	addObject("ball", std::make_shared<shapes::Sphere>(0.1), Eigen::Vector3d(1.0, 0.5, 0.0));
+	scene->getAllowedCollisionMatrixNonConst().setEntry("ball", "a", true);
+	SphereCollisionFilter filter(scene, jmg);
+	EXPECT_EQ(filter.check(state(0.0)), SphereCollisionFilter::FREE);
+}
+
+TEST_F(SphereCollisionFilterTest, consistency) {
+	addObject("ball", std::make_shared<shapes::Sphere>(0.2), Eigen::Vector3d(1.0, 0.0, 0.4));
+	addObject("box", std::make_shared<shapes::Box>(0.2, 0.1, 0.3), Eigen::Vector3d(1.0, -0.4, -0.1));
+	SphereCollisionFilter filter(scene, jmg);
+
+	// the filter never contradicts the full collision check
+	for (double angle = -M_PI; angle < M_PI; angle += 0.01) {
+		auto s = state(angle);
+		bool colliding = scene->isStateColliding(s, jmg->getName());
+		switch (filter.check(s)) {
+			case SphereCollisionFilter::FREE:
+				EXPECT_FALSE(colliding) << angle;
+				break;
+			case SphereCollisionFilter::COLLIDING:
+				EXPECT_TRUE(colliding) << angle;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+TEST(SphereCollisionFilter, paddedBox) {
+	// link "a" carrying a box at distance 0.5
+	geometry_msgs::Pose origin;
+	origin.orientation.w = 1.0;
+	geometry_msgs::Pose offset = origin;
+	offset.position.x = 1.0;
+	moveit::core::RobotModelBuilder builder("robot", "base");
+	builder.addChain("base->a", "continuous", { offset });
+	geometry_msgs::Pose box = origin;
+	box.position.y = 0.5;
+	builder.addCollisionBox("a", { 0.2, 0.2, 0.2 }, box);
+	builder.addGroupChain("base", "a", "arm");
+	moveit::core::RobotModelPtr robot_model = builder.build();
+
+	auto scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	scene->getCollisionEnvNonConst()->setLinkPadding("a", 0.1);
+	// small ball close to a corner of the padded box: inside the padded box, but not within radius + padding
+	scene->getWorldNonConst()->addToObject("ball", std::make_shared<shapes::Sphere>(0.01),
+	                                       Eigen::Isometry3d(Eigen::Translation3d(1.18, 0.68, 0.18)));
+	moveit::core::RobotState state(scene->getCurrentState());
+	state.update();
+	ASSERT_TRUE(scene->isStateColliding(state, "arm"));
+
+	SphereCollisionFilter filter(scene, robot_model->getJointModelGroup("arm"));
+	EXPECT_NE(filter.check(state), SphereCollisionFilter::FREE);
+	EXPECT_TRUE(filter.isStateColliding(state));
+}
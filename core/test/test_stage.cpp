@@ -2,14 +2,22 @@
 
 #include <moveit/task_constructor/stage_p.h>
 #include <moveit/task_constructor/stages/compute_ik.h>
+#include <moveit/task_constructor/stages/connect.h>
+#include <moveit/task_constructor/stages/fixed_state.h>
 #include <moveit/task_constructor/stages/modify_planning_scene.h>
 #include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
 #include <geometry_msgs/PoseStamped.h>
 
 #include "stage_mockups.h"
 #include <ros/console.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
 using namespace moveit::task_constructor;
 using namespace planning_scene;
 
@@ -156,3 +164,130 @@ TEST(Connect, compatible) {
 	attachObject(*other, "object", "tip", true);
 	EXPECT_FALSE(connect.compatible(scene, other)) << "different pose";
 }
+
+// planner moving a group straight to its goal, if the start state fulfills an optional precondition
+struct DirectPlanner : public solvers::PlannerInterface
+{
+	std::function<bool(const moveit::core::RobotState&)> precondition;
+	bool thread_safe = false;
+	std::atomic<unsigned int> calls{ 0 };
+	std::atomic<unsigned int> active{ 0 };
+	std::atomic<bool> concurrent{ false };  // was the planner ever called concurrently?
+	std::atomic<double> last_timeout{ 0.0 };
+
+	void init(const moveit::core::RobotModelConstPtr& /*robot_model*/) override {}
+	bool isThreadSafe() const override { return thread_safe; }
+
+	Result plan(const PlanningSceneConstPtr& from, const PlanningSceneConstPtr& to,
+	            const moveit::core::JointModelGroup* jmg, double timeout,
+	            robot_trajectory::RobotTrajectoryPtr& result,
+	            const moveit_msgs::Constraints& /*path_constraints*/) override {
+		++calls;
+		last_timeout = timeout;
+		if (++active > 1)
+			concurrent = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));  // provoke overlapping calls
+
+		Result r{ true, std::string() };
+		if (precondition && !precondition(from->getCurrentState()))
+			r = { false, "precondition failed" };
+		else {
+			result = std::make_shared<robot_trajectory::RobotTrajectory>(from->getRobotModel(), jmg);
+			result->addSuffixWayPoint(from->getCurrentState(), 0.0);
+			result->addSuffixWayPoint(to->getCurrentState(), 0.1);
+		}
+		--active;
+		return r;
+	}
+
+	Result plan(const PlanningSceneConstPtr& /*from*/, const moveit::core::LinkModel& /*link*/,
+	            const Eigen::Isometry3d& /*offset*/, const Eigen::Isometry3d& /*target*/,
+	            const moveit::core::JointModelGroup* /*jmg*/, double /*timeout*/,
+	            robot_trajectory::RobotTrajectoryPtr& /*result*/,
+	            const moveit_msgs::Constraints& /*path_constraints*/) override {
+		return { false, "not implemented" };
+	}
+};
+
+// connect two states differing in the disjoint groups "group" and "eef_group"
+struct ParallelConnect : public testing::Test
+{
+	Task t;
+	PlanningScenePtr start;
+	PlanningScenePtr goal;
+
+	ParallelConnect() {
+		t.setRobotModel(getModel());
+		start = std::make_shared<PlanningScene>(t.getRobotModel());
+		start->getCurrentStateNonConst().setToDefaultValues();
+		goal = start->diff();
+		auto& state = goal->getCurrentStateNonConst();
+		for (const char* group : { "group", "eef_group" }) {
+			const moveit::core::JointModelGroup* jmg = state.getJointModelGroup(group);
+			state.setJointGroupPositions(jmg, std::vector<double>(jmg->getVariableCount(), 0.5));
+		}
+		state.update();
+	}
+
+	void add(const stages::Connect::GroupPlannerVector& planners) {
+		t.add(std::make_unique<stages::FixedState>("start", start));
+		auto connect = std::make_unique<stages::Connect>("connect", planners);
+		connect->setParallelPlanning(true);
+		t.add(std::move(connect));
+		t.add(std::make_unique<stages::FixedState>("goal", goal));
+	}
+};
+
+TEST_F(ParallelConnect, success) {
+	auto arm = std::make_shared<DirectPlanner>();
+	auto eef = std::make_shared<DirectPlanner>();
+	add({ { "group", arm }, { "eef_group", eef } });
+
+	EXPECT_TRUE(t.plan());
+	ASSERT_EQ(t.solutions().size(), 1u);
+	EXPECT_FALSE(t.solutions().front()->isFailure());
+	// each group was planned once only, i.e. no sequential planning
+	EXPECT_EQ(arm->calls, 1u);
+	EXPECT_EQ(eef->calls, 1u);
+}
+
+TEST_F(ParallelConnect, fallback) {
+	auto arm = std::make_shared<DirectPlanner>();
+	auto eef = std::make_shared<DirectPlanner>();
+	// the eef can only move after the arm reached its goal, which fails from the common start state
+	eef->precondition = [this](const moveit::core::RobotState& state) {
+		const auto* jmg = state.getJointModelGroup("group");
+		return state.distance(goal->getCurrentState(), jmg) < 1e-6;
+	};
+	add({ { "group", arm }, { "eef_group", eef } });
+
+	EXPECT_TRUE(t.plan());
+	ASSERT_EQ(t.solutions().size(), 1u);
+	EXPECT_FALSE(t.solutions().front()->isFailure());
+	// parallel planning failed, sequential planning succeeded
+	EXPECT_EQ(arm->calls, 2u);
+	EXPECT_EQ(eef->calls, 2u);
+	// within the time remaining from parallel planning
+	EXPECT_LT(eef->last_timeout, 1.0);
+}
+
+TEST_F(ParallelConnect, sharedPlanner) {
+	auto planner = std::make_shared<DirectPlanner>();
+	add({ { "group", planner }, { "eef_group", planner } });
+
+	EXPECT_TRUE(t.plan());
+	ASSERT_EQ(t.solutions().size(), 1u);
+	EXPECT_EQ(planner->calls, 2u);
+	EXPECT_FALSE(planner->concurrent) << "shared planner was called concurrently";
+}
+
+TEST_F(ParallelConnect, sharedThreadSafePlanner) {
+	auto planner = std::make_shared<DirectPlanner>();
+	planner->thread_safe = true;
+	add({ { "group", planner }, { "eef_group", planner } });
+
+	EXPECT_TRUE(t.plan());
+	ASSERT_EQ(t.solutions().size(), 1u);
+	EXPECT_EQ(planner->calls, 2u);
+	EXPECT_TRUE(planner->concurrent) << "thread-safe planner wasn't called concurrently";
+}
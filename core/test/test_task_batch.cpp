@@ -0,0 +1,116 @@
+#include "models.h"
+#include "stage_mockups.h"
+
+#include <moveit/task_constructor/task_batch.h>
+#include <moveit/task_constructor/stage_p.h>
+#include <moveit/task_constructor/stages/fixed_state.h>
+#include <moveit/task_constructor/stages/generate_grasp_pose.h>
+#include <moveit/task_constructor/stages/pick.h>
+#include <moveit/task_constructor/stages/simple_grasp.h>
+#include <moveit/task_constructor/solvers/cartesian_path.h>
+
+#include <gtest/gtest.h>
+
+using namespace moveit::task_constructor;
+
+namespace {
+// fixed state, connected to a generator monitoring the fixed state
+void build(Task& t) {
+	resetMockupIds();
+	t.setRobotModel(getModel());
+	auto fixed = new stages::FixedState("fixed", std::make_shared<planning_scene::PlanningScene>(getModel()));
+	t.add(Stage::pointer(fixed));
+	t.add(std::make_unique<ConnectMockup>());
+	t.add(std::make_unique<MonitoringGeneratorMockup>(fixed));
+}
+}  // namespace
+
+TEST(Task, clone) {
+	Task t;
+	build(t);
+	t[1]->setTimeout(42.0);
+
+	Task copy = t.clone();
+	ASSERT_EQ(copy.stages()->numChildren(), 3u);
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_NE(copy[i], t[i]);
+		EXPECT_EQ(copy[i]->name(), t[i]->name());
+	}
+	EXPECT_EQ(copy[1]->timeout(), 42.0);
+	EXPECT_EQ(copy.fingerprint(), t.fingerprint());
+
+	// the copied generator monitors the copied fixed state
+	auto* monitoring = dynamic_cast<MonitoringGenerator*>(copy[2]);
+	ASSERT_TRUE(monitoring);
+	EXPECT_EQ(monitoring->pimpl()->monitored_, copy[0]);
+
+	EXPECT_TRUE(copy.plan(1));
+	EXPECT_EQ(copy.numSolutions(), 1u);
+	EXPECT_EQ(t.numSolutions(), 0u);
+	EXPECT_TRUE(t.plan(1));
+	EXPECT_EQ(t.numSolutions(), 1u);
+}
+
+TEST(Task, clonePick) {
+	auto grasp = std::make_unique<stages::SimpleGrasp>(std::make_unique<stages::GenerateGraspPose>("generator"));
+	grasp->setMaxIKSolutions(3);
+	stages::Pick pick(std::move(grasp));
+	pick.setObject("object");
+	geometry_msgs::TwistStamped motion;
+	motion.twist.linear.z = 1.0;
+	pick.setApproachMotion(motion, 0.05, 0.1);
+	pick.cartesianSolver()->setStepSize(0.005);
+
+	auto copy = pick.cloneStage();
+	auto* copied = dynamic_cast<stages::Pick*>(copy.get());
+	ASSERT_TRUE(copied);
+	ASSERT_EQ(copied->numChildren(), pick.numChildren());
+	for (int i = 0; i < static_cast<int>(pick.numChildren()); ++i) {
+		EXPECT_NE((*copied)[i], pick[i]);
+		EXPECT_EQ((*copied)[i]->name(), pick[i]->name());
+	}
+	EXPECT_EQ(copied->properties().get<std::string>("object"), "object");
+	EXPECT_EQ((*copied)[0]->properties().get<double>("min_distance"), 0.05);
+	EXPECT_EQ(copied->cartesianSolver()->properties().get<double>("step_size"), 0.005);
+	EXPECT_NE(copied->cartesianSolver(), pick.cartesianSolver());
+
+	// the grasp stage is cloned including its generator
+	auto* copied_grasp = dynamic_cast<stages::SimpleGrasp*>((*copied)[1]);
+	ASSERT_TRUE(copied_grasp);
+	ASSERT_EQ(copied_grasp->numChildren(), static_cast<ContainerBase*>(pick[1])->numChildren());
+	EXPECT_EQ(copied_grasp->properties().get<uint32_t>("max_ik_solutions"), 3u);
+	auto* ik = dynamic_cast<WrapperBase*>((*copied_grasp)[0]);
+	ASSERT_TRUE(ik && ik->wrapped());
+	EXPECT_EQ(ik->wrapped()->name(), "generator");
+}
+
+TEST(TaskBatch, plan) {
+	Task t;
+	build(t);
+	TaskBatch batch(4);
+	for (int i = 0; i < 8; ++i)
+		EXPECT_EQ(batch.add(t.clone()), static_cast<std::size_t>(i));
+
+	for (int run = 0; run < 2; ++run) {  // planning again reuses the initialized tasks
+		auto results = batch.plan(1);
+		ASSERT_EQ(results.size(), batch.size());
+		for (std::size_t i = 0; i < batch.size(); ++i) {
+			EXPECT_TRUE(results[i]);
+			EXPECT_EQ(batch[i].numSolutions(), 1u);
+		}
+	}
+}
+
+TEST(TaskBatch, preempt) {
+	Task t;
+	build(t);
+	TaskBatch batch(1);
+	batch.add(t.clone());
+	batch.add(t.clone());
+	// preempt the batch from the first task's solution callback
+	batch[0].addTaskCallback([&batch](const Task& /*t*/) { batch.preempt(); });
+
+	auto results = batch.plan();
+	EXPECT_EQ(results[1].val, moveit::core::MoveItErrorCode::PREEMPTED);
+	EXPECT_EQ(batch[1].numSolutions(), 0u);
+}
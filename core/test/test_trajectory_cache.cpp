@@ -0,0 +1,149 @@
+#include "models.h"
+
+#include <moveit/task_constructor/trajectory_cache.h>
+#include <moveit/task_constructor/solvers/cached_planner.h>
+#include <moveit/task_constructor/solvers/joint_interpolation.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <geometric_shapes/shapes.h>
+
+#include <gtest/gtest.h>
+#include <cstdio>
+
+using namespace moveit::task_constructor;
+
+struct TrajectoryCacheTest : public testing::Test
+{
+	moveit::core::RobotModelPtr robot_model = getModel();
+	planning_scene::PlanningScenePtr scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup("group");
+	const std::string file = testing::TempDir() + "trajectory_cache.bin";
+
+	TrajectoryCacheTest() { std::remove(file.c_str()); }
+	~TrajectoryCacheTest() override { std::remove(file.c_str()); }
+
+	planning_scene::PlanningScenePtr at(double position) {
+		auto result = scene->diff();
+		const std::vector<double> positions(jmg->getVariableCount(), position);
+		result->getCurrentStateNonConst().setJointGroupPositions(jmg, positions);
+		result->getCurrentStateNonConst().update();
+		return result;
+	}
+	robot_trajectory::RobotTrajectory trajectory(double from, double to, std::size_t n) {
+		robot_trajectory::RobotTrajectory result(robot_model, jmg);
+		moveit::core::RobotState state(scene->getCurrentState());
+		for (std::size_t i = 0; i < n; ++i) {
+			const double position = from + (to - from) * i / (n - 1);
+			state.setJointGroupPositions(jmg, std::vector<double>(jmg->getVariableCount(), position));
+			state.update();
+			result.addSuffixWayPoint(state, i == 0 ? 0.0 : 0.5);
+		}
+		return result;
+	}
+};
+
+TEST_F(TrajectoryCacheTest, key) {
+	TrajectoryCache cache(file, 1 << 20, 0.01);
+	moveit_msgs::Constraints none;
+	auto key = cache.key(*at(0.0), *at(1.0), jmg, none);
+
+	// small deviations map onto the same key
+	EXPECT_EQ(key, cache.key(*at(0.001), *at(1.001), jmg, none));
+	EXPECT_NE(key, cache.key(*at(0.1), *at(1.0), jmg, none));
+	EXPECT_NE(key, cache.key(*at(0.0), *at(1.1), jmg, none));
+
+	moveit_msgs::Constraints constraints;
+	constraints.name = "upright";
+	EXPECT_NE(key, cache.key(*at(0.0), *at(1.0), jmg, constraints));
+	EXPECT_NE(key, cache.key(*at(0.0), *at(1.0), jmg, none, "0.5 1"));
+
+	auto from = at(0.0);
+	from->getWorldNonConst()->addToObject("box", std::make_shared<shapes::Box>(0.1, 0.1, 0.1),
+	                                      Eigen::Isometry3d::Identity());
+	EXPECT_NE(key, cache.key(*from, *at(1.0), jmg, none));
+
+	const moveit::core::LinkModel& link = *robot_model->getLinkModel("link2");
+	auto pose_key = cache.key(*at(0.0), link, Eigen::Isometry3d(Eigen::Translation3d(0.1, 0.2, 0.3)), jmg, none);
+	EXPECT_NE(key, pose_key);
+	EXPECT_EQ(pose_key,
+	          cache.key(*at(0.0), link, Eigen::Isometry3d(Eigen::Translation3d(0.101, 0.2, 0.3)), jmg, none));
+}
+
+TEST_F(TrajectoryCacheTest, persistence) {
+	auto key = TrajectoryCache(file).key(*at(0.0), *at(1.0), jmg, moveit_msgs::Constraints());
+	{
+		TrajectoryCache cache(file);
+		robot_trajectory::RobotTrajectory restored(robot_model, jmg);
+		EXPECT_FALSE(cache.lookup(key, scene->getCurrentState(), jmg, restored));
+		cache.insert(key, trajectory(0.0, 1.0, 5));
+		EXPECT_EQ(cache.statistics().misses, 1u);
+		EXPECT_EQ(cache.statistics().inserted, 1u);
+	}
+
+	TrajectoryCache cache(file);
+	EXPECT_EQ(cache.statistics().entries, 1u);
+	robot_trajectory::RobotTrajectory restored(robot_model, jmg);
+	ASSERT_TRUE(cache.lookup(key, scene->getCurrentState(), jmg, restored));
+	ASSERT_EQ(restored.getWayPointCount(), 5u);
+	EXPECT_DOUBLE_EQ(restored.getWayPointDurationFromPrevious(2), 0.5);
+	std::vector<double> positions;
+	restored.getWayPoint(2).copyJointGroupPositions(jmg, positions);
+	EXPECT_EQ(positions, std::vector<double>(jmg->getVariableCount(), 0.5));
+
+	// invalidation persists as well
+	cache.invalidate(key);
+	EXPECT_EQ(cache.statistics().rejected, 1u);
+	EXPECT_FALSE(cache.lookup(key, scene->getCurrentState(), jmg, restored));
+	EXPECT_EQ(TrajectoryCache(file).statistics().entries, 0u);
+}
+
+TEST_F(TrajectoryCacheTest, capacity) {
+	TrajectoryCache cache(file, 1024);
+	std::vector<TrajectoryCache::Key> keys;
+	for (int i = 0; i < 10; ++i) {
+		keys.push_back(cache.key(*at(0.0), *at(0.1 * i), jmg, moveit_msgs::Constraints()));
+		cache.insert(keys.back(), trajectory(0.0, 0.1 * i, 5));
+	}
+	auto statistics = cache.statistics();
+	EXPECT_EQ(statistics.inserted, 10u);
+	EXPECT_GT(statistics.evicted, 0u);
+	EXPECT_EQ(statistics.entries, statistics.inserted - statistics.evicted);
+	EXPECT_LE(statistics.size, statistics.capacity);
+
+	// the oldest entries were evicted
+	robot_trajectory::RobotTrajectory restored(robot_model, jmg);
+	EXPECT_FALSE(cache.lookup(keys.front(), scene->getCurrentState(), jmg, restored));
+	EXPECT_TRUE(cache.lookup(keys.back(), scene->getCurrentState(), jmg, restored));
+	EXPECT_EQ(TrajectoryCache(file, 1024).statistics().entries, statistics.entries);
+
+	// a trajectory exceeding the capacity on its own is dropped
+	cache.insert(keys.front(), trajectory(0.0, 1.0, 100));
+	EXPECT_EQ(cache.statistics().dropped, 1u);
+	EXPECT_EQ(cache.statistics().entries, statistics.entries);
+}
+
+TEST_F(TrajectoryCacheTest, cachedPlanner) {
+	auto interpolation = std::make_shared<solvers::JointInterpolationPlanner>();
+	interpolation->setTimeParameterization(nullptr);
+	auto cache = std::make_shared<TrajectoryCache>(file);
+	solvers::CachedPlanner planner(interpolation, cache);
+	planner.init(robot_model);
+
+	robot_trajectory::RobotTrajectoryPtr first, second;
+	ASSERT_TRUE(planner.plan(at(0.0), at(1.0), jmg, 1.0, first));
+	auto result = planner.plan(at(0.0), at(1.0), jmg, 1.0, second);
+	ASSERT_TRUE(result);
+	EXPECT_EQ(result.message, "cached");
+	EXPECT_EQ(second->getWayPointCount(), first->getWayPointCount());
+	EXPECT_EQ(cache->statistics().hits, 1u);
+	EXPECT_EQ(cache->statistics().inserted, 1u);
+
+	// trajectories planned with other velocity scaling are not reused
+	interpolation->setProperty("max_velocity_scaling_factor", 0.5);
+	result = planner.plan(at(0.0), at(1.0), jmg, 1.0, second);
+	ASSERT_TRUE(result);
+	EXPECT_NE(result.message, "cached");
+	EXPECT_EQ(cache->statistics().inserted, 2u);
+}
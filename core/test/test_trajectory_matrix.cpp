@@ -0,0 +1,112 @@
+#include "models.h"
+
+#include <moveit/task_constructor/merge.h>
+#include <moveit/task_constructor/trajectory_matrix.h>
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/trajectory_processing/time_parameterization.h>
+
+#include <gtest/gtest.h>
+
+using namespace moveit::task_constructor;
+
+struct NoTiming : public trajectory_processing::TimeParameterization
+{
+	bool computeTimeStamps(robot_trajectory::RobotTrajectory& /*trajectory*/, double /*max_velocity_scaling_factor*/,
+	                       double /*max_acceleration_scaling_factor*/) const override {
+		return true;
+	}
+};
+
+struct TrajectoryMatrixTest : public testing::Test
+{
+	moveit::core::RobotModelPtr robot_model = getModel();
+	const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("group");
+	const moveit::core::JointModelGroup* eef_group = robot_model->getJointModelGroup("eef_group");
+
+	moveit::core::RobotState randomState() {
+		moveit::core::RobotState state(robot_model);
+		state.setToRandomPositions();
+		state.update();
+		return state;
+	}
+	robot_trajectory::RobotTrajectoryPtr randomTrajectory(const moveit::core::JointModelGroup* jmg, size_t waypoints) {
+		auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, jmg);
+		for (size_t i = 0; i < waypoints; ++i)
+			trajectory->addSuffixWayPoint(randomState(), 0.1);
+		return trajectory;
+	}
+};
+
+TEST_F(TrajectoryMatrixTest, roundTrip) {
+	auto trajectory = randomTrajectory(group, 10);
+	TrajectoryMatrix positions(*trajectory);
+	ASSERT_EQ(positions.waypoints(), 10u);
+	ASSERT_EQ(positions.variables(), robot_model->getVariableCount());
+
+	auto converted = positions.toRobotTrajectory(trajectory->getWayPoint(0), group);
+	ASSERT_EQ(converted->getWayPointCount(), trajectory->getWayPointCount());
+	for (size_t i = 0; i < trajectory->getWayPointCount(); ++i)
+		EXPECT_DOUBLE_EQ(converted->getWayPoint(i).distance(trajectory->getWayPoint(i)), 0.0);
+}
+
+TEST_F(TrajectoryMatrixTest, interpolate) {
+	for (size_t trial = 0; trial < 10; ++trial) {
+		const auto from = randomState();
+		const auto to = randomState();
+		std::vector<double> fractions;
+		for (double t = 0.0; t <= 1.0; t += 0.1)  // NOLINT(clang-analyzer-security.FloatLoopCounter)
+			fractions.push_back(t);
+
+		auto positions = TrajectoryMatrix::interpolate(from, to, fractions);
+		ASSERT_EQ(positions.waypoints(), fractions.size());
+		moveit::core::RobotState expected(from);
+		for (size_t i = 0; i < fractions.size(); ++i) {
+			from.interpolate(to, fractions[i], expected);
+			for (size_t v = 0; v < positions.variables(); ++v)
+				EXPECT_NEAR(positions.waypoint(i)[v], expected.getVariablePosition(v), 1e-12);
+		}
+	}
+}
+
+TEST_F(TrajectoryMatrixTest, distances) {
+	auto trajectory = randomTrajectory(group, 20);
+	TrajectoryMatrix positions(*trajectory);
+	const auto weights = TrajectoryMatrix::distanceFactors(*robot_model);
+
+	auto lengths = positions.segmentLengths(weights);
+	ASSERT_EQ(lengths.size(), 19);
+	for (size_t i = 1; i < trajectory->getWayPointCount(); ++i)
+		EXPECT_NEAR(lengths[i - 1], trajectory->getWayPoint(i - 1).distance(trajectory->getWayPoint(i)), 1e-12);
+
+	const auto reference = randomState();
+	auto distances = positions.distances(reference.getVariablePositions(), weights);
+	for (size_t i = 0; i < trajectory->getWayPointCount(); ++i)
+		EXPECT_NEAR(distances[i], reference.distance(trajectory->getWayPoint(i)), 1e-12);
+
+	// single joint with custom weight
+	const moveit::core::JointModel* jm = robot_model->getActiveJointModels().front();
+	lengths = positions.segmentLengths({ { jm, 2.0 } });
+	for (size_t i = 1; i < trajectory->getWayPointCount(); ++i)
+		EXPECT_NEAR(lengths[i - 1], 2.0 * trajectory->getWayPoint(i - 1).distance(trajectory->getWayPoint(i), jm), 1e-12);
+}
+
+TEST_F(TrajectoryMatrixTest, merge) {
+	const auto base_state = randomState();
+	std::vector<robot_trajectory::RobotTrajectoryConstPtr> subs{ randomTrajectory(group, 5),
+		                                                         randomTrajectory(eef_group, 3) };
+	const moveit::core::JointModelGroup* merged_group = nullptr;
+	auto merged = merge(subs, base_state, merged_group, NoTiming());
+
+	ASSERT_EQ(merged->getWayPointCount(), 5u);
+	std::vector<double> expected, actual;
+	for (size_t i = 0; i < merged->getWayPointCount(); ++i) {
+		for (const auto& sub : subs) {
+			// finished sub trajectories hold their last waypoint
+			sub->getWayPoint(std::min(i, sub->getWayPointCount() - 1)).copyJointGroupPositions(sub->getGroup(), expected);
+			merged->getWayPoint(i).copyJointGroupPositions(sub->getGroup(), actual);
+			EXPECT_EQ(actual, expected);
+		}
+	}
+}
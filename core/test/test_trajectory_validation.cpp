@@ -0,0 +1,102 @@
+#include <moveit/task_constructor/trajectory_validation.h>
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace moveit::task_constructor;
+
+TEST(BisectionOrder, permutation) {
+	EXPECT_TRUE(bisectionOrder(0).empty());
+	EXPECT_EQ(bisectionOrder(1), std::vector<std::size_t>({ 0 }));
+	EXPECT_EQ(bisectionOrder(2), std::vector<std::size_t>({ 0, 1 }));
+	EXPECT_EQ(bisectionOrder(9), std::vector<std::size_t>({ 0, 8, 4, 2, 6, 1, 3, 5, 7 }));
+
+	for (std::size_t n : { 3, 10, 17, 100 }) {
+		auto order = bisectionOrder(n);
+		ASSERT_EQ(order.size(), n);
+		EXPECT_EQ(order[0], 0u);
+		EXPECT_EQ(order[1], n - 1);
+		std::sort(order.begin(), order.end());
+		for (std::size_t i = 0; i < n; ++i)
+			EXPECT_EQ(order[i], i);
+	}
+}
+
+// single link rotating about the x-axis, carrying a sphere at distance 0.5
+moveit::core::RobotModelPtr sphereModel() {
+	geometry_msgs::Pose origin;
+	origin.orientation.w = 1.0;
+
+	moveit::core::RobotModelBuilder builder("robot", "base");
+	builder.addChain("base->a", "continuous", { origin });
+	geometry_msgs::Pose sphere = origin;
+	sphere.position.y = 0.5;
+	builder.addCollisionSphere("a", 0.1, sphere);
+	builder.addGroupChain("base", "a", "arm");
+	return builder.build();
+}
+
+struct TrajectoryValidationTest : public testing::TestWithParam<unsigned int>
+{
+	moveit::core::RobotModelPtr robot_model = sphereModel();
+	planning_scene::PlanningScenePtr scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+	const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup("arm");
+
+	void addBall(double angle) {
+		scene->getWorldNonConst()->addToObject(
+		    "ball_" + std::to_string(angle), std::make_shared<shapes::Sphere>(0.1),
+		    Eigen::Isometry3d(Eigen::Translation3d(0.0, 0.5 * std::cos(angle), 0.5 * std::sin(angle))));
+	}
+	robot_trajectory::RobotTrajectory sweep(std::size_t n) {
+		robot_trajectory::RobotTrajectory trajectory(robot_model, jmg);
+		moveit::core::RobotState state(scene->getCurrentState());
+		for (std::size_t i = 0; i < n; ++i) {
+			double angle = 2.0 * M_PI * i / n;
+			state.setJointGroupPositions(jmg, &angle);
+			state.update();
+			trajectory.addSuffixWayPoint(state, 0.1);
+		}
+		return trajectory;
+	}
+};
+
+TEST_P(TrajectoryValidationTest, sameAsPlanningScene) {
+	const auto trajectory = sweep(100);
+	PathValidationOptions options;
+	options.num_threads = GetParam();
+
+	std::vector<std::size_t> expected, actual;
+	EXPECT_TRUE(scene->isPathValid(trajectory, "", false, &expected));
+	EXPECT_TRUE(isPathValid(*scene, trajectory, moveit_msgs::Constraints(), options, &actual));
+	EXPECT_TRUE(actual.empty());
+
+	addBall(M_PI / 3);
+	addBall(1.5 * M_PI);
+	EXPECT_FALSE(scene->isPathValid(trajectory, "", false, &expected));
+	EXPECT_FALSE(isPathValid(*scene, trajectory, moveit_msgs::Constraints(), options, &actual));
+	ASSERT_FALSE(expected.empty());
+	EXPECT_EQ(actual, expected);
+
+	// early exit
+	for (auto order : { PathValidationOptions::SEQUENTIAL, PathValidationOptions::BISECTION }) {
+		options.order = order;
+		EXPECT_FALSE(isPathValid(*scene, trajectory, moveit_msgs::Constraints(), options));
+
+		// only reporting the first invalid waypoint(s) found
+		options.find_all = false;
+		EXPECT_FALSE(isPathValid(*scene, trajectory, moveit_msgs::Constraints(), options, &actual));
+		ASSERT_FALSE(actual.empty());
+		EXPECT_LE(actual.size(), options.num_threads);
+		for (std::size_t index : actual)
+			EXPECT_TRUE(std::find(expected.begin(), expected.end(), index) != expected.end()) << index;
+		options.find_all = true;
+	}
+}
+
+INSTANTIATE_TEST_SUITE_P(Threads, TrajectoryValidationTest, testing::Values(1u, 4u));